@@ -0,0 +1,52 @@
+// FILE: include/core/CarFollowing.h
+#ifndef CAR_FOLLOWING_H
+#define CAR_FOLLOWING_H
+
+#include <vector>
+#include <cstddef>
+
+// How vehicles advance along their paths
+enum class MovementModel {
+    FIXED_SPEED,    // Constant speed, queueing at fixed offsets from the stop line
+    CAR_FOLLOWING   // Intelligent Driver Model reacting to the actual leader
+};
+
+// Kinematic state of one lane in structure-of-arrays form.
+// Slot head + i belongs to the i-th vehicle of the lane queue (0 = front),
+// so every vehicle's leader is the slot right before it.
+struct LaneKinematics {
+    std::vector<float> position;      // Distance travelled along the vehicle path (px)
+    std::vector<float> speed;         // px/s
+    std::vector<float> acceleration;  // px/s^2, from the last step
+    std::vector<float> length;        // Vehicle body length (px)
+    std::vector<float> stopLine;      // Path distance of the vehicle's stop line (px)
+    std::vector<float> displacement;  // Distance moved during the last step (px)
+    size_t head = 0;                  // First live slot (popFront is O(1))
+
+    // Number of vehicles in the lane
+    size_t size() const { return position.size() - head; }
+
+    // Append a vehicle at the back of the lane
+    void pushBack(float startPosition, float stopLinePosition, float bodyLength);
+
+    // Remove the front vehicle
+    void popFront();
+
+    // Remove all vehicles
+    void clear();
+
+private:
+    // Drop consumed slots once they make up half of the arrays
+    void compact();
+};
+
+// Intelligent Driver Model over a whole lane
+class CarFollowingModel {
+public:
+    // Compute every vehicle's acceleration from its leader's gap and speed in one
+    // pass, then integrate speeds and positions over dt seconds. While stopLineActive
+    // is set, vehicles that have not reached their stop line treat it as a stopped leader.
+    static void step(LaneKinematics& lane, float dt, bool stopLineActive);
+};
+
+#endif // CAR_FOLLOWING_H
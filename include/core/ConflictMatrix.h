@@ -0,0 +1,48 @@
+// FILE: include/core/ConflictMatrix.h
+#ifndef CONFLICT_MATRIX_H
+#define CONFLICT_MATRIX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "core/RouteTable.h"
+
+// Set of RouteTable movements, bit i = movement i
+typedef uint16_t MovementMask;
+
+// Which junction movements can be green together. Generated from the paths
+// vehicles actually drive (Vehicle waypoints from the stop line to the exit
+// point): two movements conflict when their paths cross or come closer than
+// JUNCTION_MIN_SEPARATION. Movements sharing an approach lane never conflict,
+// the lane serves them one after another.
+class ConflictMatrix {
+public:
+    // Matrix of the junction geometry (built on first use)
+    static const ConflictMatrix& junction();
+
+    bool conflicts(int first, int second) const;
+
+    // Closest distance between the two paths inside the junction (px)
+    float separation(int first, int second) const { return distance[first][second]; }
+
+    // True when no two movements of the mask conflict
+    bool compatible(MovementMask movements) const;
+
+    // Signal phases over the controlled (L2) movements: one per road, serving
+    // both of its movements, and, with overlaps allowed, every other maximal
+    // compatible set that serves more than one road
+    std::vector<MovementMask> phasePlan(bool allowOverlaps) const;
+
+    // Controlled movements released by a road's green
+    static MovementMask roadMovements(char road);
+
+    // "AL2 left + CL2 left"
+    static std::string describe(MovementMask movements);
+
+private:
+    ConflictMatrix();
+
+    float distance[RouteTable::MOVEMENT_COUNT][RouteTable::MOVEMENT_COUNT];
+};
+
+#endif // CONFLICT_MATRIX_H
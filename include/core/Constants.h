@@ -27,9 +27,54 @@ namespace Constants {
     constexpr float TURN_SPEED = 0.0008f;
     constexpr float MOVE_SPEED = 0.2f;
 
+    // Car-following (Intelligent Driver Model) settings - pixels and seconds
+    constexpr float IDM_DESIRED_SPEED = 18.0f;         // Same cruise speed as the fixed-speed model (0.018 px/ms)
+    constexpr float IDM_MAX_ACCELERATION = 15.0f;
+    constexpr float IDM_COMFORT_DECELERATION = 25.0f;
+    constexpr float IDM_MAX_DECELERATION = 90.0f;      // Hard braking limit
+    constexpr float IDM_TIME_HEADWAY = 1.0f;
+    constexpr float IDM_MIN_GAP = VEHICLE_GAP;         // Bumper-to-bumper gap when stopped
+    constexpr float IDM_VEHICLE_LENGTH = 26.0f;        // Rendered body length
+    constexpr float STOP_SPEED_THRESHOLD = 1.0f;       // px/s; slower than this counts as standing
+    constexpr int STOP_MIN_DURATION = 1000;            // ms standing before the halt counts as a stop
+
+    // Junction conflict detection settings
+    constexpr float INTERSECTION_HALF_SIZE = 70.0f; // Half-width of the junction box
+    constexpr float JUNCTION_GRID_MARGIN = 50.0f;   // Area tracked beyond the box (covers stop lines)
+    constexpr float JUNCTION_CELL_SIZE = 30.0f;     // Spatial hash cell size
+    constexpr float JUNCTION_CLEARANCE = 40.0f;     // Entry must be clear within this radius
+    constexpr float JUNCTION_MIN_SEPARATION = 16.0f; // Closer than this counts as an overlap
+
+    // Simulation loop settings
+    constexpr uint32_t SIM_STEP_MS = 16;          // Fixed model step; time warp runs more of them per frame
+    constexpr uint32_t MAX_FRAME_DELTA_MS = 250;  // Longer stalls (dragging the window, breakpoints) are not caught up
+    constexpr float TIME_WARP_UNLIMITED = 0.0f;   // Warp factor meaning "as many steps as fit in a frame"
+    constexpr float TIME_WARP_MAX_FACTOR = 1000.0f;
+    constexpr uint32_t SIMULATION_REVISION = 1;   // Bump whenever vehicle or controller behaviour changes (keys cached runs)
+
     // Traffic light settings
     constexpr int ALL_RED_DURATION = 2000; // 2 seconds
     constexpr int GREEN_DURATION_BASE = 3000;   // 3 seconds
+    constexpr int GREEN_DURATION_MAX = 15000;   // 15 seconds
+    constexpr int GREEN_TIME_PER_VEHICLE = 2000; // Green time per average queued vehicle
+    constexpr int PRIORITY_GREEN_DURATION = 6000; // Green phase length in priority mode
+    constexpr int FIXED_GREEN_DURATION = 8000;    // Green phase length of the fixed-time controller
+    constexpr int ACTUATED_GAP_DURATION = 6000;   // Actuated green ends after this long without a departure (discharge past the junction hold is slow)
+    constexpr int RATE_PREDICTION_HORIZON = 5000; // Queue-average controller plans with the lane counts expected this far ahead
+    constexpr int RATE_TIME_CONSTANT = 30000;     // Averaging time of the lane arrival/departure rates
+    constexpr int WEBSTER_UPDATE_INTERVAL = 60000;   // Webster controller re-plans the cycle this often
+    constexpr int WEBSTER_MAX_CYCLE = 120000;        // Longest cycle Webster's formula may ask for
+    constexpr int WEBSTER_STARTUP_LOST_TIME = 2000;  // Start of a green not yet discharging at saturation flow
+    constexpr int WEBSTER_MIN_SATURATED_TIME = 10000; // Saturated green needed before a flow measurement counts
+    constexpr float WEBSTER_QUEUE_REACH = 2.0f * (IDM_VEHICLE_LENGTH + IDM_MIN_GAP); // Next vehicle this close to the stop line = saturated discharge
+    constexpr float WEBSTER_DEFAULT_SATURATION_FLOW = 0.2f; // veh/s per L2 lane until measured (discharge past the junction hold)
+    constexpr float WEBSTER_MAX_FLOW_RATIO = 0.9f;   // Critical flow ratio sum is capped here (oversaturated)
+    constexpr int CORRIDOR_GREEN_LEAD = 2000;        // Downstream green starts this long before the platoon arrives
+    constexpr int CORRIDOR_OFFSET_TOLERANCE = 1000;  // Re-coordinate once a link's measured travel time drifts this far
+    constexpr float CORRIDOR_TRAVEL_SMOOTHING = 0.25f; // Weight of a new travel time sample in the link average
+    constexpr int QLEARNING_DECISION_INTERVAL = 2000; // Q-learning controller decides this often once minGreen is over
+    constexpr float QLEARNING_LEARNING_RATE = 0.1f;
+    constexpr float QLEARNING_DISCOUNT = 0.9f;        // Per decision interval
 
     // Queue settings
     constexpr int MAX_QUEUE_SIZE = 100;
@@ -42,6 +87,23 @@ namespace Constants {
     const std::string DATA_PATH = "data/lanes";
     const std::string LOG_FILE = "traffic_simulator.log";
 
+    // Simulation snapshot settings
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x534A5454;      // "TTJS" in little-endian byte order
+    constexpr uint32_t SNAPSHOT_VERSION = 8;             // Bump whenever the layout changes
+    constexpr uint32_t SNAPSHOT_MAX_LANE_VEHICLES = 100000; // Sanity limit when reading
+
+    // Metrics endpoint
+    constexpr uint32_t METRICS_PUBLISH_INTERVAL = 250;   // Simulated ms between metrics snapshots
+    constexpr uint16_t METRICS_DEFAULT_PORT = 9464;
+
+    // Trace event recording (TraceRecorder)
+    const std::string TRACE_DEFAULT_PATH = "simulator_trace.json";
+    constexpr uint64_t TRACE_DEFAULT_LIMIT_MB = 64;   // Trace files stop growing at this size
+
+    // Q-learning table files
+    constexpr uint32_t QTABLE_MAGIC = 0x4C515454;        // "TTQL" in little-endian byte order
+    constexpr uint32_t QTABLE_VERSION = 1;
+
     // Colors
     constexpr SDL_Color ROAD_COLOR = {50, 50, 50, 255};
     constexpr SDL_Color LANE_MARKER_COLOR = {255, 255, 255, 255};
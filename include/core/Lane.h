@@ -4,11 +4,18 @@
 
 #include <vector>
 #include <string>
+#include <istream>
+#include <ostream>
 #include "core/Vehicle.h"
+#include "core/CarFollowing.h"
+#include "core/TrafficCounters.h"
 #include "utils/Queue.h"
 
 class Lane {
 public:
+    // Vehicles in queue order (the lane queue's storage)
+    using VehicleList = Queue<Vehicle*>::Container;
+
     Lane(char laneId, int laneNumber);
     ~Lane();
 
@@ -24,20 +31,52 @@ public:
     void updatePriority();
     bool isPriorityLane() const;
 
+    // Vehicle counts that switch priority on (above high) and off (below low)
+    void setPriorityThresholds(int high, int low);
+
+    // Delete all vehicles and drop back to normal priority
+    void clear();
+
+    // Counters updated on every enqueue and dequeue (may be null)
+    void setCounters(TrafficCounters* counters);
+
     // Lane identification
     char getLaneId() const;
     int getLaneNumber() const;
     std::string getName() const;
 
     // For iteration through vehicles (for rendering)
-    const std::vector<Vehicle*>& getVehicles() const;
+    const VehicleList& getVehicles() const;
+
+    // Advance all vehicles with the car-following model; vehicles that have not
+    // reached the stop line stop there unless canEnter is set
+    void updateCarFollowing(uint32_t delta, bool canEnter);
+
+    // Kinematic state (parallel to getVehicles())
+    const LaneKinematics& getKinematics() const;
+
+    // Write priority, vehicles and their kinematic state to a snapshot stream
+    void saveState(std::ostream& out) const;
+
+    // Replace the lane contents with a saved state; returns false on invalid data
+    bool loadState(std::istream& in);
 
 private:
     char laneId;               // A, B, C, or D
     int laneNumber;            // 1, 2, or 3
     bool isPriority;           // Is this a priority lane (AL2)
     int priority;              // Current priority (higher means served first)
+    int priorityThresholdHigh; // Priority on above this many vehicles
+    int priorityThresholdLow;  // Priority off below this many vehicles
     Queue<Vehicle*> vehicleQueue; // Queue for vehicles in the lane
+    LaneKinematics kinematics;    // Car-following state, same order as vehicleQueue
+    TrafficCounters* counters;    // Shared flow counters, owned by the manager
+
+    // RouteTable movement of a vehicle in this lane
+    int movementOf(const Vehicle* vehicle) const;
+
+    // Leading vehicles already past the stop line
+    size_t crossedPrefix() const;
 };
 
 #endif // LANE_H
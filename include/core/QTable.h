@@ -0,0 +1,64 @@
+// FILE: include/core/QTable.h
+#ifndef Q_TABLE_H
+#define Q_TABLE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Action values of the Q-learning signal controller, one row per discretized
+// junction state. Every entry is a lock-free atomic, so any number of
+// simulations can learn into one table at the same time: an update is a
+// compare-and-swap on a single value, and a reader may see a row half way
+// through concurrent updates, which tabular Q-learning tolerates.
+class QTable {
+public:
+    // Queue level of each road's controlled lane, whether the green is past
+    // half of maxGreen, and which road is green (see QLearningController)
+    static const int QUEUE_LEVELS = 4;
+    static const int GREEN_LEVELS = 2;
+    static const int STATE_COUNT = 4 * GREEN_LEVELS * QUEUE_LEVELS * QUEUE_LEVELS * QUEUE_LEVELS * QUEUE_LEVELS;
+
+    // Extend the green, switch to the next road, preempt for the longest queue
+    static const int ACTION_COUNT = 3;
+
+    QTable();
+
+    float value(int state, int action) const;
+
+    // Best action of a state, or -1 while the state has never been updated
+    int bestAction(int state) const;
+
+    // Highest action value of a state (0 for an unvisited state)
+    float maxValue(int state) const;
+
+    // Move Q(state, action) towards target by learningRate (lock-free)
+    void update(int state, int action, float target, float learningRate);
+
+    // Updates made to a state so far
+    uint32_t visits(int state) const;
+
+    // States updated at least once
+    int visitedStates() const;
+
+    // Forget everything
+    void clear();
+
+    // Binary table file (magic, version, sizes, then values and visit counts);
+    // load fails on a file written for a different state or action layout
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Table used by the Q-learning controllers of this process (empty until
+    // loaded or trained)
+    static QTable& policy();
+
+private:
+    std::atomic<float> values[STATE_COUNT * ACTION_COUNT];
+    std::atomic<uint32_t> stateVisits[STATE_COUNT];
+
+    QTable(const QTable&) = delete;
+    QTable& operator=(const QTable&) = delete;
+};
+
+#endif // Q_TABLE_H
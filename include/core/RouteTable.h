@@ -0,0 +1,53 @@
+// FILE: include/core/RouteTable.h
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include "core/Vehicle.h"
+
+// One movement through the junction: an approach lane, the turn taken and the
+// road whose outgoing lane (L1) the vehicle ends up on
+struct Movement {
+    char fromRoad;
+    int fromLane;
+    Destination turn;
+    char toRoad;
+};
+
+// Movement mapping of the junction (the same routes Vehicle follows, e.g.
+// AL2 straight -> CL1). Every approach has three movements: L2 straight,
+// L2 left and the free L3 left turn.
+namespace RouteTable {
+
+    constexpr int MOVEMENT_COUNT = 12;
+    constexpr int MOVEMENTS_PER_ROAD = 3;
+
+    // Indexed road * 3 + {0: L2 straight, 1: L2 left, 2: L3 left}
+    constexpr Movement MOVEMENTS[MOVEMENT_COUNT] = {
+        {'A', 2, Destination::STRAIGHT, 'C'}, {'A', 2, Destination::LEFT, 'D'}, {'A', 3, Destination::LEFT, 'B'},
+        {'B', 2, Destination::STRAIGHT, 'D'}, {'B', 2, Destination::LEFT, 'A'}, {'B', 3, Destination::LEFT, 'C'},
+        {'C', 2, Destination::STRAIGHT, 'A'}, {'C', 2, Destination::LEFT, 'B'}, {'C', 3, Destination::LEFT, 'D'},
+        {'D', 2, Destination::STRAIGHT, 'B'}, {'D', 2, Destination::LEFT, 'C'}, {'D', 3, Destination::LEFT, 'A'}
+    };
+
+    // Index into MOVEMENTS, or -1 for lanes vehicles do not start on (L1)
+    inline int movementIndex(char road, int laneNumber, Destination turn) {
+        if (road < 'A' || road > 'D') {
+            return -1;
+        }
+
+        const int base = (road - 'A') * MOVEMENTS_PER_ROAD;
+        if (laneNumber == 3) {
+            return base + 2;   // Free lane always turns left
+        }
+        if (laneNumber == 2) {
+            return base + (turn == Destination::STRAIGHT ? 0 : 1);
+        }
+        return -1;
+    }
+
+    inline const Movement& movement(int index) {
+        return MOVEMENTS[index];
+    }
+}
+
+#endif // ROUTE_TABLE_H
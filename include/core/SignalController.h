@@ -0,0 +1,309 @@
+// FILE: include/core/SignalController.h
+#ifndef SIGNAL_CONTROLLER_H
+#define SIGNAL_CONTROLLER_H
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include <string>
+#include <istream>
+#include <ostream>
+#include "core/Lane.h"
+#include "core/TrafficLight.h"
+#include "core/SignalTiming.h"
+#include "core/TrafficCounters.h"
+#include "core/TrafficRates.h"
+
+// Available signal policies (selected at startup)
+enum class SignalControllerType {
+    FIXED_TIME,     // A -> B -> C -> D with a constant green
+    QUEUE_AVERAGE,  // Green length from the average queue, A2 priority override
+    ACTUATED,       // Min/max green with gap-out, skips roads without demand
+    MAX_PRESSURE,   // Serves the road with the highest movement pressure
+    PHASED,         // Demand-skipping rotation over the conflict-matrix phase plan
+    PHASED_SINGLE,  // The same rotation restricted to one road at a time
+    WEBSTER,        // Cycle length and splits from measured flows (Webster's formula)
+    COORDINATED,    // Fixed cycle on the clock, shifted by timing.cycleOffset (corridors)
+    QLEARNING       // Tabular Q-learning policy (QTable::policy, trained by signal_train)
+};
+
+// Name used on the command line and in reports ("fixed", "queue", "actuated",
+// "pressure", "phased", "phased-single", "webster", "coordinated", "qlearning")
+const char* signalControllerName(SignalControllerType type);
+
+// Parse a name from signalControllerName; returns false for unknown names
+bool parseSignalControllerType(const std::string& name, SignalControllerType& type);
+
+// What a controller sees when the light asks for a decision
+struct SignalContext {
+    const std::vector<Lane*>& lanes;
+    const TrafficCounters& counters;   // O(1) lane and road aggregates
+    const TrafficRates& rates;         // Lane arrival/departure rates
+    uint32_t currentTime;              // Simulation time (ms)
+    uint32_t elapsed;                  // ms since the current state began
+    TrafficLight::State current;
+    TrafficLight::State lastGreen;     // Most recent road green (D_GREEN before the first one)
+    MovementMask greenMovements;       // Movements the current state releases
+    const SignalTiming& timing;
+};
+
+// Decides which road gets green. TrafficLight owns the state machine and the
+// all-red clearance: it only asks the controller once the clearance is over,
+// and a request for a different green while one is showing goes through
+// ALL_RED first. Returning the current state keeps it; returning ALL_RED from
+// ALL_RED rests the junction in red.
+class SignalController {
+public:
+    virtual ~SignalController() {}
+
+    virtual SignalControllerType getType() const = 0;
+
+    // Requested state for this tick
+    virtual TrafficLight::State selectState(const SignalContext& context) = 0;
+
+    // Movements to release when selectState requested TrafficLight::State::PHASE
+    virtual MovementMask phaseMovements() const { return 0; }
+
+    // True while the controller is serving the priority lane (drawn by the light)
+    virtual bool isPriorityActive() const { return false; }
+
+    // Forget any run state
+    virtual void reset() {}
+
+    // Controller-specific state for snapshots
+    virtual void saveState(std::ostream& out) const { (void)out; }
+    virtual bool loadState(std::istream& in) { (void)in; return true; }
+
+    // New controller of the given type (caller owns it)
+    static SignalController* create(SignalControllerType type);
+
+protected:
+    // Vehicles of a road's controlled lane (L2) that have not crossed the stop line
+    static int queuedVehicles(const TrafficCounters& counters, char road);
+
+    static char roadOf(TrafficLight::State state);
+    static TrafficLight::State greenFor(char road);
+
+    // Fixed rotation A -> B -> C -> D -> A
+    static TrafficLight::State nextInRotation(TrafficLight::State state);
+};
+
+// Every road in turn for timing.fixedGreen, regardless of demand
+class FixedTimeController : public SignalController {
+public:
+    SignalControllerType getType() const override { return SignalControllerType::FIXED_TIME; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+};
+
+// The original policy: fixed rotation with green = |V| * greenPerVehicle, where
+// |V| is the average L2 queue, plus the A2 priority override between the
+// priority thresholds. Lane counts are predicted timing.predictionHorizon
+// ahead from the arrival and departure rates, so a growing lane gets a longer
+// green, and priority mode starts, before its queue gets there.
+class QueueAverageController : public SignalController {
+public:
+    QueueAverageController();
+
+    SignalControllerType getType() const override { return SignalControllerType::QUEUE_AVERAGE; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+    bool isPriorityActive() const override { return priorityMode; }
+    void reset() override;
+    void saveState(std::ostream& out) const override;
+    bool loadState(std::istream& in) override;
+
+private:
+    bool priorityMode;
+    uint32_t lastPriorityLogTime;
+
+    // Enter or leave priority mode from the A2 count
+    void updatePriorityMode(const SignalContext& context);
+
+    // Vehicle count of a lane expected timing.predictionHorizon from now
+    static float predictedCount(const SignalContext& context, char road, int laneNumber);
+
+    // Average predicted vehicle count of the L2 lanes, at least 1
+    float calculateAverageVehicleCount(const SignalContext& context) const;
+};
+
+// Vehicle-actuated control: a green runs for at least minGreen, then ends when
+// no vehicle has crossed the stop line for actuatedGap (gap-out) or at maxGreen
+// (max-out), but only if another road is waiting. Roads without queued
+// vehicles are skipped and the junction rests in red when nobody waits.
+class ActuatedController : public SignalController {
+public:
+    ActuatedController();
+
+    SignalControllerType getType() const override { return SignalControllerType::ACTUATED; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+    void reset() override;
+    void saveState(std::ostream& out) const override;
+    bool loadState(std::istream& in) override;
+
+private:
+    uint32_t phaseStartTime;       // Start of the green being tracked
+    uint32_t lastDepartureTime;
+    uint32_t lastCrossings;        // Served lane's stop-line crossings at the last departure
+
+    // First road after `after` in rotation order with queued vehicles (ALL_RED if none)
+    TrafficLight::State nextWithDemand(const TrafficCounters& counters, TrafficLight::State after) const;
+};
+
+// Max-pressure control. The pressure of a phase is the sum over the movements
+// it serves (RouteTable, e.g. AL2 straight -> CL1) of the upstream queue minus
+// the vehicles already heading into the destination road. After minGreen the
+// light switches to the phase with strictly higher pressure than the served
+// one; a green never runs past maxGreen while another road is waiting. Queues
+// come from the incremental counters, so a decision costs O(phases).
+class MaxPressureController : public SignalController {
+public:
+    MaxPressureController();
+
+    SignalControllerType getType() const override { return SignalControllerType::MAX_PRESSURE; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+
+private:
+    // Movements released by each road's green (the L2 movements), indexed by road
+    std::vector<int> phaseMovements[4];
+
+    int pressure(const TrafficCounters& counters, char road) const;
+};
+
+// Phase-plan control. Phases are movement sets from ConflictMatrix: the four
+// road greens plus, unless restricted to single roads, the cross-road sets
+// whose paths do not conflict (e.g. opposing left turns). Phases are served
+// in plan order, skipping those that cannot release the first waiting vehicle
+// of each road they touch, each for greenPerVehicle per vehicle of its longest
+// movement queue (between minGreen and maxGreen), ending early once none of
+// its lanes can move.
+class PhasedController : public SignalController {
+public:
+    explicit PhasedController(bool allowOverlaps);
+
+    SignalControllerType getType() const override;
+    TrafficLight::State selectState(const SignalContext& context) override;
+    MovementMask phaseMovements() const override;
+    void reset() override;
+    void saveState(std::ostream& out) const override;
+    bool loadState(std::istream& in) override;
+
+private:
+    bool allowOverlaps;
+    std::vector<MovementMask> plan;
+    int currentPhase;              // Plan index of the phase last started, -1 before the first
+    int requestedPhase;            // Phase of the latest request (read back by phaseMovements)
+
+    // Longest queue among the phase's movements
+    static int longestQueue(const TrafficCounters& counters, MovementMask movements);
+
+    // Roads of the phase whose first waiting L2 vehicle it releases; `roads`
+    // receives the number of roads the phase touches
+    static int servedRoads(const std::vector<Lane*>& lanes, MovementMask movements, int& roads);
+
+    // First phase after `after` in plan order that every road it touches can
+    // use (-1 if none)
+    int nextWithDemand(const std::vector<Lane*>& lanes, int after) const;
+
+    // Light state showing a plan phase (a road green when it is one)
+    TrafficLight::State stateFor(int phase) const;
+};
+
+// Webster's fixed-cycle plan, re-derived from measurements. Every
+// timing.websterInterval the controller takes each road's arrival flow q
+// (TrafficRates) and saturation flow s (stop-line crossings per second of
+// green while a vehicle stood at the stop line, after the start-up lost time) and
+// computes, with y = q / s, Y = sum(y) and lost time L = 4 * (allRed +
+// start-up), the cycle C = (1.5 L + 5 s) / (1 - Y) and greens
+// (C - L) * y / Y. A new plan only takes over at the next cycle start (A's
+// green); until the first plan every road gets timing.fixedGreen.
+class WebsterController : public SignalController {
+public:
+    WebsterController();
+
+    SignalControllerType getType() const override { return SignalControllerType::WEBSTER; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+    void reset() override;
+    void saveState(std::ostream& out) const override;
+    bool loadState(std::istream& in) override;
+
+private:
+    int32_t activeGreen[4];        // Greens of the running cycle (0 = timing.fixedGreen)
+    int32_t pendingGreen[4];       // Plan waiting for the next cycle start
+    bool planPending;
+    float saturationFlow[4];       // Measured discharge rate (veh/s)
+    uint32_t saturatedTime[4];     // Measurement window: saturated green time (ms)...
+    uint32_t saturatedCrossings[4]; // ...and the crossings during it
+    char measuredRoad;             // Road measured on the last tick (' ' in red)
+    uint32_t lastCrossings;
+    uint32_t lastTickTime;
+    uint32_t lastPlanTime;
+
+    // Accumulate the served road's saturated discharge
+    void measure(const SignalContext& context);
+
+    // True when the road's next L2 vehicle is already at the stop line, so the
+    // lane discharges at saturation flow rather than waiting for arrivals
+    static bool queueAtStopLine(const std::vector<Lane*>& lanes, char road);
+
+    // Derive the next plan from the flows measured since the last one
+    void computePlan(const SignalContext& context);
+};
+
+// Fixed-time plan driven by the simulation clock instead of the last state
+// change: the cycle of 4 * (fixedGreen + allRed) starts with A's green at
+// timing.cycleOffset, then B, C and D, each green followed by its all-red.
+// Junctions sharing the clock keep a fixed phase relationship, which is what
+// corridor coordination adjusts through the offsets.
+class CoordinatedController : public SignalController {
+public:
+    SignalControllerType getType() const override { return SignalControllerType::COORDINATED; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+
+    // Cycle length of a timing
+    static uint32_t cycleLength(const SignalTiming& timing);
+};
+
+// Tabular Q-learning over QTable::policy(). The state is the queue level of
+// every road's controlled lane (0, 1-2, 3-5, 6+ vehicles), whether the green
+// has run past half of maxGreen, and the road that is green. Once minGreen is
+// over the controller picks an action every QLEARNING_DECISION_INTERVAL:
+// extend the green, switch to the next road in rotation, or preempt the
+// rotation for the road with the longest queue. A green never runs past
+// maxGreen, and the light adds the all-red between greens as for any other
+// controller. The reward of a decision is the vehicles that crossed the
+// controlled stop lines until the next one, so serving empty roads and
+// needless all-reds cost throughput. Read-only by default; while learning, actions are
+// epsilon-greedy and every decision updates the table. States the table has
+// never seen fall back to fixed-time behaviour.
+class QLearningController : public SignalController {
+public:
+    enum Action { EXTEND, SWITCH, PREEMPT };
+
+    QLearningController();
+
+    SignalControllerType getType() const override { return SignalControllerType::QLEARNING; }
+    TrafficLight::State selectState(const SignalContext& context) override;
+    void reset() override;
+    void saveState(std::ostream& out) const override;
+    bool loadState(std::istream& in) override;
+
+    // Learn into the table, exploring with probability epsilon
+    void setLearning(bool enabled, float epsilon, uint32_t seed);
+
+    // Table state index of a context (see QTable)
+    static int encodeState(const SignalContext& context);
+
+private:
+    bool learning;
+    float epsilon;
+    std::mt19937 explorer;
+    int32_t lastState;             // State of the last decision (-1 before the first)
+    int32_t lastAction;
+    uint32_t lastDecisionTime;
+    uint32_t decisionCrossings;    // L2 stop-line crossings at the last decision
+    TrafficLight::State target;    // Green requested by the last decision
+
+    // Light state an action leads to
+    TrafficLight::State apply(int action, const SignalContext& context) const;
+};
+
+#endif // SIGNAL_CONTROLLER_H
@@ -0,0 +1,38 @@
+// FILE: include/core/SignalTiming.h
+#ifndef SIGNAL_TIMING_H
+#define SIGNAL_TIMING_H
+
+#include <ostream>
+#include <string>
+#include "core/Constants.h"
+
+// Tunable signal policy parameters (all durations in ms of simulation time).
+// Defaults are the values from Constants.h.
+struct SignalTiming {
+    int priorityThresholdHigh = Constants::PRIORITY_THRESHOLD_HIGH; // Enter priority mode above this A2 count
+    int priorityThresholdLow = Constants::PRIORITY_THRESHOLD_LOW;   // Leave priority mode below this A2 count
+    int minGreen = Constants::GREEN_DURATION_BASE;
+    int maxGreen = Constants::GREEN_DURATION_MAX;
+    int greenPerVehicle = Constants::GREEN_TIME_PER_VEHICLE;
+    int allRed = Constants::ALL_RED_DURATION;
+    int priorityGreen = Constants::PRIORITY_GREEN_DURATION;
+    int fixedGreen = Constants::FIXED_GREEN_DURATION;     // Fixed-time controller only
+    int actuatedGap = Constants::ACTUATED_GAP_DURATION;   // Actuated controller only
+    int predictionHorizon = Constants::RATE_PREDICTION_HORIZON; // Queue-average controller only
+    int websterInterval = Constants::WEBSTER_UPDATE_INTERVAL;   // Webster controller only
+    int maxCycle = Constants::WEBSTER_MAX_CYCLE;                // Webster controller only
+    int cycleOffset = 0;           // Coordinated controller only: cycle start (A's green) within the cycle
+};
+
+// Timing files hold one "key value" pair per line ('#' starts a comment), with
+// the keys priority_high, priority_low, min_green, max_green, green_per_vehicle,
+// all_red, priority_green, fixed_green, actuated_gap, prediction_horizon,
+// webster_interval, max_cycle and cycle_offset. Keys missing from the file
+// keep their current value in timing.
+bool loadSignalTiming(const std::string& path, SignalTiming& timing);
+bool saveSignalTiming(const std::string& path, const SignalTiming& timing);
+
+// Every field as "key value" lines, in the timing file format
+void writeSignalTiming(std::ostream& out, const SignalTiming& timing);
+
+#endif // SIGNAL_TIMING_H
@@ -0,0 +1,159 @@
+// FILE: include/core/TrafficCounters.h
+#ifndef TRAFFIC_COUNTERS_H
+#define TRAFFIC_COUNTERS_H
+
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include "core/RouteTable.h"
+
+// Flow counters of one lane or one whole road. Each block fills a cache line,
+// so lanes updated from different threads never share one.
+struct alignas(64) FlowCounters {
+    uint32_t arrivals = 0;     // Vehicles that joined since the last reset
+    uint32_t crossings = 0;    // Vehicles that crossed the stop line
+    uint32_t departures = 0;   // Vehicles that left the simulation
+    int32_t occupancy = 0;     // Vehicles in the lane now
+    int32_t queued = 0;        // Of those, not yet past the stop line
+    int32_t emergencies = 0;        // Emergency vehicles in the lane now
+    int32_t emergenciesQueued = 0;  // Of those, not yet past the stop line
+};
+
+static_assert(sizeof(FlowCounters) == 64, "FlowCounters should fill exactly one cache line");
+
+// Vehicles per movement of RouteTable, split at the stop line: queued upstream
+// of it, or past it and heading for the destination road's outgoing lane
+struct alignas(64) MovementCounters {
+    int32_t queued[RouteTable::MOVEMENT_COUNT] = {};
+    int32_t exiting[4] = {};   // Indexed by destination road A-D
+};
+
+static_assert(sizeof(MovementCounters) == 64, "MovementCounters should fill exactly one cache line");
+
+// Per-lane, per-road and per-movement counters, maintained incrementally as
+// vehicles join, cross the stop line and leave, so signal controllers read
+// O(1) aggregates instead of walking the lanes. movement is a RouteTable
+// index (-1 when the lane has no movement); emergency marks emergency vehicles,
+// which are counted separately as well.
+class TrafficCounters {
+public:
+    static constexpr int ROAD_COUNT = 4;       // A-D
+    static constexpr int LANES_PER_ROAD = 3;   // 1-3
+
+    // Zero everything
+    void reset() {
+        *this = TrafficCounters();
+    }
+
+    // A vehicle joined the lane
+    void vehicleArrived(char road, int laneNumber, int movement, bool emergency) {
+        if (!valid(road, laneNumber)) return;
+        for (FlowCounters* c : {&lanes[roadIndex(road)][laneNumber - 1], &roads[roadIndex(road)]}) {
+            c->arrivals++;
+        }
+        adjust(road, laneNumber, movement, emergency, true, 1);
+    }
+
+    // A vehicle crossed the stop line
+    void vehicleCrossed(char road, int laneNumber, int movement, bool emergency) {
+        if (!valid(road, laneNumber)) return;
+        for (FlowCounters* c : {&lanes[roadIndex(road)][laneNumber - 1], &roads[roadIndex(road)]}) {
+            c->crossings++;
+            c->queued--;
+            c->emergenciesQueued -= emergency ? 1 : 0;
+        }
+        if (hasMovement(movement)) {
+            movements.queued[movement]--;
+            movements.exiting[roadIndex(RouteTable::movement(movement).toRoad)]++;
+        }
+    }
+
+    // A vehicle left the simulation (wasQueued: its crossing was never recorded)
+    void vehicleDeparted(char road, int laneNumber, int movement, bool emergency, bool wasQueued) {
+        if (!valid(road, laneNumber)) return;
+        for (FlowCounters* c : {&lanes[roadIndex(road)][laneNumber - 1], &roads[roadIndex(road)]}) {
+            c->departures++;
+        }
+        adjust(road, laneNumber, movement, emergency, wasQueued, -1);
+    }
+
+    // A vehicle was deleted or loaded without flowing through the lane
+    // (clearing and restoring lanes); the flow totals stay unchanged
+    void vehicleRemoved(char road, int laneNumber, int movement, bool emergency, bool wasQueued) {
+        if (!valid(road, laneNumber)) return;
+        adjust(road, laneNumber, movement, emergency, wasQueued, -1);
+    }
+
+    void vehicleRestored(char road, int laneNumber, int movement, bool emergency, bool queued) {
+        if (!valid(road, laneNumber)) return;
+        adjust(road, laneNumber, movement, emergency, queued, 1);
+    }
+
+    const FlowCounters& lane(char road, int laneNumber) const {
+        return valid(road, laneNumber) ? lanes[roadIndex(road)][laneNumber - 1] : empty();
+    }
+
+    const FlowCounters& road(char road) const {
+        return valid(road, 1) ? roads[roadIndex(road)] : empty();
+    }
+
+    // Vehicles of a movement waiting upstream of the stop line
+    int movementQueue(int movement) const {
+        return hasMovement(movement) ? movements.queued[movement] : 0;
+    }
+
+    // Vehicles past the stop line heading for a road's outgoing lane
+    int exitOccupancy(char road) const {
+        return valid(road, 1) ? movements.exiting[roadIndex(road)] : 0;
+    }
+
+private:
+    FlowCounters lanes[ROAD_COUNT][LANES_PER_ROAD];
+    FlowCounters roads[ROAD_COUNT];
+    MovementCounters movements;
+
+    // Add delta to the occupancy of a vehicle's lane and road, and to either the
+    // queued (upstream) or the exiting (downstream) side of its movement
+    void adjust(char road, int laneNumber, int movement, bool emergency, bool upstream, int delta) {
+        for (FlowCounters* c : {&lanes[roadIndex(road)][laneNumber - 1], &roads[roadIndex(road)]}) {
+            c->occupancy += delta;
+            c->queued += upstream ? delta : 0;
+            if (emergency) {
+                c->emergencies += delta;
+                c->emergenciesQueued += upstream ? delta : 0;
+            }
+        }
+        if (hasMovement(movement)) {
+            if (upstream) {
+                movements.queued[movement] += delta;
+            } else {
+                movements.exiting[roadIndex(RouteTable::movement(movement).toRoad)] += delta;
+            }
+        }
+    }
+
+    static bool hasMovement(int movement) {
+        return movement >= 0 && movement < RouteTable::MOVEMENT_COUNT;
+    }
+
+    static int roadIndex(char road) { return road - 'A'; }
+
+    static bool valid(char road, int laneNumber) {
+        return road >= 'A' && road < 'A' + ROAD_COUNT && laneNumber >= 1 && laneNumber <= LANES_PER_ROAD;
+    }
+
+    static const FlowCounters& empty() {
+        static const FlowCounters none;
+        return none;
+    }
+};
+
+// Counters as of the end of a simulation step, published for other threads
+struct CounterSnapshot {
+    uint32_t simTime = 0;
+    TrafficCounters counters;
+};
+
+static_assert(std::is_trivially_copyable<CounterSnapshot>::value, "CounterSnapshot is published by copy");
+
+#endif // TRAFFIC_COUNTERS_H
@@ -5,8 +5,16 @@
 #include <cstdint>
 #include <vector>
 #include <string>
+#include <istream>
+#include <ostream>
 #include <SDL3/SDL.h>
 #include "core/Lane.h"
+#include "core/SignalTiming.h"
+#include "core/TrafficCounters.h"
+#include "core/TrafficRates.h"
+#include "core/ConflictMatrix.h"
+
+class SignalController;
 
 class TrafficLight {
 public:
@@ -15,14 +23,18 @@ public:
         A_GREEN = 1,
         B_GREEN = 2,
         C_GREEN = 3,
-        D_GREEN = 4
+        D_GREEN = 4,
+        PHASE = 5       // Movement set of a phase plan (getGreenMovements), may span roads
     };
 
     TrafficLight();
     ~TrafficLight();
 
-    // Updates the traffic light state based on lane priorities
-    void update(const std::vector<Lane*>& lanes);
+    // Advances the light: enforces the all-red clearance, preempts for waiting
+    // emergency vehicles and otherwise applies the controller's decision
+    // (currentTime is simulation time in ms)
+    void update(const std::vector<Lane*>& lanes, const TrafficCounters& counters, const TrafficRates& rates,
+                uint32_t currentTime);
 
     // Renders the traffic lights
     void render(SDL_Renderer* renderer);
@@ -33,30 +45,68 @@ public:
     // Returns the next traffic light state
     State getNextState() const { return nextState; }
 
-    // Sets the next traffic light state
-    void setNextState(State state);
-
     // Checks if the specific lane gets green light
     bool isGreen(char lane) const;
 
+    // Controlled (L2) movements that may enter the junction now
+    MovementMask getGreenMovements() const { return greenMovements; }
+    bool isMovementGreen(int movement) const { return movement >= 0 && (greenMovements & (1u << movement)); }
+
+    // Replace the timing parameters (thresholds and phase durations)
+    void setTiming(const SignalTiming& timing);
+    const SignalTiming& getTiming() const { return timing; }
+
+    // Replace the signal policy (takes ownership; the light starts with QueueAverageController)
+    void setController(SignalController* controller);
+    SignalController* getController() const { return controller; }
+
+    // Whether the controller is serving the priority lane (priority mode)
+    bool isPriorityActive() const;
+
+    // Road whose green is forced for an emergency vehicle, ' ' when not preempted
+    char getPreemptedRoad() const { return preemptRoad; }
+
+    // Back to the initial state (all red, A next, clock at 0)
+    void reset();
+
+    // Write the light and controller state and timers to a snapshot stream
+    void saveState(std::ostream& out) const;
+
+    // Restore the light and controller state and timers (switching to the saved
+    // controller type if needed); returns false on invalid data
+    bool loadState(std::istream& in);
+
 private:
     State currentState;
     State nextState;
 
     // Timing for the green and red states
-    const int allRedDuration = 2000; // 2 seconds for all red
+    SignalTiming timing;
 
     // Last state change time in milliseconds
     uint32_t lastStateChangeTime;
 
-    // Priority mode flags
-    bool isPriorityMode;
-    bool shouldResumeNormalMode;
-    bool forceAGreen;
-    uint32_t priorityModeStartTime;
+    // Most recent road green (A_GREEN..D_GREEN), where the rotation continues from
+    State lastGreenState;
+
+    // Movements released by the current state (empty in ALL_RED)
+    MovementMask greenMovements;
+
+    // Signal policy deciding the green phases
+    SignalController* controller;
+
+    // Emergency preemption: the road being served and where the normal
+    // rotation resumes (lastGreenState to restore) once it is over
+    char preemptRoad;
+    State resumeLastGreen;
+
+    // Serve waiting emergency vehicles on the controlled lanes (L2) ahead of the
+    // controller; returns true while preemption decides the state
+    bool updatePreemption(const TrafficCounters& counters, uint32_t currentTime);
 
-    // Helper function to calculate average vehicle count
-    float calculateAverageVehicleCount(const std::vector<Lane*>& lanes);
+    // Switch state (with the movements a PHASE releases), going through
+    // ALL_RED when leaving a green
+    void changeState(State requested, MovementMask movements, uint32_t currentTime);
 
     // Helper drawing functions
     void drawLightForA(SDL_Renderer* renderer, bool isRed);
@@ -0,0 +1,113 @@
+// FILE: include/core/TrafficRates.h
+#ifndef TRAFFIC_RATES_H
+#define TRAFFIC_RATES_H
+
+#include <cstdint>
+#include <cmath>
+#include <initializer_list>
+#include <istream>
+#include <ostream>
+#include "core/Constants.h"
+#include "utils/BinaryIO.h"
+
+// Exponentially weighted event rate in continuous time: every event adds
+// 1/tau and the rate decays by exp(-dt/tau) in between, so recording and
+// reading are O(1) and uneven event spacing needs no sampling clock.
+struct RateEstimator {
+    double rate = 0.0;          // Events per ms as of lastEventTime
+    uint32_t lastEventTime = 0;
+
+    void record(uint32_t now, double timeConstantMs) {
+        rate = rateAt(now, timeConstantMs) + 1.0 / timeConstantMs;
+        lastEventTime = now;
+    }
+
+    // Events per second at time now
+    double perSecond(uint32_t now, double timeConstantMs) const {
+        return rateAt(now, timeConstantMs) * 1000.0;
+    }
+
+private:
+    double rateAt(uint32_t now, double timeConstantMs) const {
+        if (rate == 0.0 || now <= lastEventTime) {
+            return rate;
+        }
+        return rate * std::exp(-static_cast<double>(now - lastEventTime) / timeConstantMs);
+    }
+};
+
+// Arrival and departure rate of every lane, fed by TrafficManager when a
+// vehicle joins a lane and when it leaves the simulation
+class TrafficRates {
+public:
+    static constexpr int ROAD_COUNT = 4;       // A-D
+    static constexpr int LANES_PER_ROAD = 3;   // 1-3
+
+    void reset() {
+        *this = TrafficRates();
+    }
+
+    void vehicleArrived(char road, int laneNumber, uint32_t now) {
+        if (valid(road, laneNumber)) {
+            arrivals[road - 'A'][laneNumber - 1].record(now, TIME_CONSTANT);
+        }
+    }
+
+    void vehicleExited(char road, int laneNumber, uint32_t now) {
+        if (valid(road, laneNumber)) {
+            departures[road - 'A'][laneNumber - 1].record(now, TIME_CONSTANT);
+        }
+    }
+
+    // Vehicles per second
+    double arrivalRate(char road, int laneNumber, uint32_t now) const {
+        return valid(road, laneNumber) ? arrivals[road - 'A'][laneNumber - 1].perSecond(now, TIME_CONSTANT) : 0.0;
+    }
+
+    double departureRate(char road, int laneNumber, uint32_t now) const {
+        return valid(road, laneNumber) ? departures[road - 'A'][laneNumber - 1].perSecond(now, TIME_CONSTANT) : 0.0;
+    }
+
+    // Expected change of the lane's vehicle count over the next horizonMs,
+    // never negative (a lane is not predicted to empty faster than it is seen to)
+    double predictedGrowth(char road, int laneNumber, uint32_t now, int horizonMs) const {
+        double net = arrivalRate(road, laneNumber, now) - departureRate(road, laneNumber, now);
+        return net > 0.0 ? net * horizonMs / 1000.0 : 0.0;
+    }
+
+    void saveState(std::ostream& out) const {
+        for (const auto* estimators : {&arrivals, &departures}) {
+            for (const auto& road : *estimators) {
+                for (const auto& lane : road) {
+                    BinaryIO::write(out, lane.rate);
+                    BinaryIO::write(out, lane.lastEventTime);
+                }
+            }
+        }
+    }
+
+    bool loadState(std::istream& in) {
+        for (auto* estimators : {&arrivals, &departures}) {
+            for (auto& road : *estimators) {
+                for (auto& lane : road) {
+                    if (!BinaryIO::read(in, lane.rate) || !BinaryIO::read(in, lane.lastEventTime)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr double TIME_CONSTANT = Constants::RATE_TIME_CONSTANT;
+
+    RateEstimator arrivals[ROAD_COUNT][LANES_PER_ROAD];
+    RateEstimator departures[ROAD_COUNT][LANES_PER_ROAD];
+
+    static bool valid(char road, int laneNumber) {
+        return road >= 'A' && road < 'A' + ROAD_COUNT && laneNumber >= 1 && laneNumber <= LANES_PER_ROAD;
+    }
+};
+
+#endif // TRAFFIC_RATES_H
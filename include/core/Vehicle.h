@@ -4,10 +4,13 @@
 
 #include <string>
 #include <SDL3/SDL.h>
-#include <ctime>
+#include <cstdint>
 #include <vector>
 #include <sstream>
+#include <istream>
+#include <ostream>
 #include "utils/DebugLogger.h"
+#include "utils/MemoryAccounting.h"
 
 // Define all enums here instead of just forward declaring them
 enum class Destination {
@@ -38,9 +41,24 @@ struct Point {
 
 class Vehicle {
 public:
+    // Waypoint path; its storage is accounted to MemoryTag::WAYPOINTS
+    using WaypointList = std::vector<Point, TrackingAllocator<Point, MemoryTag::WAYPOINTS>>;
+
     Vehicle(const std::string& id, char lane, int laneNumber, bool isEmergency = false);
     ~Vehicle();
 
+    // Vehicle objects are accounted to MemoryTag::VEHICLES
+    static void* operator new(size_t size) {
+        void* memory = ::operator new(size);
+        MemoryAccounting::allocated(MemoryTag::VEHICLES, size);
+        return memory;
+    }
+
+    static void operator delete(void* memory, size_t size) {
+        MemoryAccounting::released(MemoryTag::VEHICLES, size);
+        ::operator delete(memory);
+    }
+
     // Getters and setters
     std::string getId() const;
     char getLane() const;
@@ -48,7 +66,37 @@ public:
     int getLaneNumber() const;
     void setLaneNumber(int number);
     bool isEmergencyVehicle() const;
-    time_t getArrivalTime() const;
+
+    // Lifecycle timestamps. Generation and ingestion are wall-clock Unix time
+    // in ms, because the generator is another process; the later stages are
+    // simulation ms. Generation is 0 when the lane file line carried no
+    // "@epoch_ms" stamp.
+    int64_t getGeneratedTime() const { return generatedTime; }
+    void setGeneratedTime(int64_t epochMs) { generatedTime = epochMs; }
+    int64_t getIngestedTime() const { return ingestedTime; }
+
+    // Simulation time (ms) at which the vehicle joined its lane queue
+    uint32_t getQueueEntryTime() const { return queueEntryTime; }
+    void setQueueEntryTime(uint32_t time) { queueEntryTime = time; }
+
+    // Simulation time (ms) its lane first showed green after it joined
+    bool hasSeenGreen() const { return seenGreen; }
+    uint32_t getFirstGreenTime() const { return firstGreenTime; }
+    void markGreen(uint32_t time);
+
+    // Simulation time (ms) at which the vehicle crossed its stop line and entered the junction
+    uint32_t getStopLineTime() const { return stopLineTime; }
+    void setStopLineTime(uint32_t time) { stopLineTime = time; }
+
+    // Simulation time (ms) at which the vehicle left the simulation
+    uint32_t getExitTime() const { return exitTime; }
+    void setExitTime(uint32_t time) { exitTime = time; }
+
+    // Current wall-clock time as Unix epoch ms (the clock of the generation and ingestion stamps)
+    static int64_t wallClockMs();
+
+    // Times the vehicle came to a halt before its stop line
+    int getStops() const { return stops; }
 
     // Destination control
     void setDestination(Destination dest);
@@ -69,6 +117,15 @@ public:
     // Update vehicle position
     void update(uint32_t delta, bool isGreenLight, float targetPos);
 
+    // Move an exact distance along the waypoint path (car-following model)
+    void advanceAlongPath(float distance, uint32_t delta);
+
+    // Distance already travelled along the waypoint path
+    float getPathDistance() const;
+
+    // Path distance from the spawn point to the stop line
+    float getStopLineDistance() const;
+
     // Render vehicle
     void render(SDL_Renderer* renderer, SDL_Texture* vehicleTexture, int queuePos);
 
@@ -82,12 +139,42 @@ public:
     // Check if vehicle has exited the screen
     bool hasExited() const { return state == VehicleState::EXITED; }
 
+    // Check if vehicle has reached its stop line (it is committed to the junction)
+    bool hasPassedStopLine() const { return currentWaypoint >= 1; }
+
+    // Stop line position (the approach waypoint)
+    Point getStopLinePoint() const;
+
+    // Path the vehicle follows: spawn point, stop line, junction points, exit, off screen
+    const WaypointList& getWaypoints() const { return waypoints; }
+
+    // Current movement state
+    VehicleState getState() const { return state; }
+
+    // Write the full vehicle state to a snapshot stream
+    void saveState(std::ostream& out) const;
+
+    // Create a vehicle from a snapshot stream (nullptr if the data is invalid)
+    static Vehicle* loadState(std::istream& in);
+
 private:
     std::string id;
     char lane;
     int laneNumber;
     bool isEmergency;
-    time_t arrivalTime;
+    int64_t generatedTime;
+    int64_t ingestedTime;
+    uint32_t queueEntryTime;
+    bool seenGreen;
+    uint32_t firstGreenTime;
+    uint32_t stopLineTime;
+    uint32_t exitTime;
+
+    // Stop detection: time spent below STOP_SPEED_THRESHOLD so far and
+    // whether that halt was already counted
+    int stops;
+    uint32_t haltedTime;
+    bool halted;
 
     // Animation properties
     float animPos;
@@ -107,12 +194,19 @@ private:
     VehicleState state;
 
     // Waypoints for movement
-    std::vector<Point> waypoints;
+    WaypointList waypoints;
     size_t currentWaypoint;
 
     // Helper methods
     float easeInOutQuad(float t) const;
 
+    // Turn, exit and lane hand-over bookkeeping after arriving at a waypoint
+    void onWaypointReached();
+
+    // Count a stop once the vehicle has stood still for STOP_MIN_DURATION
+    // on its approach (both movement models report the distance moved)
+    void trackStops(float distance, uint32_t delta);
+
     // Helper for drawing triangles (SDL3 compatible)
     void SDL_RenderFillTriangleF(SDL_Renderer* renderer, float x1, float y1, float x2, float y2, float x3, float y3);
 };
@@ -0,0 +1,43 @@
+// FILE: include/managers/ArrivalGenerator.h
+#ifndef ARRIVAL_GENERATOR_H
+#define ARRIVAL_GENERATOR_H
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+// In-process version of traffic_generator: produces vehicle lines in the lane
+// file format ("V12_L2_STRAIGHT:A") on the simulation clock, so headless runs
+// need no files and are reproducible from the RNG seed.
+class ArrivalGenerator {
+public:
+    // meanIntervalMs: average time between two arrivals
+    // initialPriorityVehicles: A2 vehicles emitted first (the generator's start-up burst)
+    explicit ArrivalGenerator(float meanIntervalMs = 2000.0f, int initialPriorityVehicles = 0);
+
+    // Advance by delta ms and append the lines of all vehicles that arrived
+    void update(uint32_t delta, std::mt19937& rng, std::vector<std::string>& lines);
+
+    // Fraction of vehicles after the start-up burst that are emergency vehicles
+    // (id suffix "_E"); 0 by default, which leaves the random sequence unchanged
+    void setEmergencyShare(float share) { emergencyShare = share; }
+
+    // Start over (vehicle ids restart at V1)
+    void reset();
+
+    // Number of vehicles emitted so far
+    int getGeneratedCount() const { return generatedCount; }
+
+private:
+    float meanIntervalMs;
+    int initialPriorityVehicles;
+    int generatedCount;
+    float emergencyShare;
+    float untilNextArrival;   // ms until the next vehicle, < 0 before the first draw
+
+    // Build the line for one vehicle, same lane and direction mix as traffic_generator
+    std::string nextVehicle(std::mt19937& rng);
+};
+
+#endif // ARRIVAL_GENERATOR_H
@@ -0,0 +1,31 @@
+// FILE: include/managers/ArrivalTrace.h
+#ifndef ARRIVAL_TRACE_H
+#define ARRIVAL_TRACE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One vehicle of a recorded trace: arrival time and its line in the lane file format
+struct Arrival {
+    uint32_t timeMs;
+    std::string line;
+};
+
+// Recorded arrival traces, so several headless runs (controllers, timing
+// candidates) see exactly the same vehicles. On disk a trace is one
+// "time_ms vehicle_line" per line in time order; '#' lines are comments.
+namespace ArrivalTrace {
+
+    // Arrivals of an ArrivalGenerator stepped on the simulation clock, as a headless run would
+    std::vector<Arrival> generate(float meanIntervalMs, int initialPriorityVehicles,
+                                  uint32_t durationMs, uint32_t stepMs, uint32_t seed,
+                                  float emergencyShare = 0.0f);
+
+    // Read a trace; errors go to stderr with the offending line
+    bool load(const std::string& path, std::vector<Arrival>& trace);
+
+    bool save(const std::string& path, const std::vector<Arrival>& trace);
+}
+
+#endif // ARRIVAL_TRACE_H
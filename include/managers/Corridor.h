@@ -0,0 +1,117 @@
+// FILE: include/managers/Corridor.h
+#ifndef CORRIDOR_H
+#define CORRIDOR_H
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "managers/TrafficManager.h"
+
+// A line of junctions joined west to east. A vehicle leaving junction i on
+// road B drives the link and, linkTravelTime later, joins the D approach of
+// junction i + 1 (westbound the other way round). Each link carries on
+// straight with probability throughShare, otherwise it turns left there.
+//
+// With coordination on, the junctions run the coordinated controller with
+// offsets chosen so an eastbound platoon released by one junction's D green
+// reaches the next junction as its D green starts: offset(i + 1) = offset(i)
+// + travel time of link i - CORRIDOR_GREEN_LEAD. Link travel times (stop line
+// to stop line) start from the free-flow estimate and are then measured from
+// eastbound vehicles that got through the downstream junction without
+// stopping; once a link's average drifts by CORRIDOR_OFFSET_TOLERANCE only
+// the offsets downstream of it are recomputed.
+class Corridor {
+public:
+    Corridor(int junctionCount, uint32_t linkTravelTime, float throughShare, uint32_t seed);
+    ~Corridor();
+
+    // Create and start the junctions (no file input); false if one fails
+    bool initialize(SignalControllerType controller, const SignalTiming& timing, MovementModel model);
+
+    // Offset coordination (off: every junction keeps the timing's offset)
+    void setCoordination(bool enabled);
+
+    // Link travel time of vehicles entering a link from now on
+    void setLinkTravelTime(uint32_t travelTime);
+
+    // Advance every junction by delta ms and move vehicles along the links
+    void update(uint32_t delta);
+
+    // Add an arrival (a vehicle line) at a junction
+    bool injectVehicle(int junction, const std::string& line);
+
+    int getJunctionCount() const { return static_cast<int>(junctions.size()); }
+    TrafficManager* getJunction(int index) const { return junctions[index]; }
+
+    // Offset applied at a junction and travel time assumed for a link (ms)
+    int getOffset(int junction) const { return offsets[junction]; }
+    uint32_t getLinkEstimate(int link) const { return linkEstimates[link]; }
+
+    // Times a drifting link travel time re-coordinated the corridor
+    int getOffsetUpdates() const { return offsetUpdates; }
+
+    // Mean stops per vehicle over every stop line of every junction
+    double getMeanStops() const;
+
+    // Mean stops of eastbound vehicles arriving from the previous junction
+    // (per junction passed) and how many such passages there were
+    double getThroughMeanStops() const;
+    uint32_t getThroughPassages() const { return throughPassages; }
+
+    // Vehicles that left the corridor
+    uint32_t getVehiclesExited() const { return vehiclesExited; }
+
+private:
+    // A vehicle on a link
+    struct Transfer {
+        int junction;            // Junction it enters
+        std::string line;        // Vehicle line for injectVehicle
+        uint32_t upstreamCrossing;
+        bool eastbound;
+    };
+
+    // Where a transferred vehicle came from (by its new id)
+    struct Origin {
+        int link;
+        uint32_t upstreamCrossing;
+        bool eastbound;
+    };
+
+    std::vector<TrafficManager*> junctions;
+    std::multimap<uint32_t, Transfer> inTransit;   // By arrival time at the next junction
+    std::map<std::string, Origin> origins;
+
+    uint32_t linkTravelTime;
+    float throughShare;
+    std::mt19937 rng;
+
+    SignalTiming timing;
+    bool coordination;
+    std::vector<int> offsets;
+    std::vector<uint32_t> linkEstimates;           // Travel time used for the offsets
+    std::vector<double> measuredTravel;            // Smoothed samples (0 = none yet)
+    int offsetUpdates;
+
+    uint32_t throughStops;
+    uint32_t throughPassages;
+    uint32_t vehiclesExited;
+
+    std::vector<VehicleExit> exits;                // Scratch buffer
+
+    // Free-flow stop line to stop line time over a link
+    uint32_t freeFlowTravelTime() const;
+
+    // Recompute offsets from junction `from` on and push them to the junctions
+    void applyOffsets(int from);
+
+    // Hand a vehicle leaving junction `junction` to the neighbour it drives to
+    void transfer(int junction, const VehicleExit& exit, uint32_t now);
+
+    // Travel time and stop bookkeeping of a vehicle leaving a junction
+    void recordExit(int junction, const VehicleExit& exit);
+};
+
+#endif // CORRIDOR_H
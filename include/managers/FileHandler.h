@@ -6,6 +6,7 @@
 #include <vector>
 #include <mutex>
 #include "core/Vehicle.h"
+#include "utils/InstrumentedMutex.h"
 
 class FileHandler {
 public:
@@ -24,9 +25,12 @@ public:
     // Create directories and empty files if they don't exist
     bool initializeFiles();
 
+    // Parse a vehicle line in the lane file format (nullptr if invalid)
+    Vehicle* parseVehicleLine(const std::string& line);
+
 private:
     std::string dataPath;
-    std::mutex mutex;
+    InstrumentedMutex mutex{"file_handler"};
 
     // Lane file paths
     std::string getLaneFilePath(char laneId) const;
@@ -34,9 +38,6 @@ private:
     // Read vehicles from a specific lane file
     std::vector<Vehicle*> readVehiclesFromFile(char laneId);
 
-    // Parse a vehicle line from the file
-    Vehicle* parseVehicleLine(const std::string& line);
-
     // Get the lane status file path
     std::string getLaneStatusFilePath() const;
 };
@@ -0,0 +1,50 @@
+// FILE: include/managers/MetricsExporter.h
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "managers/TrafficManager.h"
+
+// Minimal HTTP listener on 127.0.0.1 serving GET /metrics in the Prometheus
+// text exposition format. It runs on its own thread and only ever reads the
+// manager's published MetricsSnapshot (a sequence lock), so a scrape never
+// blocks or slows the simulation thread. One connection is served at a time.
+class MetricsExporter {
+public:
+    // The manager must outlive the exporter
+    explicit MetricsExporter(TrafficManager& manager);
+    ~MetricsExporter();
+
+    // Listen on localhost:port, turn on the manager's metrics publishing and
+    // start the serving thread (call from the simulation thread)
+    bool start(uint16_t port);
+
+    // Stop serving and join the thread
+    void stop();
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+    // Prometheus text for a snapshot
+    static std::string format(const MetricsSnapshot& snapshot);
+
+private:
+    TrafficManager& manager;
+    std::thread thread;
+    std::atomic<bool> running;
+    intptr_t listenSocket;   // Platform socket handle, -1 when closed
+
+    // Accept and answer connections until stop()
+    void serve();
+
+    // Read one request and write the response
+    void respond(intptr_t client);
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+};
+
+#endif // METRICS_EXPORTER_H
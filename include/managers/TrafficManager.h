@@ -7,12 +7,63 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <random>
 #include <SDL3/SDL.h>
 
 #include "core/Lane.h"
 #include "core/TrafficLight.h"
+#include "core/SignalTiming.h"
+#include "core/SignalController.h"
+#include "core/TrafficCounters.h"
+#include "core/TrafficRates.h"
 #include "managers/FileHandler.h"
 #include "utils/PriorityQueue.h"
+#include "utils/SpatialHash.h"
+#include "utils/SeqLock.h"
+#include "utils/LatencyHistogram.h"
+#include "utils/MemoryAccounting.h"
+#include "utils/TimeSeries.h"
+
+// A vehicle leaving the simulation (see TrafficManager::setExitRecording)
+struct VehicleExit {
+    std::string id;
+    char fromRoad;
+    int fromLane;
+    char toRoad;              // Road whose outgoing lane it left on
+    bool emergency;
+    uint32_t stopLineTime;    // When it crossed the stop line (ms)
+    int stops;                // Stops on the approach
+};
+
+// Count, sum and quantiles of a LatencyHistogram
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint32_t p50 = 0;
+    uint32_t p95 = 0;
+    uint32_t p99 = 0;
+    uint32_t max = 0;
+};
+
+// What the metrics endpoint reports, published for other threads every
+// Constants::METRICS_PUBLISH_INTERVAL of simulated time while enabled
+// (see TrafficManager::setMetricsPublishing)
+struct MetricsSnapshot {
+    static const int LIGHT_STATE_COUNT = 6;   // TrafficLight::State values
+
+    uint32_t simTime = 0;
+    TrafficCounters counters;
+    uint32_t vehiclesActive = 0;
+    uint32_t vehiclesExited = 0;
+    int32_t lightState = 0;                            // TrafficLight::State
+    uint64_t lightStateTime[LIGHT_STATE_COUNT] = {};   // ms spent in each state
+    LatencySummary wait;                               // Queue waits, all lanes (ms)
+    LatencySummary ingestLag;                          // Ingest lag, all lanes (wall ms)
+    LatencySummary frameTime;                          // Render frames (us)
+    MemoryAccounting::TagStats memory[MemoryAccounting::TAG_COUNT];   // Heap use per MemoryTag
+};
+
+static_assert(std::is_trivially_copyable<MetricsSnapshot>::value, "MetricsSnapshot is published by copy");
 
 class TrafficManager {
 public:
@@ -31,6 +82,24 @@ public:
     // Update the traffic state
     void update(uint32_t delta);
 
+    // Remove all vehicles and return to time 0 so the instance can be reused for
+    // another run (lanes, light and settings are kept)
+    void reset();
+
+    // Read new vehicles from the lane files (on by default; headless runs inject instead)
+    void setFileInputEnabled(bool enabled);
+
+    // Add a vehicle from a line in the lane file format, e.g. "V1_L2_LEFT:A"
+    bool injectVehicle(const std::string& line);
+
+    // Signal policy parameters, applied to the light and the lanes
+    void setSignalTiming(const SignalTiming& timing);
+    const SignalTiming& getSignalTiming() const;
+
+    // Signal policy of the light (queue average by default)
+    void setSignalController(SignalControllerType type);
+    SignalControllerType getSignalController() const;
+
     // Get the lanes for rendering
     const std::vector<Lane*>& getLanes() const;
 
@@ -49,6 +118,89 @@ public:
     // Find lane by ID and number
     Lane* findLane(char laneId, int laneNumber) const;
 
+    // Select how vehicles move (fixed speed by default)
+    void setMovementModel(MovementModel model);
+    MovementModel getMovementModel() const;
+
+    // Simulation clock in ms (sum of all update deltas, restored from snapshots)
+    uint32_t getSimulationTime() const;
+
+    // Seed the simulation random engine
+    void setSeed(uint32_t seed);
+
+    // Random engine shared by everything that needs randomness in the simulation
+    std::mt19937& getRandomEngine();
+
+    // Run statistics since the last reset
+    uint32_t getVehiclesExited() const;
+    uint32_t getPriorityModeTime() const;   // ms the controller spent in priority mode
+
+    // Queue wait (ms from joining the lane to crossing the stop line) of every
+    // vehicle of a lane that crossed it; laneIndex follows getLanes()
+    const std::vector<uint32_t>& getLaneWaitTimes(size_t laneIndex) const;
+
+    // The same queue waits as a histogram, and each lane's ingest lag (ms
+    // from the generator writing a vehicle to the simulator reading it, for
+    // stamped lane file lines only)
+    const LatencyHistogram& getLaneWaitHistogram(size_t laneIndex) const;
+    const LatencyHistogram& getLaneIngestLagHistogram(size_t laneIndex) const;
+
+    // Per-lane p50/p95/p99 of the wait and ingest lag histograms (printed on exit)
+    std::string getLatencyReport() const;
+
+    // Emergency clearance latency: ms from an emergency vehicle joining a
+    // controlled lane (L2) to crossing its stop line, one entry per vehicle
+    const std::vector<uint32_t>& getEmergencyClearanceTimes() const;
+
+    // Stops on the approach of the vehicles that crossed a stop line: the
+    // total, the number of vehicles and the mean per vehicle
+    uint32_t getStopTotal() const { return stopTotal; }
+    uint32_t getStopsCounted() const { return stoppedVehicleCount; }
+    double getMeanStops() const;
+
+    // Clear the run statistics
+    void resetStatistics();
+
+    // Keep a record of every vehicle leaving the simulation (off by default)
+    void setExitRecording(bool enabled);
+
+    // Move the exits recorded since the last call into `exits` (replacing its contents)
+    void takeExits(std::vector<VehicleExit>& exits);
+
+    // Live lane/road counters (simulation thread only)
+    const TrafficCounters& getCounters() const;
+
+    // Counters as of the end of the last update; safe to call from any thread
+    CounterSnapshot getCounterSnapshot() const;
+
+    // Publish a MetricsSnapshot for other threads (off by default)
+    void setMetricsPublishing(bool enabled);
+
+    // Metrics as of the last publication; safe to call from any thread
+    MetricsSnapshot getMetricsSnapshot() const;
+
+    // Wall time the renderer took for one frame, for the metrics (simulation thread only)
+    void recordFrameTime(uint32_t microseconds);
+
+    // Sample per-lane queue length, arrivals and departures and the light
+    // state into an open recorder (columns from seriesColumns()) at the first
+    // update at or after each multiple of intervalMs of simulated time, or
+    // every update when it is 0. The recorder must outlive the manager or be
+    // detached with nullptr.
+    void setSeriesRecorder(TimeSeriesRecorder* recorder, uint32_t intervalMs);
+
+    // Column names of the recorded time series
+    static std::vector<std::string> seriesColumns();
+
+    // Lane arrival and departure rates (simulation thread only)
+    const TrafficRates& getRates() const;
+
+    // Write lanes, vehicles, light controller, timers and RNG state to a binary snapshot
+    bool saveSnapshot(const std::string& path) const;
+
+    // Replace the current state with a snapshot written by saveSnapshot (call after initialize)
+    bool loadSnapshot(const std::string& path);
+
 private:
     // Lanes for each road
     std::vector<Lane*> lanes;
@@ -62,18 +214,96 @@ private:
     // File handler for reading vehicle data
     FileHandler* fileHandler;
 
-    // Flag to indicate if the manager is running
-    std::atomic<bool> running;
+    // Simulation clock (ms)
+    uint32_t simTime;
 
-    // Time tracking for periodic operations
+    // Time tracking for periodic operations (simulation time)
     uint32_t lastFileCheckTime;
     uint32_t lastPriorityUpdateTime;
+    uint32_t lastDebugTime;
+    uint32_t lastStatusTime;
+
+    // Simulation random engine
+    std::mt19937 rng;
+
+    // Flag to indicate if the manager is running
+    std::atomic<bool> running;
+
+    // Vehicle inside the junction area, tagged with the lane that owns it
+    struct JunctionOccupant {
+        Vehicle* vehicle;
+        const Lane* lane;
+    };
+
+    // Spatial hash over the junction area, rebuilt every tick
+    SpatialHash<JunctionOccupant> junctionGrid;
+
+    // Per-lane flag (same order as lanes): entry held because crossing traffic occupies it
+    std::vector<char> laneEntryBlocked;
+
+    // How vehicles advance each tick
+    MovementModel movementModel;
+
+    // Signal policy and its parameters
+    SignalControllerType controllerType;
+    SignalTiming signalTiming;
+
+    // Whether update() polls the lane files
+    bool fileInputEnabled;
+
+    // Run statistics
+    uint32_t vehiclesExited;
+    uint32_t priorityModeTime;
+    std::vector<std::vector<uint32_t>> laneWaitTimes;  // Per lane, same order as lanes
+    std::vector<LatencyHistogram> laneWaitHistograms;  // Per lane: the same waits
+    std::vector<LatencyHistogram> laneIngestLag;       // Per lane: generation to ingestion (wall ms)
+    LatencyHistogram allWaits;                         // All lanes' waits and ingest lag together
+    LatencyHistogram allIngestLag;
+    LatencyHistogram frameTimes;                       // Render frame wall times (us)
+    std::vector<size_t> laneDeparted;                  // Per lane: leading vehicles already past the stop line
+    std::vector<uint32_t> emergencyClearanceTimes;
+    uint32_t stopTotal;                                // Stops of the vehicles that crossed a stop line...
+    uint32_t stoppedVehicleCount;                      // ...and how many vehicles that is
+    uint64_t lightStateTime[MetricsSnapshot::LIGHT_STATE_COUNT];  // ms spent in each light state
+
+    // Exit records for a caller chaining junctions together
+    bool exitRecording;
+    std::vector<VehicleExit> recordedExits;
+
+    // Lane and road counters, and their copy published after every update
+    TrafficCounters counters;
+    SeqLock<CounterSnapshot> publishedCounters;
+
+    // Metrics published for the metrics endpoint
+    bool metricsPublishing;
+    uint32_t lastMetricsTime;
+    SeqLock<MetricsSnapshot> publishedMetrics;
+
+    // Time-series sampling (see setSeriesRecorder)
+    TimeSeriesRecorder* seriesRecorder;
+    uint32_t seriesInterval;
+    uint32_t lastSeriesTime;
+
+    // Lane arrival rates (on joining a lane) and departure rates (on leaving the simulation)
+    TrafficRates rates;
+
+    // Cross-lane overlap tracking
+    int junctionOverlaps;
+    int totalJunctionOverlaps;
 
     // Read vehicles from files
     void readVehicles();
 
   void limitVehiclesPerLane();
-  void preventVehicleOverlap();
+
+    // Rebuild the junction spatial hash from current vehicle positions
+    void rebuildJunctionGrid();
+
+    // Hold lanes whose junction entry is occupied and count cross-lane overlaps
+    void preventVehicleOverlap();
+
+    // Check whether the next vehicle of a lane can enter the junction
+    bool isJunctionEntryClear(const Lane* lane) const;
 
     // Update lane priorities
     void updatePriorities();
@@ -86,6 +316,21 @@ private:
 
     // Check for vehicles leaving the simulation
     void checkVehicleBoundaries();
+
+    // Record the queue wait of vehicles that crossed their stop line this tick
+    void recordDepartures();
+
+    // Recount vehicles already past the stop line (after a restore)
+    void recountDepartures();
+
+    // Copy the counters to the lock-free snapshot
+    void publishCounters();
+
+    // Build and publish the metrics snapshot
+    void publishMetrics();
+
+    // Append one time-series row to seriesRecorder
+    void recordSeries();
 };
 
 #endif // TRAFFIC_MANAGER_H
@@ -0,0 +1,86 @@
+// FILE: include/utils/BinaryIO.h
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include <cstdint>
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// Helpers for the binary snapshot format. Values are stored in native byte
+// order, so a snapshot only restores on a machine with the same endianness.
+namespace BinaryIO {
+
+    // Write a trivially copyable value
+    template<typename T>
+    void write(std::ostream& out, const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "BinaryIO::write needs a trivially copyable type");
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Read a trivially copyable value; returns false on a short read
+    template<typename T>
+    bool read(std::istream& in, T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "BinaryIO::read needs a trivially copyable type");
+        static_assert(!std::is_same<T, bool>::value, "Read bools with BinaryIO::readBool");
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return static_cast<bool>(in);
+    }
+
+    // Enums are stored as one byte
+    template<typename E>
+    void writeEnum(std::ostream& out, E value) {
+        write(out, static_cast<uint8_t>(value));
+    }
+
+    // Fails on a value past last, the highest valid enumerator
+    template<typename E>
+    bool readEnum(std::istream& in, E& value, E last) {
+        uint8_t raw = 0;
+        if (!read(in, raw) || raw > static_cast<uint8_t>(last)) {
+            return false;
+        }
+        value = static_cast<E>(raw);
+        return true;
+    }
+
+    // Bools are written as one byte; anything but 0 or 1 is damaged data
+    inline bool readBool(std::istream& in, bool& value) {
+        uint8_t raw = 0;
+        if (!read(in, raw) || raw > 1) {
+            return false;
+        }
+        value = raw != 0;
+        return true;
+    }
+
+    // Length-prefixed string
+    inline void writeString(std::ostream& out, const std::string& value) {
+        write(out, static_cast<uint32_t>(value.size()));
+        out.write(value.data(), static_cast<std::streamsize>(value.size()));
+    }
+
+    inline bool readString(std::istream& in, std::string& value, uint32_t maxLength = 1 << 20) {
+        uint32_t length = 0;
+        if (!read(in, length) || length > maxLength) {
+            return false;
+        }
+        value.resize(length);
+        in.read(&value[0], length);
+        return static_cast<bool>(in);
+    }
+
+    // FNV-1a hash, used to detect truncated or corrupted snapshots
+    inline uint64_t checksum(const char* data, size_t size) {
+        uint64_t hash = 1469598103934665603ULL;
+        for (size_t i = 0; i < size; i++) {
+            hash ^= static_cast<unsigned char>(data[i]);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+}
+
+#endif // BINARY_IO_H
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include "utils/InstrumentedMutex.h"
+#include "utils/MemoryAccounting.h"
 
 class DebugLogger {
 public:
@@ -30,11 +33,19 @@ public:
     // Shutdown the logger
     static void shutdown();
 
+    // Turn logging on or off (headless batch runs switch it off)
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
 private:
+    // Recent messages; the ring and the message text are accounted to MemoryTag::LOG_BUFFER
+    using LogRing = std::vector<std::string, TrackingAllocator<std::string, MemoryTag::LOG_BUFFER>>;
+
     static std::string logFilePath;
-    static std::vector<std::string> recentLogs;
-    static std::mutex logMutex;
+    static LogRing recentLogs;
+    static InstrumentedMutex logMutex;
     static bool initialized;
+    static std::atomic<bool> enabled;
 
     // Get timestamp for log messages
     static std::string getTimestamp();
@@ -0,0 +1,116 @@
+// FILE: include/utils/InstrumentedMutex.h
+#ifndef INSTRUMENTED_MUTEX_H
+#define INSTRUMENTED_MUTEX_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef ENABLE_LOCK_STATS
+#include "utils/Profiler.h"
+#endif
+
+// Process-wide contention counters per lock name. Every InstrumentedMutex
+// with the same name (all lane queues, say) adds to the same counters.
+// Counters are relaxed atomics on their own cache lines.
+class LockStats {
+public:
+    static const int MAX_LOCKS = 32;
+
+    struct Counters {
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};     // Acquisitions that had to wait
+        std::atomic<uint64_t> waitTicks{0};     // Profiler::ticks() spent waiting
+    };
+
+    struct LockInfo {
+        std::string name;
+        uint64_t acquisitions = 0;
+        uint64_t contended = 0;
+        double waitMs = 0.0;
+    };
+
+    // Counters of a name, registered on first use. Names beyond MAX_LOCKS
+    // share the last slot, reported as "other".
+    static Counters* counters(const char* name);
+
+    // Every registered lock, in registration order
+    static std::vector<LockInfo> getAll();
+
+    // One line per lock with its counts and wait time, for the logs
+    static std::string getReport();
+};
+
+#ifdef ENABLE_LOCK_STATS
+
+// std::mutex that counts its acquisitions under a name, and times the ones
+// that find it held. Usable with std::lock_guard and std::unique_lock. Like
+// std::mutex it is constant-initialized, so statics can lock it from other
+// translation units' initializers; the counters are looked up on first use.
+class InstrumentedMutex {
+public:
+    constexpr explicit InstrumentedMutex(const char* name) : name(name) {}
+
+    void lock() {
+        LockStats::Counters* counters = stats();
+        if (!mutex.try_lock()) {
+            const uint64_t start = Profiler::ticks();
+            mutex.lock();
+            counters->contended.fetch_add(1, std::memory_order_relaxed);
+            counters->waitTicks.fetch_add(Profiler::ticks() - start, std::memory_order_relaxed);
+        }
+        counters->acquisitions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) {
+            return false;
+        }
+        stats()->acquisitions.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void unlock() { mutex.unlock(); }
+
+private:
+    std::mutex mutex;
+    const char* name;
+    std::atomic<LockStats::Counters*> registered{nullptr};
+
+    // Registration is idempotent, so threads racing on the first lock agree
+    LockStats::Counters* stats() {
+        LockStats::Counters* found = registered.load(std::memory_order_acquire);
+        if (!found) {
+            found = LockStats::counters(name);
+            registered.store(found, std::memory_order_release);
+        }
+        return found;
+    }
+
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+};
+
+#else
+
+// Without ENABLE_LOCK_STATS (CMake option) a plain std::mutex; the name is dropped
+class InstrumentedMutex {
+public:
+    constexpr explicit InstrumentedMutex(const char*) {}
+
+    void lock() { mutex.lock(); }
+    bool try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+
+private:
+    std::mutex mutex;
+
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+};
+
+#endif
+
+#endif // INSTRUMENTED_MUTEX_H
@@ -0,0 +1,119 @@
+// FILE: include/utils/LatencyHistogram.h
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Log-linear histogram of non-negative latencies (any unit, typically ms).
+// Values below SUB_BUCKETS get a bucket each; above that every power of two
+// is split into SUB_BUCKETS equal buckets, so a bucket is never wider than
+// 1/SUB_BUCKETS of its values (6.25%) over the whole uint32_t range.
+// record() is a bit scan and an increment; percentiles walk the buckets.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 4;
+    static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static const int BUCKET_COUNT = SUB_BUCKETS + (32 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+    LatencyHistogram() { clear(); }
+
+    void record(uint32_t value) {
+        counts[bucketOf(value)]++;
+        total++;
+        valueSum += value;
+        if (value > maxValue) {
+            maxValue = value;
+        }
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t sum() const { return valueSum; }
+    uint32_t max() const { return maxValue; }
+
+    // Nearest-rank percentile (p in [0, 100]) to within the bucket width:
+    // the middle of the bucket holding that rank, never above the largest
+    // recorded value; 0 when empty
+    uint32_t percentile(double p) const {
+        if (total == 0) {
+            return 0;
+        }
+
+        uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(total) + 0.999999);
+        rank = rank < 1 ? 1 : (rank > total ? total : rank);
+
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += counts[bucket];
+            if (seen >= rank) {
+                const uint64_t low = bucketLow(bucket);
+                const uint64_t middle = low + (bucketWidth(bucket) - 1) / 2;
+                return static_cast<uint32_t>(middle < maxValue ? middle : maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            counts[bucket] += other.counts[bucket];
+        }
+        total += other.total;
+        valueSum += other.valueSum;
+        if (other.maxValue > maxValue) {
+            maxValue = other.maxValue;
+        }
+    }
+
+    void clear() {
+        std::memset(counts, 0, sizeof(counts));
+        total = 0;
+        valueSum = 0;
+        maxValue = 0;
+    }
+
+    static int bucketOf(uint32_t value) {
+        if (value < static_cast<uint32_t>(SUB_BUCKETS)) {
+            return static_cast<int>(value);
+        }
+        const int octave = highestBit(value) - SUB_BUCKET_BITS;   // >= 0
+        const int sub = static_cast<int>(value >> octave) - SUB_BUCKETS;
+        return SUB_BUCKETS + octave * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t bucketLow(int bucket) {
+        if (bucket < SUB_BUCKETS) {
+            return static_cast<uint64_t>(bucket);
+        }
+        const int octave = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+        const int sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+        return static_cast<uint64_t>(SUB_BUCKETS + sub) << octave;
+    }
+
+    static uint64_t bucketWidth(int bucket) {
+        return bucket < SUB_BUCKETS ? 1 : uint64_t(1) << ((bucket - SUB_BUCKETS) / SUB_BUCKETS);
+    }
+
+private:
+    uint64_t counts[BUCKET_COUNT];
+    uint64_t total;
+    uint64_t valueSum;
+    uint32_t maxValue;
+
+    // Index of the highest set bit (value > 0)
+    static int highestBit(uint32_t value) {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanReverse(&index, value);
+        return static_cast<int>(index);
+#else
+        return 31 - __builtin_clz(value);
+#endif
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
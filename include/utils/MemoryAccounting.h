@@ -0,0 +1,93 @@
+// FILE: include/utils/MemoryAccounting.h
+#ifndef MEMORY_ACCOUNTING_H
+#define MEMORY_ACCOUNTING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+// Subsystems whose heap memory is accounted
+enum class MemoryTag {
+    VEHICLES,       // Vehicle objects
+    WAYPOINTS,      // Vehicle waypoint vectors
+    VEHICLE_IDS,    // Heap buffers of vehicle id strings (short ids live inside the Vehicle)
+    LOG_BUFFER,     // DebugLogger's recent-log ring
+    QUEUES,         // Queue and PriorityQueue storage (lane queues)
+    COUNT
+};
+
+// Process-wide allocation counters per MemoryTag: live and peak bytes, and
+// running totals from which allocation rates are derived. Containers record
+// through TrackingAllocator; objects and strings call allocated()/released()
+// themselves. Counters are relaxed atomics on their own cache lines, so
+// simulations on worker threads can share them.
+class MemoryAccounting {
+public:
+    static const int TAG_COUNT = static_cast<int>(MemoryTag::COUNT);
+
+    struct TagStats {
+        uint64_t liveBytes = 0;
+        uint64_t peakBytes = 0;
+        uint64_t allocations = 0;       // Allocations since start-up
+        uint64_t allocatedBytes = 0;    // Bytes allocated since start-up
+    };
+
+    static const char* tagName(MemoryTag tag);
+
+    // Record an allocation (zero bytes is not one) or a release
+    static void allocated(MemoryTag tag, size_t bytes);
+    static void released(MemoryTag tag, size_t bytes);
+
+    static TagStats getStats(MemoryTag tag);
+
+    // Heap bytes a string owns: its capacity when the text is not stored inline
+    static size_t stringHeapBytes(const std::string& text) {
+        const char* data = text.data();
+        const char* object = reinterpret_cast<const char*>(&text);
+        const bool inlineText = data >= object && data < object + sizeof(std::string);
+        return inlineText ? 0 : text.capacity() + 1;
+    }
+
+    // One line per tag with live and peak bytes, for the logs
+    static std::string getReport();
+
+    // "12.3 KB" style size
+    static std::string formatBytes(uint64_t bytes);
+};
+
+// Standard allocator that accounts its memory to a tag
+template<typename T, MemoryTag Tag>
+class TrackingAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = TrackingAllocator<U, Tag>;
+    };
+
+    TrackingAllocator() = default;
+
+    template<typename U>
+    TrackingAllocator(const TrackingAllocator<U, Tag>&) {}
+
+    T* allocate(size_t count) {
+        T* memory = static_cast<T*>(::operator new(count * sizeof(T)));
+        MemoryAccounting::allocated(Tag, count * sizeof(T));
+        return memory;
+    }
+
+    void deallocate(T* memory, size_t count) {
+        MemoryAccounting::released(Tag, count * sizeof(T));
+        ::operator delete(memory);
+    }
+
+    template<typename U>
+    bool operator==(const TrackingAllocator<U, Tag>&) const { return true; }
+
+    template<typename U>
+    bool operator!=(const TrackingAllocator<U, Tag>&) const { return false; }
+};
+
+#endif // MEMORY_ACCOUNTING_H
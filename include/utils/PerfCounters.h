@@ -0,0 +1,72 @@
+// FILE: include/utils/PerfCounters.h
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Hardware performance counters (Linux perf_event_open) per profiler stage.
+// Once enable() succeeds, every PROFILE_ZONE reads its thread's counter group
+// (cycles, instructions, cache misses, branch misses; user space only) on
+// entry and exit and adds the difference to the stage's process-wide totals.
+// Zones nest and are inclusive, like the profiler's. Where perf events are
+// not available or not permitted, enable() says why and zones stay a single
+// flag check.
+class PerfCounters {
+public:
+    enum class Event {
+        CYCLES,
+        INSTRUCTIONS,
+        CACHE_MISSES,
+        BRANCH_MISSES,
+        COUNT
+    };
+
+    static const int EVENT_COUNT = static_cast<int>(Event::COUNT);
+    static const int MAX_STAGES = 16;   // At least Profiler::STAGE_COUNT
+
+    // Counter values of the calling thread, with the group's enabled and
+    // running times (they differ while the kernel multiplexes the PMU)
+    struct Sample {
+        uint64_t values[EVENT_COUNT] = {};
+        uint64_t timeEnabled = 0;
+        uint64_t timeRunning = 0;
+    };
+
+    // Totals of a stage over all threads
+    struct StageTotals {
+        uint64_t samples = 0;
+        uint64_t values[EVENT_COUNT] = {};
+    };
+
+    // Open the counters on the calling thread and start sampling in zones.
+    // Returns false with the reason in error when perf events are unavailable.
+    static bool enable(std::string& error);
+
+    static void disable();
+
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    static const char* eventName(Event event);
+
+    // Read the calling thread's counters, opening them on its first read
+    // (false when they could not be opened on this thread)
+    static bool read(Sample& sample);
+
+    // Add the counts between two samples of this thread to a stage
+    static void record(int stage, const Sample& start, const Sample& end);
+
+    static StageTotals getTotals(int stage);
+
+    // Table with one line per stage that has samples: calls, cycles and
+    // instructions per call, IPC, and cache/branch misses per 1000 instructions
+    static std::string getReport();
+
+    static void clear();
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+#endif // PERF_COUNTERS_H
@@ -6,9 +6,12 @@
 #include <algorithm>
 #include <functional>
 #include <mutex>
+#include "utils/InstrumentedMutex.h"
+#include "utils/MemoryAccounting.h"
 
 // A priority queue implementation for the traffic simulation
-template<typename T>
+// (storage is accounted to Tag, see MemoryAccounting)
+template<typename T, MemoryTag Tag = MemoryTag::QUEUES>
 class PriorityQueue {
 public:
     // Element with priority
@@ -34,7 +37,7 @@ public:
 
     // Add element with priority
     void enqueue(const T& element, int priority) {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         // Add element with priority
         elements.push_back(PriorityElement(element, priority));
@@ -45,7 +48,7 @@ public:
 
     // Get the highest priority element
     T dequeue() {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         if (elements.empty()) {
             throw std::runtime_error("PriorityQueue is empty");
@@ -60,7 +63,7 @@ public:
 
     // Peek at the highest priority element without removing it
     T peek() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         if (elements.empty()) {
             throw std::runtime_error("PriorityQueue is empty");
@@ -71,7 +74,7 @@ public:
 
     // Update the priority of an element if it exists
     bool updatePriority(const T& element, int newPriority, std::function<bool(const T&, const T&)> comparator) {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         // Find the element
         auto it = std::find_if(elements.begin(), elements.end(),
@@ -94,25 +97,25 @@ public:
 
     // Check if the queue is empty
     bool isEmpty() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         return elements.empty();
     }
 
     // Get the size of the queue
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         return elements.size();
     }
 
     // Clear the queue
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         elements.clear();
     }
 
     // Get all elements in priority order
     std::vector<T> getAllElements() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         std::vector<T> result;
         result.reserve(elements.size());
@@ -125,8 +128,8 @@ public:
     }
 
 private:
-    std::vector<PriorityElement> elements;
-    mutable std::mutex mutex;
+    std::vector<PriorityElement, TrackingAllocator<PriorityElement, Tag>> elements;
+    mutable InstrumentedMutex mutex{"priority_queue"};
 };
 
 #endif // PRIORITY_QUEUE_Hendif // PRIORITY_QUEUE_H
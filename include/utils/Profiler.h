@@ -0,0 +1,186 @@
+// FILE: include/utils/Profiler.h
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include "utils/PerfCounters.h"
+#include "utils/TraceRecorder.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define PROFILER_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_HAS_TSC 1
+#endif
+
+// Per-stage frame-time profiler. PROFILE_ZONE(stage) times the rest of the
+// enclosing scope into that stage's ring of recent samples; zones nest and are
+// inclusive. Samples go to the calling thread's own rings, so simulations on
+// worker threads never share them. Without ENABLE_PROFILER (CMake option
+// ENABLE_PROFILER) the rings are compiled out and a zone only checks whether
+// a trace is being recorded (TraceRecorder), which also gets every zone, and
+// whether hardware counters are being sampled (PerfCounters).
+class Profiler {
+public:
+    enum class Stage {
+        SIM_UPDATE,          // TrafficManager::update as a whole
+        READ_VEHICLES,
+        UPDATE_PRIORITIES,
+        PROCESS_VEHICLES,
+        TRAFFIC_LIGHT,
+        LOGGING,
+        DRAW_ROADS,
+        DRAW_VEHICLES,
+        DRAW_OVERLAY,
+        PRESENT,
+        FRAME,               // One pass of the render loop
+        COUNT
+    };
+
+    static const int STAGE_COUNT = static_cast<int>(Stage::COUNT);
+    static const int RING_SIZE = 256;
+
+    // Summary of a stage's samples in the ring, in microseconds
+    struct StageStats {
+        uint32_t samples = 0;
+        double minUs = 0.0;
+        double avgUs = 0.0;
+        double maxUs = 0.0;
+        double p99Us = 0.0;
+    };
+
+    // Profiler of the calling thread
+    static Profiler& local();
+
+    static const char* stageName(Stage stage);
+
+    // Trace category of a stage: simulation, render or logging
+    static const char* stageCategory(Stage stage);
+
+    // Timestamp in ticks: the time-stamp counter where there is one (a few ns
+    // to read, against tens for the OS clock), steady_clock nanoseconds
+    // elsewhere. Ticks become time only when stats are taken.
+    static uint64_t ticks() {
+#ifdef PROFILER_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Nanoseconds per tick, measured against steady_clock since start-up
+    static double nanosecondsPerTick();
+
+    // ticks() at start-up
+    static uint64_t originTicks();
+
+    void record(Stage stage, uint64_t elapsedTicks) {
+        Ring& ring = rings[static_cast<int>(stage)];
+        ring.samples[ring.next] = static_cast<uint32_t>(elapsedTicks < 0xFFFFFFFFull ? elapsedTicks : 0xFFFFFFFFull);
+        ring.next = (ring.next + 1) % RING_SIZE;
+        if (ring.count < RING_SIZE) {
+            ring.count++;
+        }
+    }
+
+    // min/avg/max/p99 over the samples currently in the stage's ring
+    StageStats getStats(Stage stage) const;
+
+    // One line per stage that has samples, for the overlay and logs
+    std::string getReport() const;
+
+    void clear();
+
+private:
+    struct Ring {
+        uint32_t samples[RING_SIZE] = {};
+        int next = 0;
+        int count = 0;
+    };
+
+    Ring rings[STAGE_COUNT];
+};
+
+// Times its own lifetime into a stage, and into the trace while recording
+class ProfileZone {
+public:
+    explicit ProfileZone(Profiler::Stage stage) : stage(stage), start(Profiler::ticks()) {}
+
+    ~ProfileZone() {
+        const uint64_t end = Profiler::ticks();
+        Profiler::local().record(stage, end - start);
+        if (TraceRecorder::isRecording()) {
+            TraceRecorder::complete(Profiler::stageName(stage), Profiler::stageCategory(stage), start, end);
+        }
+    }
+
+private:
+    Profiler::Stage stage;
+    uint64_t start;
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+// Trace-only zone: reads the clock only while a trace is being recorded
+class TraceZone {
+public:
+    explicit TraceZone(Profiler::Stage stage)
+        : stage(stage), start(TraceRecorder::isRecording() ? Profiler::ticks() : 0) {}
+
+    ~TraceZone() {
+        if (start != 0 && TraceRecorder::isRecording()) {
+            TraceRecorder::complete(Profiler::stageName(stage), Profiler::stageCategory(stage), start, Profiler::ticks());
+        }
+    }
+
+private:
+    Profiler::Stage stage;
+    uint64_t start;
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+};
+
+// Hardware counters of its own lifetime, while PerfCounters are enabled
+class PerfZone {
+public:
+    explicit PerfZone(Profiler::Stage stage)
+        : stage(stage), active(PerfCounters::isEnabled() && PerfCounters::read(start)) {}
+
+    ~PerfZone() {
+        PerfCounters::Sample end;
+        if (active && PerfCounters::read(end)) {
+            PerfCounters::record(static_cast<int>(stage), start, end);
+        }
+    }
+
+private:
+    Profiler::Stage stage;
+    PerfCounters::Sample start;
+    bool active;
+
+    PerfZone(const PerfZone&) = delete;
+    PerfZone& operator=(const PerfZone&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+// The counter zone encloses the timing zone, so its reads are not timed
+#ifdef ENABLE_PROFILER
+#define PROFILE_ZONE(stage) \
+    PerfZone PROFILE_CONCAT(perfZone, __LINE__)(Profiler::Stage::stage); \
+    ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(Profiler::Stage::stage)
+#else
+#define PROFILE_ZONE(stage) \
+    PerfZone PROFILE_CONCAT(perfZone, __LINE__)(Profiler::Stage::stage); \
+    TraceZone PROFILE_CONCAT(profileZone, __LINE__)(Profiler::Stage::stage)
+#endif
+
+#endif // PROFILER_H
@@ -8,23 +8,28 @@
 #include <algorithm>
 #include <string>
 #include <functional>
+#include "utils/InstrumentedMutex.h"
+#include "utils/MemoryAccounting.h"
 
 // A thread-safe queue implementation for the traffic simulation
-template<typename T>
+// (storage is accounted to Tag, see MemoryAccounting)
+template<typename T, MemoryTag Tag = MemoryTag::QUEUES>
 class Queue {
 public:
+    using Container = std::vector<T, TrackingAllocator<T, Tag>>;
+
     Queue() = default;
     ~Queue() = default;
 
     // Add element to the queue
     void enqueue(const T& element) {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         elements.push_back(element);
     }
 
     // Remove and return the front element
     T dequeue() {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         if (elements.empty()) {
             throw std::runtime_error("Queue is empty");
@@ -38,7 +43,7 @@ public:
 
     // Peek at the front element without removing it
     T peek() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         if (elements.empty()) {
             throw std::runtime_error("Queue is empty");
@@ -49,25 +54,25 @@ public:
 
     // Check if the queue is empty
     bool isEmpty() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         return elements.empty();
     }
 
     // Get the size of the queue
     size_t size() const {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         return elements.size();
     }
 
     // Clear the queue
     void clear() {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
         elements.clear();
     }
 
     // Remove a specific element from anywhere in the queue (used for vehicle removal by ID)
     bool remove(const T& element, std::function<bool(const T&, const T&)> comparator) {
-        std::lock_guard<std::mutex> lock(mutex);
+        std::lock_guard<InstrumentedMutex> lock(mutex);
 
         auto it = std::find_if(elements.begin(), elements.end(),
                              [&](const T& e) {
@@ -83,15 +88,15 @@ public:
     }
 
     // Get all elements for iteration (e.g., for rendering)
-    const std::vector<T>& getAllElements() const {
+    const Container& getAllElements() const {
         // Note: This returns a const reference, so caller must not modify the vector
         // This avoids copying the entire vector while still providing access for iteration
         return elements;
     }
 
 private:
-    std::vector<T> elements;
-    mutable std::mutex mutex;
+    Container elements;
+    mutable InstrumentedMutex mutex{"queue"};
 };
 
 #endif // QUEUE_Hendif // QUEUE_Hendif // QUEUE_H
@@ -0,0 +1,73 @@
+// FILE: include/utils/SeqLock.h
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer sequence lock. The writer never waits; readers copy the value
+// without taking a lock and retry if a write happened meanwhile. The payload is
+// kept in relaxed atomic words so concurrent reads are not data races.
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock needs a trivially copyable type");
+
+public:
+    SeqLock() : sequence(0) {
+        for (auto& word : words) {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Publish a new value (one writer thread only)
+    void store(const T& value) {
+        uint64_t buffer[WORD_COUNT] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const uint32_t start = sequence.load(std::memory_order_relaxed);
+        sequence.store(start + 1, std::memory_order_relaxed);   // Odd: write in progress
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+
+        sequence.store(start + 2, std::memory_order_release);
+    }
+
+    // Latest complete value (any thread)
+    T load() const {
+        uint64_t buffer[WORD_COUNT];
+        uint32_t before = 0;
+        uint32_t after = 0;
+
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORD_COUNT; i++) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1u) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Number of completed writes
+    uint32_t version() const {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Sequence and payload on separate cache lines from each other's neighbours
+    alignas(64) std::atomic<uint32_t> sequence;
+    alignas(64) std::atomic<uint64_t> words[WORD_COUNT];
+};
+
+#endif // SEQ_LOCK_H
@@ -0,0 +1,152 @@
+// FILE: include/utils/SpatialHash.h
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+
+// A uniform-grid spatial hash for neighbour queries over a fixed area.
+// Items are collected with insert() and bucketed by build() using a
+// counting sort, so a full rebuild is O(n + cells) with no per-cell allocation.
+template<typename T>
+class SpatialHash {
+public:
+    SpatialHash(float originX, float originY, float width, float height, float cellSize)
+        : originX(originX),
+          originY(originY),
+          cellSize(cellSize),
+          inverseCellSize(1.0f / cellSize),
+          columns(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+          rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))),
+          cellStart(static_cast<size_t>(columns) * rows + 1, 0) {}
+
+    ~SpatialHash() = default;
+
+    // Remove all items (keeps capacity for the next rebuild)
+    void clear() {
+        pending.clear();
+        entries.clear();
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+    }
+
+    // Add an item at a position; items outside the grid area are ignored
+    bool insert(const T& item, float x, float y) {
+        int cell = cellIndex(x, y);
+        if (cell < 0) {
+            return false;
+        }
+
+        pending.push_back({item, x, y, cell});
+        return true;
+    }
+
+    // Bucket all inserted items by cell (counting sort)
+    void build() {
+        std::fill(cellStart.begin(), cellStart.end(), 0);
+
+        // Count items per cell
+        for (const auto& entry : pending) {
+            cellStart[entry.cell + 1]++;
+        }
+
+        // Prefix sum gives the first slot of each cell
+        for (size_t i = 1; i < cellStart.size(); i++) {
+            cellStart[i] += cellStart[i - 1];
+        }
+
+        // Scatter into cell order
+        entries.resize(pending.size());
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (const auto& entry : pending) {
+            entries[cursor[entry.cell]++] = entry;
+        }
+
+        pending.clear();
+    }
+
+    // Call fn(item, distanceSquared) for every item within radius of (x, y)
+    template<typename Fn>
+    void forEachNeighbor(float x, float y, float radius, Fn&& fn) const {
+        int minColumn = std::max(0, static_cast<int>(std::floor((x - radius - originX) * inverseCellSize)));
+        int maxColumn = std::min(columns - 1, static_cast<int>(std::floor((x + radius - originX) * inverseCellSize)));
+        int minRow = std::max(0, static_cast<int>(std::floor((y - radius - originY) * inverseCellSize)));
+        int maxRow = std::min(rows - 1, static_cast<int>(std::floor((y + radius - originY) * inverseCellSize)));
+
+        const float radiusSquared = radius * radius;
+
+        for (int row = minRow; row <= maxRow; row++) {
+            for (int column = minColumn; column <= maxColumn; column++) {
+                size_t cell = static_cast<size_t>(row) * columns + column;
+
+                for (size_t i = cellStart[cell]; i < cellStart[cell + 1]; i++) {
+                    const Entry& entry = entries[i];
+                    float dx = entry.x - x;
+                    float dy = entry.y - y;
+                    float distanceSquared = dx * dx + dy * dy;
+
+                    if (distanceSquared <= radiusSquared) {
+                        fn(entry.item, distanceSquared);
+                    }
+                }
+            }
+        }
+    }
+
+    // Call fn(item, x, y) for every bucketed item
+    template<typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& entry : entries) {
+            fn(entry.item, entry.x, entry.y);
+        }
+    }
+
+    // Number of bucketed items
+    size_t size() const {
+        return entries.size();
+    }
+
+    float getCellSize() const {
+        return cellSize;
+    }
+
+private:
+    struct Entry {
+        T item;
+        float x;
+        float y;
+        int cell;
+    };
+
+    float originX;
+    float originY;
+    float cellSize;
+    float inverseCellSize;
+    int columns;
+    int rows;
+
+    std::vector<Entry> pending;     // Items inserted since the last build
+    std::vector<Entry> entries;     // Items sorted by cell
+    std::vector<size_t> cellStart;  // entries[cellStart[c] .. cellStart[c+1]) lie in cell c
+    std::vector<size_t> cursor;     // Scatter position per cell during build()
+
+    // Returns -1 for positions outside the grid
+    int cellIndex(float x, float y) const {
+        float localX = x - originX;
+        float localY = y - originY;
+        if (localX < 0.0f || localY < 0.0f) {
+            return -1;
+        }
+
+        int column = static_cast<int>(localX * inverseCellSize);
+        int row = static_cast<int>(localY * inverseCellSize);
+        if (column >= columns || row >= rows) {
+            return -1;
+        }
+
+        return row * columns + column;
+    }
+};
+
+#endif // SPATIAL_HASH_H
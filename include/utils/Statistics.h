@@ -0,0 +1,43 @@
+// FILE: include/utils/Statistics.h
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Summary statistics over samples (used by the batch and benchmark tools)
+namespace Statistics {
+
+    // Arithmetic mean, 0 for no samples
+    template<typename T>
+    double mean(const std::vector<T>& samples) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+
+        double sum = 0.0;
+        for (const auto& value : samples) {
+            sum += static_cast<double>(value);
+        }
+        return sum / samples.size();
+    }
+
+    // Nearest-rank percentile (p in [0, 100]), 0 for no samples. Reorders the samples.
+    template<typename T>
+    double percentile(std::vector<T>& samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+
+        double rank = std::ceil(p / 100.0 * samples.size());
+        size_t index = static_cast<size_t>(std::max(1.0, rank)) - 1;
+        index = std::min(index, samples.size() - 1);
+
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return static_cast<double>(samples[index]);
+    }
+}
+
+#endif // STATISTICS_H
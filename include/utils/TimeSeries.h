@@ -0,0 +1,97 @@
+// FILE: include/utils/TimeSeries.h
+#ifndef TIME_SERIES_H
+#define TIME_SERIES_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Columnar time-series file of int64 samples. Rows are buffered into blocks
+// of BLOCK_ROWS; a full block is handed to a background thread that writes it
+// column by column, each column as zigzag varint deltas, so slowly changing
+// counters cost about a byte per sample. Layout:
+//
+//   "TSERIES1", uint32 column count, column names (BinaryIO strings)
+//   per block: uint32 rows, then per column uint32 byte length and the
+//   encoded deltas (the first one from 0, so every block decodes on its own)
+//
+// The header uses native byte order like the snapshots; varints do not.
+class TimeSeriesRecorder {
+public:
+    static const size_t BLOCK_ROWS = 4096;
+
+    TimeSeriesRecorder() = default;
+    ~TimeSeriesRecorder();
+
+    // Create the file and start the writer thread
+    bool open(const std::string& path, const std::vector<std::string>& columns);
+
+    // Write the buffered rows, then stop the writer and close the file
+    void close();
+
+    bool isOpen() const { return file.is_open(); }
+    const std::string& getPath() const { return path; }
+    size_t getColumnCount() const { return columnNames.size(); }
+
+    // Add one row of getColumnCount() values (one producer thread only)
+    void append(const int64_t* row);
+
+    uint64_t getRowsWritten() const { return rowsWritten.load(std::memory_order_relaxed); }
+    uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+
+private:
+    // Rows stored column by column
+    struct Block {
+        std::vector<std::vector<int64_t>> columns;
+        size_t rows = 0;
+    };
+
+    std::string path;
+    std::ofstream file;
+    std::vector<std::string> columnNames;
+    Block current;
+    std::atomic<uint64_t> rowsWritten{0};
+    std::atomic<uint64_t> bytesWritten{0};
+
+    // Blocks waiting for the writer
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::vector<Block> pending;
+    bool stopping = true;
+    std::thread writer;
+
+    Block emptyBlock() const;
+    void submit();
+    void writeLoop();
+    void writeBlock(const Block& block);
+
+    TimeSeriesRecorder(const TimeSeriesRecorder&) = delete;
+    TimeSeriesRecorder& operator=(const TimeSeriesRecorder&) = delete;
+};
+
+// Reads a file written by TimeSeriesRecorder one block at a time
+class TimeSeriesReader {
+public:
+    // Open the file and read its column names
+    bool open(const std::string& path);
+
+    const std::vector<std::string>& getColumns() const { return columns; }
+
+    // Decode the next block into one vector per column. Returns false at the
+    // end of the file and on damaged data (then hasError() is set).
+    bool readBlock(std::vector<std::vector<int64_t>>& values);
+
+    bool hasError() const { return error; }
+
+private:
+    std::ifstream file;
+    std::vector<std::string> columns;
+    bool error = false;
+};
+
+#endif // TIME_SERIES_H
@@ -0,0 +1,104 @@
+// FILE: include/utils/TraceRecorder.h
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Trace Event Format (chrome://tracing, Perfetto) recorder. Threads append
+// events to their own buffers without locking; a full buffer is handed to a
+// background writer that formats it into the JSON file, which stops growing
+// at the byte limit given to open(). Recording can be switched on and off
+// any number of times while the file is open; close() finishes the JSON.
+// Timestamps are Profiler::ticks(). Names and categories are not copied and
+// must be string literals.
+class TraceRecorder {
+public:
+    // One recorded event
+    struct Event {
+        const char* name;
+        const char* category;
+        char phase;             // 'X' complete, 'i' instant, 'C' counter
+        uint32_t thread;
+        uint64_t start;         // Ticks
+        uint64_t duration;      // Ticks, complete events only
+        int64_t value;          // Counter events only
+    };
+
+    // Events a thread buffers before handing them to the writer
+    static const size_t BUFFER_EVENTS = 4096;
+
+    static TraceRecorder& instance();
+
+    // Open the trace file and start the writer thread; recording stays off
+    bool open(const std::string& path, uint64_t maxBytes);
+
+    // Flush every buffer handed over, finish the JSON and stop the writer
+    void close();
+
+    bool isOpen() const { return file.is_open(); }
+    const std::string& getPath() const { return path; }
+
+    // Start or stop recording; stopping flushes the calling thread's buffer.
+    // Returns whether recording is on (it cannot start once the file is full).
+    bool setRecording(bool on);
+    bool toggleRecording() { return setRecording(!isRecording()); }
+
+    static bool isRecording() { return recording.load(std::memory_order_relaxed); }
+
+    // Whether the byte limit was reached (recording stopped by itself)
+    bool isFull() const { return full.load(std::memory_order_relaxed); }
+    uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+    uint64_t getEventsWritten() const { return eventsWritten.load(std::memory_order_relaxed); }
+
+    // Record events on the calling thread (no-ops while not recording)
+    static void complete(const char* name, const char* category, uint64_t startTicks, uint64_t endTicks);
+    static void instant(const char* name, const char* category);
+    static void counter(const char* name, int64_t value);
+
+    // Hand the calling thread's buffered events to the writer
+    static void flushThread();
+
+private:
+    static std::atomic<bool> recording;
+
+    std::string path;
+    std::ofstream file;
+    uint64_t maxBytes = 0;
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<uint64_t> eventsWritten{0};
+    std::atomic<bool> full{false};
+
+    // Buffers waiting for the writer
+    std::mutex queueMutex;
+    std::condition_variable queueReady;
+    std::vector<std::vector<Event>> pending;
+    bool stopping = true;     // No buffers accepted (closed or closing)
+    std::thread writer;
+
+    TraceRecorder() = default;
+    ~TraceRecorder();
+
+    static void append(const Event& event);
+
+    // Stop the writer once it has written the queued buffers, and finish the JSON
+    void finish();
+
+    // Queue a buffer for the writer (any thread)
+    void submit(std::vector<Event>& events);
+
+    // Writer thread: format queued buffers until close()
+    void writeLoop();
+    void writeEvents(const std::vector<Event>& events);
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+};
+
+#endif // TRACE_RECORDER_H
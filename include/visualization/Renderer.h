@@ -7,6 +7,7 @@
 #include <vector>
 #include <memory>
 #include "core/Vehicle.h" // Add this to include Direction enum
+#include "utils/MemoryAccounting.h"
 
 class Lane;
 class TrafficLight;
@@ -38,9 +39,16 @@ public:
     // Toggle debug overlay
     void toggleDebugOverlay();
 
+    // Start or pause trace recording (opens Constants::TRACE_DEFAULT_PATH if no trace is open)
+    void toggleTraceRecording();
+
     // Set frame rate limiter
     void setFrameRateLimit(int fps);
 
+    // Simulated time per wall-clock time (1 = real time, Constants::TIME_WARP_UNLIMITED = as fast as possible)
+    void setTimeWarp(float factor);
+    float getTimeWarp() const;
+
 private:
     // SDL components
     SDL_Window* window;
@@ -54,6 +62,13 @@ private:
     int frameRateLimit;
     uint32_t lastFrameTime;
 
+    // Time warp state
+    float timeWarp;
+    double pendingSimTime;        // Simulation time owed to the model (ms)
+    float achievedWarp;           // Measured simulation/wall-clock ratio
+    uint64_t warpSampleWallStart; // Start of the current measurement window (wall ms)
+    uint32_t warpSampleSimStart;  // Simulation time at the start of the window
+
     // Window dimensions
     int windowWidth;
     int windowHeight;
@@ -61,6 +76,11 @@ private:
     // Traffic manager
     TrafficManager* trafficManager;
 
+    // Allocation counters at the last sample (once a second) and the rates since the one before
+    MemoryAccounting::TagStats memorySample[MemoryAccounting::TAG_COUNT];
+    double allocationRate[MemoryAccounting::TAG_COUNT];
+    uint64_t memorySampleTime;    // Wall ms of memorySample, 0 before the first
+
     // Helper drawing functions
     void drawRoadsAndLanes();
     void drawTrafficLights();
@@ -68,6 +88,9 @@ private:
     void drawDebugOverlay();
     void drawLaneLabels();
     void drawStatistics();
+    void drawProfiler();
+    float drawMemory();                 // Returns the top of the panel
+    void drawLockStats(float bottom);   // Lock contention panel ending at bottom
 
     // Text rendering (simplified without TTF)
     void drawText(const std::string& text, int x, int y, SDL_Color color);
@@ -78,6 +101,12 @@ private:
     // Process SDL events
     bool processEvents();
 
+    // Run as many fixed simulation steps as the warp factor asks for, but stop at the deadline
+    void advanceSimulation(uint32_t wallDelta, uint64_t deadline);
+
+    // Update the achieved warp ratio shown in the overlay
+    void measureTimeWarp(uint64_t now);
+
     // Helper to draw a filled road arrow
     void drawArrow(int x1, int y1, int x2, int y2, int x3, int y3, SDL_Color color);
 
@@ -86,4 +115,4 @@ private:
   void drawLaneFlowArrow(int x, int y, Direction dir);
 };
 
-#endif // RENDERER_Hendif // RENDERER_Hendif // RENDERER_Hendif // RENDERER_H
+#endif // RENDERER_H
@@ -0,0 +1,125 @@
+// FILE: src/core/CarFollowing.cpp
+#include "core/CarFollowing.h"
+#include "core/Constants.h"
+#include <algorithm>
+#include <cmath>
+
+void LaneKinematics::pushBack(float startPosition, float stopLinePosition, float bodyLength) {
+    position.push_back(startPosition);
+    speed.push_back(0.0f);
+    acceleration.push_back(0.0f);
+    length.push_back(bodyLength);
+    stopLine.push_back(stopLinePosition);
+    displacement.push_back(0.0f);
+}
+
+void LaneKinematics::popFront() {
+    if (size() == 0) {
+        return;
+    }
+
+    head++;
+    compact();
+}
+
+void LaneKinematics::clear() {
+    position.clear();
+    speed.clear();
+    acceleration.clear();
+    length.clear();
+    stopLine.clear();
+    displacement.clear();
+    head = 0;
+}
+
+void LaneKinematics::compact() {
+    // Erasing the front on every dequeue would be O(n); do it in bulk instead
+    if (head < 64 || head * 2 < position.size()) {
+        return;
+    }
+
+    for (auto* column : {&position, &speed, &acceleration, &length, &stopLine, &displacement}) {
+        column->erase(column->begin(), column->begin() + head);
+    }
+    head = 0;
+}
+
+namespace {
+
+struct IdmParams {
+    float desiredSpeed;
+    float maxAcceleration;
+    float maxDeceleration;
+    float headway;
+    float minGap;
+    float brakingTerm;   // 2 * sqrt(a * b)
+};
+
+// IDM acceleration for one vehicle. Only selects, no branches, so callers' loops vectorize.
+inline float idmAcceleration(const IdmParams& p, float position, float speed,
+                             float leaderGap, float leaderSpeed,
+                             float stopLine, float stopLineFlag) {
+    const float noLeader = 1.0e9f;
+
+    // Stop line acts as a stopped leader until the vehicle reaches it
+    const bool stopping = (stopLineFlag > 0.0f) & (position < stopLine);
+    const float stopGap = stopping ? stopLine - position : noLeader;
+
+    // Whichever is closer wins; a stop line has zero speed
+    const float leaderWeight = static_cast<float>(leaderGap <= stopGap);
+    const float gap = std::max(std::min(stopGap, leaderGap), 0.01f);
+    const float approachRate = speed - leaderWeight * leaderSpeed;
+
+    const float desiredGap = p.minGap + std::max(0.0f, speed * p.headway + speed * approachRate / p.brakingTerm);
+    const float speedRatio = speed / p.desiredSpeed;
+    const float speedRatio2 = speedRatio * speedRatio;
+    const float gapRatio = desiredGap / gap;
+
+    const float a = p.maxAcceleration * (1.0f - speedRatio2 * speedRatio2 - gapRatio * gapRatio);
+    return std::max(a, -p.maxDeceleration);
+}
+
+} // namespace
+
+void CarFollowingModel::step(LaneKinematics& lane, float dt, bool stopLineActive) {
+    const size_t count = lane.size();
+    if (count == 0 || dt <= 0.0f) {
+        return;
+    }
+
+    float* pos = lane.position.data() + lane.head;
+    float* vel = lane.speed.data() + lane.head;
+    float* acc = lane.acceleration.data() + lane.head;
+    float* moved = lane.displacement.data() + lane.head;
+    const float* len = lane.length.data() + lane.head;
+    const float* stop = lane.stopLine.data() + lane.head;
+
+    const IdmParams params = {
+        Constants::IDM_DESIRED_SPEED,
+        Constants::IDM_MAX_ACCELERATION,
+        Constants::IDM_MAX_DECELERATION,
+        Constants::IDM_TIME_HEADWAY,
+        Constants::IDM_MIN_GAP,
+        2.0f * std::sqrt(Constants::IDM_MAX_ACCELERATION * Constants::IDM_COMFORT_DECELERATION)
+    };
+    const float stopLineFlag = stopLineActive ? 1.0f : 0.0f;
+
+    // Pass 1: accelerations. The front vehicle has no leader; everyone else
+    // follows the slot before it, so the main loop has no per-element branches.
+    acc[0] = idmAcceleration(params, pos[0], vel[0], 1.0e9f, vel[0], stop[0], stopLineFlag);
+    for (size_t i = 1; i < count; i++) {
+        const float leaderGap = pos[i - 1] - len[i - 1] - pos[i];
+        acc[i] = idmAcceleration(params, pos[i], vel[i], leaderGap, vel[i - 1], stop[i], stopLineFlag);
+    }
+
+    // Pass 2: integrate (ballistic update, speeds never go negative)
+    for (size_t i = 0; i < count; i++) {
+        const float v = vel[i];
+        const float next = std::max(0.0f, v + acc[i] * dt);
+        const float distance = 0.5f * (v + next) * dt;
+
+        vel[i] = next;
+        pos[i] += distance;
+        moved[i] = distance;
+    }
+}
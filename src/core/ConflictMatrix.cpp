@@ -0,0 +1,198 @@
+// FILE: src/core/ConflictMatrix.cpp
+#include "core/ConflictMatrix.h"
+#include "core/Constants.h"
+#include "utils/DebugLogger.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace {
+    // Path through the junction: stop line to exit point (the spawn point
+    // before it and the off-screen point after it are outside the junction)
+    std::vector<Point> junctionPath(const Movement& movement) {
+        Vehicle probe("conflict_probe", movement.fromRoad, movement.fromLane);
+        probe.setDestination(movement.turn);
+
+        const Vehicle::WaypointList& waypoints = probe.getWaypoints();
+        if (waypoints.size() < 4) {
+            return std::vector<Point>(waypoints.begin(), waypoints.end());
+        }
+        return std::vector<Point>(waypoints.begin() + 1, waypoints.end() - 1);
+    }
+
+    float cross(const Point& origin, const Point& a, const Point& b) {
+        return (a.x - origin.x) * (b.y - origin.y) - (a.y - origin.y) * (b.x - origin.x);
+    }
+
+    float pointToSegment(const Point& p, const Point& a, const Point& b) {
+        const float dx = b.x - a.x;
+        const float dy = b.y - a.y;
+        const float lengthSquared = dx * dx + dy * dy;
+        float t = lengthSquared > 0.0f ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSquared : 0.0f;
+        t = std::max(0.0f, std::min(1.0f, t));
+        return std::hypot(a.x + t * dx - p.x, a.y + t * dy - p.y);
+    }
+
+    float segmentDistance(const Point& a, const Point& b, const Point& c, const Point& d) {
+        const float d1 = cross(c, d, a);
+        const float d2 = cross(c, d, b);
+        const float d3 = cross(a, b, c);
+        const float d4 = cross(a, b, d);
+        if (((d1 > 0.0f) != (d2 > 0.0f)) && ((d3 > 0.0f) != (d4 > 0.0f))) {
+            return 0.0f;   // Proper crossing
+        }
+        return std::min(std::min(pointToSegment(a, c, d), pointToSegment(b, c, d)),
+                        std::min(pointToSegment(c, a, b), pointToSegment(d, a, b)));
+    }
+
+    float pathDistance(const std::vector<Point>& first, const std::vector<Point>& second) {
+        float best = 1.0e9f;
+        for (size_t i = 0; i + 1 < first.size(); i++) {
+            for (size_t j = 0; j + 1 < second.size(); j++) {
+                best = std::min(best, segmentDistance(first[i], first[i + 1], second[j], second[j + 1]));
+            }
+        }
+        return best;
+    }
+
+    bool controlled(int movement) {
+        return RouteTable::movement(movement).fromLane == 2;
+    }
+}
+
+const ConflictMatrix& ConflictMatrix::junction() {
+    static const ConflictMatrix matrix;
+    return matrix;
+}
+
+ConflictMatrix::ConflictMatrix() {
+    std::vector<Point> paths[RouteTable::MOVEMENT_COUNT];
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        paths[i] = junctionPath(RouteTable::movement(i));
+    }
+
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        for (int j = i; j < RouteTable::MOVEMENT_COUNT; j++) {
+            distance[i][j] = distance[j][i] = (i == j) ? 0.0f : pathDistance(paths[i], paths[j]);
+        }
+    }
+
+    std::ostringstream oss;
+    oss << "Conflict matrix built, compatible controlled movements:";
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        for (int j = i + 1; j < RouteTable::MOVEMENT_COUNT; j++) {
+            if (controlled(i) && controlled(j) && !conflicts(i, j) &&
+                RouteTable::movement(i).fromRoad != RouteTable::movement(j).fromRoad) {
+                oss << " [" << describe(static_cast<MovementMask>((1u << i) | (1u << j))) << "]";
+            }
+        }
+    }
+    DebugLogger::log(oss.str());
+}
+
+bool ConflictMatrix::conflicts(int first, int second) const {
+    const Movement& a = RouteTable::movement(first);
+    const Movement& b = RouteTable::movement(second);
+    if (a.fromRoad == b.fromRoad && a.fromLane == b.fromLane) {
+        return false;
+    }
+    return distance[first][second] < Constants::JUNCTION_MIN_SEPARATION;
+}
+
+bool ConflictMatrix::compatible(MovementMask movements) const {
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        if (!(movements & (1u << i))) {
+            continue;
+        }
+        for (int j = i + 1; j < RouteTable::MOVEMENT_COUNT; j++) {
+            if ((movements & (1u << j)) && conflicts(i, j)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::vector<MovementMask> ConflictMatrix::phasePlan(bool allowOverlaps) const {
+    std::vector<MovementMask> plan;
+    for (char road = 'A'; road <= 'D'; road++) {
+        plan.push_back(roadMovements(road));
+    }
+    if (!allowOverlaps) {
+        return plan;
+    }
+
+    // Every compatible set of controlled movements (8 of them, so 256 subsets)
+    std::vector<int> candidates;
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        if (controlled(i)) {
+            candidates.push_back(i);
+        }
+    }
+
+    std::vector<MovementMask> sets;
+    for (uint32_t subset = 1; subset < (1u << candidates.size()); subset++) {
+        MovementMask movements = 0;
+        for (size_t k = 0; k < candidates.size(); k++) {
+            if (subset & (1u << k)) {
+                movements |= static_cast<MovementMask>(1u << candidates[k]);
+            }
+        }
+        if (compatible(movements)) {
+            sets.push_back(movements);
+        }
+    }
+
+    // Keep the maximal ones that serve more than one road (single-road sets
+    // are already covered by the road phases), in order of their first movement
+    for (MovementMask movements : sets) {
+        bool maximal = true;
+        for (MovementMask other : sets) {
+            if (other != movements && (other & movements) == movements) {
+                maximal = false;
+                break;
+            }
+        }
+
+        int roads = 0;
+        for (char road = 'A'; road <= 'D'; road++) {
+            roads += (movements & roadMovements(road)) ? 1 : 0;
+        }
+        if (maximal && roads > 1) {
+            plan.push_back(movements);
+        }
+    }
+
+    // Overlap phases slot in after the road of their lowest movement
+    std::stable_sort(plan.begin(), plan.end(), [](MovementMask a, MovementMask b) {
+        return (a & -a) < (b & -b);
+    });
+    return plan;
+}
+
+MovementMask ConflictMatrix::roadMovements(char road) {
+    MovementMask movements = 0;
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        const Movement& movement = RouteTable::movement(i);
+        if (movement.fromRoad == road && movement.fromLane == 2) {
+            movements |= static_cast<MovementMask>(1u << i);
+        }
+    }
+    return movements;
+}
+
+std::string ConflictMatrix::describe(MovementMask movements) {
+    std::string text;
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        if (!(movements & (1u << i))) {
+            continue;
+        }
+        const Movement& movement = RouteTable::movement(i);
+        if (!text.empty()) {
+            text += " + ";
+        }
+        text += std::string(1, movement.fromRoad) + "L" + std::to_string(movement.fromLane) +
+                (movement.turn == Destination::STRAIGHT ? " straight" : " left");
+    }
+    return text.empty() ? "none" : text;
+}
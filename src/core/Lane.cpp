@@ -1,6 +1,7 @@
 // FILE: src/core/Lane.cpp
 #include "core/Lane.h"
 #include "utils/DebugLogger.h"
+#include "utils/BinaryIO.h"
 #include <sstream>
 #include "core/Constants.h"
 
@@ -8,7 +9,10 @@ Lane::Lane(char laneId, int laneNumber)
     : laneId(laneId),
       laneNumber(laneNumber),
       isPriority(laneId == 'A' && laneNumber == 2), // AL2 is the priority lane
-      priority(0) {
+      priority(0),
+      priorityThresholdHigh(Constants::PRIORITY_THRESHOLD_HIGH),
+      priorityThresholdLow(Constants::PRIORITY_THRESHOLD_LOW),
+      counters(nullptr) {
 
     std::ostringstream oss;
     oss << "Created lane " << laneId << laneNumber;
@@ -17,10 +21,43 @@ Lane::Lane(char laneId, int laneNumber)
 
 Lane::~Lane() {
     // Clean up vehicles
-    while (!vehicleQueue.isEmpty()) {
+    clear();
+}
+
+void Lane::clear() {
+    size_t crossed = crossedPrefix();
+    for (size_t i = 0; !vehicleQueue.isEmpty(); i++) {
         Vehicle* vehicle = vehicleQueue.dequeue();
+        if (counters) {
+            counters->vehicleRemoved(laneId, laneNumber, movementOf(vehicle), vehicle->isEmergencyVehicle(), i >= crossed);
+        }
         delete vehicle;
     }
+    kinematics.clear();
+    priority = 0;
+}
+
+int Lane::movementOf(const Vehicle* vehicle) const {
+    return RouteTable::movementIndex(laneId, laneNumber, vehicle->getDestination());
+}
+
+size_t Lane::crossedPrefix() const {
+    // The manager records crossings in queue order, so only the leading run counts
+    const auto& vehicles = vehicleQueue.getAllElements();
+    size_t crossed = 0;
+    while (crossed < vehicles.size() && vehicles[crossed]->hasPassedStopLine()) {
+        crossed++;
+    }
+    return crossed;
+}
+
+void Lane::setCounters(TrafficCounters* laneCounters) {
+    counters = laneCounters;
+}
+
+void Lane::setPriorityThresholds(int high, int low) {
+    priorityThresholdHigh = high;
+    priorityThresholdLow = low;
 }
 
 void Lane::enqueue(Vehicle* vehicle) {
@@ -30,8 +67,14 @@ void Lane::enqueue(Vehicle* vehicle) {
     }
 
     vehicleQueue.enqueue(vehicle);
+    kinematics.pushBack(vehicle->getPathDistance(), vehicle->getStopLineDistance(),
+                        Constants::IDM_VEHICLE_LENGTH);
     int currentCount = vehicleQueue.size();
 
+    if (counters) {
+        counters->vehicleArrived(laneId, laneNumber, movementOf(vehicle), vehicle->isEmergencyVehicle());
+    }
+
     // Log the action
     std::ostringstream oss;
     oss << "Vehicle " << vehicle->getId() << " added to lane " << laneId << laneNumber;
@@ -44,11 +87,11 @@ void Lane::enqueue(Vehicle* vehicle) {
 
     // CRITICAL: Update priority immediately if this is the priority lane
     if (isPriority) {
-        if (currentCount > Constants::PRIORITY_THRESHOLD_HIGH && priority == 0) {
+        if (currentCount > priorityThresholdHigh && priority == 0) {
             priority = 100; // High priority
             std::ostringstream priorityOss;
             priorityOss << "*** Lane " << laneId << laneNumber
-                << " PRIORITY MODE ACTIVATED: " << currentCount << " vehicles (>10) ***";
+                << " PRIORITY MODE ACTIVATED: " << currentCount << " vehicles (>" << priorityThresholdHigh << ") ***";
             DebugLogger::log(priorityOss.str(), DebugLogger::LogLevel::INFO);
         }
     }
@@ -60,8 +103,14 @@ Vehicle* Lane::dequeue() {
     }
 
     Vehicle* vehicle = vehicleQueue.dequeue();
+    kinematics.popFront();
     int currentCount = vehicleQueue.size();
 
+    if (counters) {
+        counters->vehicleDeparted(laneId, laneNumber, movementOf(vehicle), vehicle->isEmergencyVehicle(),
+                                  !vehicle->hasPassedStopLine());
+    }
+
     // Log the action
     std::ostringstream oss;
     oss << "Vehicle " << vehicle->getId() << " removed from lane " << laneId << laneNumber;
@@ -69,7 +118,7 @@ Vehicle* Lane::dequeue() {
 
     // Update priority if this is the priority lane
     if (isPriority) {
-        if (currentCount < Constants::PRIORITY_THRESHOLD_LOW && priority > 0) {
+        if (currentCount < priorityThresholdLow && priority > 0) {
             priority = 0; // Normal priority
             std::ostringstream priorityOss;
             priorityOss << "Lane " << laneId << laneNumber
@@ -97,11 +146,96 @@ int Lane::getVehicleCount() const {
     return vehicleQueue.size();
 }
 
-const std::vector<Vehicle*>& Lane::getVehicles() const {
+const Lane::VehicleList& Lane::getVehicles() const {
     // Get all elements from the queue for rendering
     return vehicleQueue.getAllElements();
 }
 
+void Lane::updateCarFollowing(uint32_t delta, bool canEnter) {
+    const auto& vehicles = vehicleQueue.getAllElements();
+    if (vehicles.empty() || kinematics.size() != vehicles.size()) {
+        return;
+    }
+
+    // One pass over the whole lane, then move each vehicle along its path
+    CarFollowingModel::step(kinematics, delta / 1000.0f, !canEnter);
+
+    const float* displacement = kinematics.displacement.data() + kinematics.head;
+    for (size_t i = 0; i < vehicles.size(); i++) {
+        vehicles[i]->advanceAlongPath(displacement[i], delta);
+    }
+}
+
+const LaneKinematics& Lane::getKinematics() const {
+    return kinematics;
+}
+
+void Lane::saveState(std::ostream& out) const {
+    const auto& vehicles = vehicleQueue.getAllElements();
+
+    BinaryIO::write(out, static_cast<int32_t>(priority));
+    BinaryIO::write(out, static_cast<uint32_t>(vehicles.size()));
+
+    for (size_t i = 0; i < vehicles.size(); i++) {
+        vehicles[i]->saveState(out);
+
+        // Matching kinematic slot (the queue and the kinematics are kept in step)
+        size_t slot = kinematics.head + i;
+        bool hasSlot = i < kinematics.size();
+        BinaryIO::write(out, hasSlot ? kinematics.position[slot] : vehicles[i]->getPathDistance());
+        BinaryIO::write(out, hasSlot ? kinematics.speed[slot] : 0.0f);
+        BinaryIO::write(out, hasSlot ? kinematics.acceleration[slot] : 0.0f);
+        BinaryIO::write(out, hasSlot ? kinematics.length[slot] : Constants::IDM_VEHICLE_LENGTH);
+        BinaryIO::write(out, hasSlot ? kinematics.stopLine[slot] : vehicles[i]->getStopLineDistance());
+    }
+}
+
+bool Lane::loadState(std::istream& in) {
+    int32_t savedPriority = 0;
+    uint32_t count = 0;
+    if (!BinaryIO::read(in, savedPriority) || !BinaryIO::read(in, count) ||
+        count > Constants::SNAPSHOT_MAX_LANE_VEHICLES) {
+        return false;
+    }
+
+    // Drop whatever the lane currently holds
+    clear();
+
+    for (uint32_t i = 0; i < count; i++) {
+        Vehicle* vehicle = Vehicle::loadState(in);
+        float position = 0.0f;
+        float speed = 0.0f;
+        float acceleration = 0.0f;
+        float length = 0.0f;
+        float stopLine = 0.0f;
+        if (!vehicle || !BinaryIO::read(in, position) || !BinaryIO::read(in, speed) ||
+            !BinaryIO::read(in, acceleration) || !BinaryIO::read(in, length) ||
+            !BinaryIO::read(in, stopLine)) {
+            delete vehicle;
+            return false;
+        }
+
+        vehicleQueue.enqueue(vehicle);
+        kinematics.pushBack(position, stopLine, length);
+        kinematics.speed.back() = speed;
+        kinematics.acceleration.back() = acceleration;
+    }
+
+    priority = savedPriority;
+
+    // Count the restored vehicles without adding to the flow totals
+    if (counters) {
+        const auto& vehicles = vehicleQueue.getAllElements();
+        size_t crossed = crossedPrefix();
+        for (size_t i = 0; i < vehicles.size(); i++) {
+            counters->vehicleRestored(laneId, laneNumber, movementOf(vehicles[i]), vehicles[i]->isEmergencyVehicle(),
+                                      i >= crossed);
+        }
+    }
+
+    return true;
+}
+
 int Lane::getPriority() const {
     return priority;
 }
@@ -112,19 +246,19 @@ void Lane::updatePriority() {
     // CRITICAL: Update priority based on vehicle count for AL2 lane
     if (isPriority) {
         // PRIORITY RULE: Enter priority mode when > PRIORITY_THRESHOLD_HIGH
-        if (count > Constants::PRIORITY_THRESHOLD_HIGH && priority == 0) {
+        if (count > priorityThresholdHigh && priority == 0) {
             priority = 100; // High priority
             std::ostringstream oss;
             oss << "*** Lane " << laneId << laneNumber
-                << " PRIORITY MODE ACTIVATED: " << count << " vehicles (>10)";
+                << " PRIORITY MODE ACTIVATED: " << count << " vehicles (>" << priorityThresholdHigh << ")";
             DebugLogger::log(oss.str(), DebugLogger::LogLevel::INFO);
         }
         // PRIORITY RULE: Exit priority mode when < PRIORITY_THRESHOLD_LOW
-        else if (count < Constants::PRIORITY_THRESHOLD_LOW && priority > 0) {
+        else if (count < priorityThresholdLow && priority > 0) {
             priority = 0; // Normal priority
             std::ostringstream oss;
             oss << "*** Lane " << laneId << laneNumber
-                << " PRIORITY MODE DEACTIVATED: " << count << " vehicles (<5)";
+                << " PRIORITY MODE DEACTIVATED: " << count << " vehicles (<" << priorityThresholdLow << ")";
             DebugLogger::log(oss.str(), DebugLogger::LogLevel::INFO);
         }
     }
@@ -0,0 +1,133 @@
+// FILE: src/core/QTable.cpp
+#include "core/QTable.h"
+#include "core/Constants.h"
+#include "utils/BinaryIO.h"
+#include "utils/DebugLogger.h"
+#include <fstream>
+#include <vector>
+
+QTable::QTable() {
+    clear();
+}
+
+QTable& QTable::policy() {
+    static QTable table;
+    return table;
+}
+
+float QTable::value(int state, int action) const {
+    return values[state * ACTION_COUNT + action].load(std::memory_order_relaxed);
+}
+
+int QTable::bestAction(int state) const {
+    if (visits(state) == 0) {
+        return -1;
+    }
+
+    int best = 0;
+    for (int action = 1; action < ACTION_COUNT; action++) {
+        if (value(state, action) > value(state, best)) {
+            best = action;
+        }
+    }
+    return best;
+}
+
+float QTable::maxValue(int state) const {
+    const int best = bestAction(state);
+    return best >= 0 ? value(state, best) : 0.0f;
+}
+
+void QTable::update(int state, int action, float target, float learningRate) {
+    std::atomic<float>& entry = values[state * ACTION_COUNT + action];
+    float current = entry.load(std::memory_order_relaxed);
+    while (!entry.compare_exchange_weak(current, current + learningRate * (target - current),
+                                        std::memory_order_relaxed)) {
+    }
+    stateVisits[state].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t QTable::visits(int state) const {
+    return stateVisits[state].load(std::memory_order_relaxed);
+}
+
+int QTable::visitedStates() const {
+    int visited = 0;
+    for (int state = 0; state < STATE_COUNT; state++) {
+        visited += visits(state) > 0 ? 1 : 0;
+    }
+    return visited;
+}
+
+void QTable::clear() {
+    for (auto& entry : values) {
+        entry.store(0.0f, std::memory_order_relaxed);
+    }
+    for (auto& count : stateVisits) {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+bool QTable::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        DebugLogger::log("Could not write Q-table " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    BinaryIO::write(file, Constants::QTABLE_MAGIC);
+    BinaryIO::write(file, Constants::QTABLE_VERSION);
+    BinaryIO::write(file, static_cast<uint32_t>(STATE_COUNT));
+    BinaryIO::write(file, static_cast<uint32_t>(ACTION_COUNT));
+    for (const auto& entry : values) {
+        BinaryIO::write(file, entry.load(std::memory_order_relaxed));
+    }
+    for (const auto& count : stateVisits) {
+        BinaryIO::write(file, count.load(std::memory_order_relaxed));
+    }
+    return static_cast<bool>(file);
+}
+
+bool QTable::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        DebugLogger::log("Could not open Q-table " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t states = 0;
+    uint32_t actions = 0;
+    if (!BinaryIO::read(file, magic) || !BinaryIO::read(file, version) ||
+        !BinaryIO::read(file, states) || !BinaryIO::read(file, actions) ||
+        magic != Constants::QTABLE_MAGIC || version != Constants::QTABLE_VERSION ||
+        states != static_cast<uint32_t>(STATE_COUNT) || actions != static_cast<uint32_t>(ACTION_COUNT)) {
+        DebugLogger::log("Q-table " + path + " has a different format", DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    // Read everything before touching the table, so a short file leaves it as it was
+    std::vector<float> loadedValues(STATE_COUNT * ACTION_COUNT);
+    std::vector<uint32_t> loadedVisits(STATE_COUNT);
+    for (auto& value : loadedValues) {
+        if (!BinaryIO::read(file, value)) {
+            DebugLogger::log("Q-table " + path + " is truncated", DebugLogger::LogLevel::ERROR);
+            return false;
+        }
+    }
+    for (auto& count : loadedVisits) {
+        if (!BinaryIO::read(file, count)) {
+            DebugLogger::log("Q-table " + path + " is truncated", DebugLogger::LogLevel::ERROR);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < STATE_COUNT * ACTION_COUNT; i++) {
+        values[i].store(loadedValues[i], std::memory_order_relaxed);
+    }
+    for (int i = 0; i < STATE_COUNT; i++) {
+        stateVisits[i].store(loadedVisits[i], std::memory_order_relaxed);
+    }
+    return true;
+}
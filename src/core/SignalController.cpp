@@ -0,0 +1,799 @@
+// FILE: src/core/SignalController.cpp
+#include "core/SignalController.h"
+#include "core/QTable.h"
+#include "utils/DebugLogger.h"
+#include "utils/BinaryIO.h"
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const char* const CONTROLLER_NAMES[] = {"fixed", "queue", "actuated", "pressure", "phased", "phased-single", "webster",
+                                           "coordinated", "qlearning"};
+    const char ROADS[] = {'A', 'B', 'C', 'D'};
+}
+
+const char* signalControllerName(SignalControllerType type) {
+    return CONTROLLER_NAMES[static_cast<int>(type)];
+}
+
+bool parseSignalControllerType(const std::string& name, SignalControllerType& type) {
+    for (int i = 0; i < static_cast<int>(sizeof(CONTROLLER_NAMES) / sizeof(CONTROLLER_NAMES[0])); i++) {
+        if (name == CONTROLLER_NAMES[i]) {
+            type = static_cast<SignalControllerType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+SignalController* SignalController::create(SignalControllerType type) {
+    switch (type) {
+        case SignalControllerType::FIXED_TIME: return new FixedTimeController();
+        case SignalControllerType::QUEUE_AVERAGE: return new QueueAverageController();
+        case SignalControllerType::ACTUATED: return new ActuatedController();
+        case SignalControllerType::MAX_PRESSURE: return new MaxPressureController();
+        case SignalControllerType::PHASED: return new PhasedController(true);
+        case SignalControllerType::PHASED_SINGLE: return new PhasedController(false);
+        case SignalControllerType::WEBSTER: return new WebsterController();
+        case SignalControllerType::COORDINATED: return new CoordinatedController();
+        case SignalControllerType::QLEARNING: return new QLearningController();
+    }
+    return new QueueAverageController();
+}
+
+int SignalController::queuedVehicles(const TrafficCounters& counters, char road) {
+    return counters.lane(road, 2).queued;
+}
+
+char SignalController::roadOf(TrafficLight::State state) {
+    switch (state) {
+        case TrafficLight::State::A_GREEN: return 'A';
+        case TrafficLight::State::B_GREEN: return 'B';
+        case TrafficLight::State::C_GREEN: return 'C';
+        case TrafficLight::State::D_GREEN: return 'D';
+        default: return ' ';
+    }
+}
+
+TrafficLight::State SignalController::greenFor(char road) {
+    switch (road) {
+        case 'A': return TrafficLight::State::A_GREEN;
+        case 'B': return TrafficLight::State::B_GREEN;
+        case 'C': return TrafficLight::State::C_GREEN;
+        case 'D': return TrafficLight::State::D_GREEN;
+        default: return TrafficLight::State::ALL_RED;
+    }
+}
+
+TrafficLight::State SignalController::nextInRotation(TrafficLight::State state) {
+    switch (state) {
+        case TrafficLight::State::A_GREEN: return TrafficLight::State::B_GREEN;
+        case TrafficLight::State::B_GREEN: return TrafficLight::State::C_GREEN;
+        case TrafficLight::State::C_GREEN: return TrafficLight::State::D_GREEN;
+        default: return TrafficLight::State::A_GREEN;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Fixed time
+
+TrafficLight::State FixedTimeController::selectState(const SignalContext& context) {
+    if (context.current == TrafficLight::State::ALL_RED) {
+        return nextInRotation(context.lastGreen);
+    }
+
+    if (context.elapsed >= static_cast<uint32_t>(context.timing.fixedGreen)) {
+        return nextInRotation(context.current);
+    }
+    return context.current;
+}
+
+// ---------------------------------------------------------------------------
+// Queue average with A2 priority
+
+QueueAverageController::QueueAverageController()
+    : priorityMode(false),
+      lastPriorityLogTime(0) {
+}
+
+void QueueAverageController::reset() {
+    priorityMode = false;
+    lastPriorityLogTime = 0;
+}
+
+float QueueAverageController::predictedCount(const SignalContext& context, char road, int laneNumber) {
+    return context.counters.lane(road, laneNumber).occupancy +
+        static_cast<float>(context.rates.predictedGrowth(road, laneNumber, context.currentTime,
+                                                         context.timing.predictionHorizon));
+}
+
+void QueueAverageController::updatePriorityMode(const SignalContext& context) {
+    float vehicleCount = predictedCount(context, 'A', 2);
+
+    if (vehicleCount > context.timing.priorityThresholdHigh && !priorityMode) {
+        priorityMode = true;
+        lastPriorityLogTime = context.currentTime;
+
+        std::ostringstream oss;
+        oss << "!!! PRIORITY MODE ACTIVATED: A2 expects " << vehicleCount << " vehicles (>" << context.timing.priorityThresholdHigh << ")";
+        DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
+    }
+    // Exit priority mode when count drops below threshold
+    else if (priorityMode && vehicleCount < context.timing.priorityThresholdLow) {
+        priorityMode = false;
+
+        std::ostringstream oss;
+        oss << "!!! PRIORITY MODE DEACTIVATED: A2 expects " << vehicleCount << " vehicles (<" << context.timing.priorityThresholdLow << ")";
+        DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
+    }
+
+    // Periodically report a long-running priority mode
+    if (priorityMode && context.currentTime - lastPriorityLogTime > 5000) {
+        std::ostringstream oss;
+        oss << "Priority mode active: A2 expects " << vehicleCount << " vehicles, light state: "
+            << (context.current == TrafficLight::State::A_GREEN ? "A_GREEN" :
+               (context.current == TrafficLight::State::ALL_RED ? "ALL_RED" : "OTHER"));
+        DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
+        lastPriorityLogTime = context.currentTime;
+    }
+}
+
+TrafficLight::State QueueAverageController::selectState(const SignalContext& context) {
+    updatePriorityMode(context);
+
+    // Priority mode: keep A green, with a brief all-red every priorityGreen
+    if (priorityMode) {
+        if (context.current == TrafficLight::State::A_GREEN &&
+            context.elapsed >= static_cast<uint32_t>(context.timing.priorityGreen)) {
+            return TrafficLight::State::ALL_RED;
+        }
+        return TrafficLight::State::A_GREEN;
+    }
+
+    // Normal rotation: ALL_RED -> A -> ALL_RED -> B -> ALL_RED -> C -> ALL_RED -> D -> ...
+    if (context.current == TrafficLight::State::ALL_RED) {
+        return nextInRotation(context.lastGreen);
+    }
+
+    // Set duration using formula: Total time = |V| * t
+    float averageVehicleCount = calculateAverageVehicleCount(context);
+    int greenDuration = static_cast<int>(averageVehicleCount * context.timing.greenPerVehicle);
+    greenDuration = std::max(context.timing.minGreen, std::min(greenDuration, context.timing.maxGreen));
+
+    if (context.elapsed >= static_cast<uint32_t>(greenDuration)) {
+        std::ostringstream oss;
+        oss << "Traffic light timing: |V| = " << averageVehicleCount
+            << ", Duration = " << greenDuration / 1000.0f << " seconds";
+        DebugLogger::log(oss.str());
+        return nextInRotation(context.current);
+    }
+    return context.current;
+}
+
+float QueueAverageController::calculateAverageVehicleCount(const SignalContext& context) const {
+    int normalLaneCount = 0;
+    float totalVehicleCount = 0.0f;
+
+    // Only count lane 2 (normal lanes)
+    // In priority mode, exclude the priority lane (A2) from calculation
+    for (char road : ROADS) {
+        if (!(priorityMode && road == 'A')) {
+            normalLaneCount++;
+            totalVehicleCount += predictedCount(context, road, 2);
+        }
+    }
+
+    // Calculate average: |V| = (1/n) * Σ|Li|
+    float average = (normalLaneCount > 0) ?
+        totalVehicleCount / normalLaneCount : 0.0f;
+
+    // Return at least 1 to ensure some duration
+    return std::max(1.0f, average);
+}
+
+void QueueAverageController::saveState(std::ostream& out) const {
+    BinaryIO::write(out, priorityMode);
+    BinaryIO::write(out, lastPriorityLogTime);
+}
+
+bool QueueAverageController::loadState(std::istream& in) {
+    return BinaryIO::readBool(in, priorityMode) && BinaryIO::read(in, lastPriorityLogTime);
+}
+
+// ---------------------------------------------------------------------------
+// Actuated
+
+ActuatedController::ActuatedController()
+    : phaseStartTime(0),
+      lastDepartureTime(0),
+      lastCrossings(0) {
+}
+
+void ActuatedController::reset() {
+    phaseStartTime = 0;
+    lastDepartureTime = 0;
+    lastCrossings = 0;
+}
+
+TrafficLight::State ActuatedController::nextWithDemand(const TrafficCounters& counters,
+                                                       TrafficLight::State after) const {
+    TrafficLight::State candidate = after;
+    for (int i = 0; i < 4; i++) {
+        candidate = nextInRotation(candidate);
+        if (queuedVehicles(counters, roadOf(candidate)) > 0) {
+            return candidate;
+        }
+    }
+    return TrafficLight::State::ALL_RED;
+}
+
+TrafficLight::State ActuatedController::selectState(const SignalContext& context) {
+    if (context.current == TrafficLight::State::ALL_RED) {
+        return nextWithDemand(context.counters, context.lastGreen);
+    }
+
+    // A new green started: restart the departure detector
+    const uint32_t greenStart = context.currentTime - context.elapsed;
+    const char servedRoad = roadOf(context.current);
+    const uint32_t crossings = context.counters.lane(servedRoad, 2).crossings;
+    const int queue = queuedVehicles(context.counters, servedRoad);
+    if (greenStart != phaseStartTime) {
+        phaseStartTime = greenStart;
+        lastDepartureTime = greenStart;
+        lastCrossings = crossings;
+    }
+
+    if (crossings != lastCrossings) {
+        lastDepartureTime = context.currentTime;
+        lastCrossings = crossings;
+    }
+
+    if (context.elapsed < static_cast<uint32_t>(context.timing.minGreen)) {
+        return context.current;
+    }
+
+    const bool maxedOut = context.elapsed >= static_cast<uint32_t>(context.timing.maxGreen);
+    const bool gappedOut = queue == 0 ||
+        context.currentTime - lastDepartureTime >= static_cast<uint32_t>(context.timing.actuatedGap);
+    if (!maxedOut && !gappedOut) {
+        return context.current;
+    }
+
+    // Only hand over when someone else is waiting; otherwise rest in green
+    TrafficLight::State next = nextWithDemand(context.counters, context.current);
+    if (next == TrafficLight::State::ALL_RED || next == context.current) {
+        return context.current;
+    }
+    return next;
+}
+
+void ActuatedController::saveState(std::ostream& out) const {
+    BinaryIO::write(out, phaseStartTime);
+    BinaryIO::write(out, lastDepartureTime);
+    BinaryIO::write(out, lastCrossings);
+}
+
+bool ActuatedController::loadState(std::istream& in) {
+    return BinaryIO::read(in, phaseStartTime) && BinaryIO::read(in, lastDepartureTime) &&
+           BinaryIO::read(in, lastCrossings);
+}
+
+// ---------------------------------------------------------------------------
+// Max pressure
+
+MaxPressureController::MaxPressureController() {
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        const Movement& movement = RouteTable::movement(i);
+        // The free lane (L3) turns regardless of the light
+        if (movement.fromLane == 2) {
+            phaseMovements[movement.fromRoad - 'A'].push_back(i);
+        }
+    }
+}
+
+int MaxPressureController::pressure(const TrafficCounters& counters, char road) const {
+    int total = 0;
+    for (int movement : phaseMovements[road - 'A']) {
+        total += counters.movementQueue(movement) -
+                 counters.exitOccupancy(RouteTable::movement(movement).toRoad);
+    }
+    return total;
+}
+
+TrafficLight::State MaxPressureController::selectState(const SignalContext& context) {
+    const bool inGreen = context.current != TrafficLight::State::ALL_RED;
+    if (inGreen && context.elapsed < static_cast<uint32_t>(context.timing.minGreen)) {
+        return context.current;
+    }
+
+    const bool maxedOut = inGreen && context.elapsed >= static_cast<uint32_t>(context.timing.maxGreen);
+    const char servedRoad = roadOf(context.current);
+
+    // Scan in rotation order after the last green so ties go round fairly
+    char bestRoad = ' ';
+    int bestPressure = 0;
+    TrafficLight::State candidate = inGreen ? context.current : context.lastGreen;
+    for (int i = 0; i < 4; i++) {
+        candidate = nextInRotation(candidate);
+        char road = roadOf(candidate);
+        if (maxedOut && road == servedRoad) {
+            continue;
+        }
+
+        int roadPressure = pressure(context.counters, road);
+        if (queuedVehicles(context.counters, road) > 0 && (bestRoad == ' ' || roadPressure > bestPressure)) {
+            bestRoad = road;
+            bestPressure = roadPressure;
+        }
+    }
+
+    if (!inGreen) {
+        return bestRoad == ' ' ? TrafficLight::State::ALL_RED : greenFor(bestRoad);
+    }
+
+    if (bestRoad == ' ' || bestRoad == servedRoad) {
+        return context.current;
+    }
+
+    // Switching costs a clearance interval, so only move for strictly more pressure
+    if (maxedOut || bestPressure > pressure(context.counters, servedRoad)) {
+        return greenFor(bestRoad);
+    }
+    return context.current;
+}
+
+// ---------------------------------------------------------------------------
+// Phase plan
+
+PhasedController::PhasedController(bool allowOverlaps)
+    : allowOverlaps(allowOverlaps),
+      plan(ConflictMatrix::junction().phasePlan(allowOverlaps)),
+      currentPhase(-1),
+      requestedPhase(-1) {
+    std::ostringstream oss;
+    oss << "Phase plan:";
+    for (MovementMask movements : plan) {
+        oss << " [" << ConflictMatrix::describe(movements) << "]";
+    }
+    DebugLogger::log(oss.str());
+}
+
+SignalControllerType PhasedController::getType() const {
+    return allowOverlaps ? SignalControllerType::PHASED : SignalControllerType::PHASED_SINGLE;
+}
+
+void PhasedController::reset() {
+    currentPhase = -1;
+    requestedPhase = -1;
+}
+
+int PhasedController::longestQueue(const TrafficCounters& counters, MovementMask movements) {
+    int longest = 0;
+    for (int i = 0; i < RouteTable::MOVEMENT_COUNT; i++) {
+        if (movements & (1u << i)) {
+            longest = std::max(longest, counters.movementQueue(i));
+        }
+    }
+    return longest;
+}
+
+int PhasedController::servedRoads(const std::vector<Lane*>& lanes, MovementMask movements, int& roads) {
+    int served = 0;
+    roads = 0;
+    for (auto* lane : lanes) {
+        if (lane->getLaneNumber() != 2 || !(movements & ConflictMatrix::roadMovements(lane->getLaneId()))) {
+            continue;
+        }
+        roads++;
+
+        // The lane only flows while its first waiting vehicle's movement is green
+        for (auto* vehicle : lane->getVehicles()) {
+            if (!vehicle->hasPassedStopLine()) {
+                int movement = RouteTable::movementIndex(lane->getLaneId(), 2, vehicle->getDestination());
+                served += (movement >= 0 && (movements & (1u << movement))) ? 1 : 0;
+                break;
+            }
+        }
+    }
+    return served;
+}
+
+int PhasedController::nextWithDemand(const std::vector<Lane*>& lanes, int after) const {
+    const int count = static_cast<int>(plan.size());
+    for (int i = 1; i <= count; i++) {
+        int candidate = (after + i) % count;
+        if (candidate < 0) {
+            candidate += count;
+        }
+
+        // A phase spanning roads is only worth its clearance when every one of
+        // them can use it; otherwise the road phases serve the same vehicles
+        int roads = 0;
+        int served = servedRoads(lanes, plan[candidate], roads);
+        if (served > 0 && served == roads) {
+            return candidate;
+        }
+    }
+    return -1;
+}
+
+TrafficLight::State PhasedController::stateFor(int phase) const {
+    for (char road : ROADS) {
+        if (plan[phase] == ConflictMatrix::roadMovements(road)) {
+            return greenFor(road);
+        }
+    }
+    return TrafficLight::State::PHASE;
+}
+
+MovementMask PhasedController::phaseMovements() const {
+    return requestedPhase >= 0 ? plan[requestedPhase] : 0;
+}
+
+TrafficLight::State PhasedController::selectState(const SignalContext& context) {
+    if (context.current == TrafficLight::State::ALL_RED) {
+        int next = nextWithDemand(context.lanes, currentPhase);
+        if (next < 0) {
+            return TrafficLight::State::ALL_RED;
+        }
+        currentPhase = requestedPhase = next;
+        return stateFor(currentPhase);
+    }
+
+    // A green the plan did not start (emergency preemption) ends like any other
+    int roads = 0;
+    const int served = servedRoads(context.lanes, context.greenMovements, roads);
+    const int queue = longestQueue(context.counters, context.greenMovements);
+    int greenDuration = queue * context.timing.greenPerVehicle;
+    greenDuration = std::max(context.timing.minGreen, std::min(greenDuration, context.timing.maxGreen));
+
+    if (context.elapsed < static_cast<uint32_t>(context.timing.minGreen) ||
+        (served > 0 && context.elapsed < static_cast<uint32_t>(greenDuration))) {
+        return context.current;
+    }
+
+    // Only hand over when another phase has demand; otherwise rest in green
+    int next = nextWithDemand(context.lanes, currentPhase);
+    if (next < 0 || plan[next] == context.greenMovements) {
+        return context.current;
+    }
+    requestedPhase = next;
+    return stateFor(next);
+}
+
+void PhasedController::saveState(std::ostream& out) const {
+    BinaryIO::write(out, static_cast<int32_t>(currentPhase));
+}
+
+bool PhasedController::loadState(std::istream& in) {
+    int32_t savedPhase = -1;
+    if (!BinaryIO::read(in, savedPhase) || savedPhase < -1 || savedPhase >= static_cast<int32_t>(plan.size())) {
+        return false;
+    }
+    currentPhase = savedPhase;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Webster
+
+WebsterController::WebsterController() {
+    reset();
+}
+
+void WebsterController::reset() {
+    for (int i = 0; i < 4; i++) {
+        activeGreen[i] = 0;
+        pendingGreen[i] = 0;
+        saturationFlow[i] = Constants::WEBSTER_DEFAULT_SATURATION_FLOW;
+        saturatedTime[i] = 0;
+        saturatedCrossings[i] = 0;
+    }
+    planPending = false;
+    measuredRoad = ' ';
+    lastCrossings = 0;
+    lastTickTime = 0;
+    lastPlanTime = 0;
+}
+
+void WebsterController::measure(const SignalContext& context) {
+    const char road = roadOf(context.current);
+    const uint32_t crossings = road == ' ' ? 0 : context.counters.lane(road, 2).crossings;
+
+    // Only discharge from a standing queue, past the start-up loss, shows the saturation flow
+    if (road != ' ' && road == measuredRoad &&
+        context.elapsed >= static_cast<uint32_t>(Constants::WEBSTER_STARTUP_LOST_TIME) &&
+        queueAtStopLine(context.lanes, road)) {
+        saturatedTime[road - 'A'] += context.currentTime - lastTickTime;
+        saturatedCrossings[road - 'A'] += crossings - lastCrossings;
+    }
+
+    measuredRoad = road;
+    lastCrossings = crossings;
+    lastTickTime = context.currentTime;
+}
+
+bool WebsterController::queueAtStopLine(const std::vector<Lane*>& lanes, char road) {
+    for (auto* lane : lanes) {
+        if (lane->getLaneId() != road || lane->getLaneNumber() != 2) {
+            continue;
+        }
+        for (auto* vehicle : lane->getVehicles()) {
+            if (!vehicle->hasPassedStopLine()) {
+                return vehicle->getStopLineDistance() - vehicle->getPathDistance() <= Constants::WEBSTER_QUEUE_REACH;
+            }
+        }
+    }
+    return false;
+}
+
+void WebsterController::computePlan(const SignalContext& context) {
+    float flowRatio[4];
+    float totalRatio = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        if (saturatedTime[i] >= static_cast<uint32_t>(Constants::WEBSTER_MIN_SATURATED_TIME) &&
+            saturatedCrossings[i] > 0) {
+            saturationFlow[i] = saturatedCrossings[i] * 1000.0f / saturatedTime[i];
+        }
+        saturatedTime[i] = 0;
+        saturatedCrossings[i] = 0;
+
+        const float arrivalFlow = static_cast<float>(context.rates.arrivalRate(ROADS[i], 2, context.currentTime));
+        flowRatio[i] = arrivalFlow / saturationFlow[i];
+        totalRatio += flowRatio[i];
+    }
+
+    // Oversaturated demand would need an infinite cycle
+    const float cappedRatio = std::min(totalRatio, Constants::WEBSTER_MAX_FLOW_RATIO);
+    const int lostTime = 4 * (context.timing.allRed + Constants::WEBSTER_STARTUP_LOST_TIME);
+    int cycle = static_cast<int>((1.5f * lostTime + 5000.0f) / (1.0f - cappedRatio));
+    cycle = std::max(lostTime + 4 * context.timing.minGreen, std::min(cycle, context.timing.maxCycle));
+
+    // Effective greens split C - L; the displayed green adds back the start-up loss
+    const int effectiveGreen = cycle - lostTime;
+    for (int i = 0; i < 4; i++) {
+        float share = totalRatio > 0.0f ? flowRatio[i] / totalRatio : 0.25f;
+        pendingGreen[i] = std::max(context.timing.minGreen,
+                                   static_cast<int>(effectiveGreen * share) + Constants::WEBSTER_STARTUP_LOST_TIME);
+    }
+    planPending = true;
+
+    std::ostringstream oss;
+    oss << "Webster plan: Y = " << totalRatio << ", cycle " << cycle / 1000.0f << " s, greens";
+    for (int i = 0; i < 4; i++) {
+        oss << " " << ROADS[i] << "=" << pendingGreen[i] / 1000.0f << "s (s=" << saturationFlow[i] << "/s)";
+    }
+    DebugLogger::log(oss.str());
+}
+
+TrafficLight::State WebsterController::selectState(const SignalContext& context) {
+    measure(context);
+
+    // Re-plan on a timer, not every tick
+    if (context.currentTime - lastPlanTime >= static_cast<uint32_t>(context.timing.websterInterval)) {
+        computePlan(context);
+        lastPlanTime = context.currentTime;
+    }
+
+    if (context.current == TrafficLight::State::ALL_RED) {
+        TrafficLight::State next = nextInRotation(context.lastGreen);
+
+        // A new plan takes over at the cycle boundary
+        if (next == TrafficLight::State::A_GREEN && planPending) {
+            for (int i = 0; i < 4; i++) {
+                activeGreen[i] = pendingGreen[i];
+            }
+            planPending = false;
+        }
+        return next;
+    }
+
+    const int road = roadOf(context.current) - 'A';
+    const int green = activeGreen[road] > 0 ? activeGreen[road] : context.timing.fixedGreen;
+    if (context.elapsed >= static_cast<uint32_t>(green)) {
+        return nextInRotation(context.current);
+    }
+    return context.current;
+}
+
+void WebsterController::saveState(std::ostream& out) const {
+    for (int i = 0; i < 4; i++) {
+        BinaryIO::write(out, activeGreen[i]);
+        BinaryIO::write(out, pendingGreen[i]);
+        BinaryIO::write(out, saturationFlow[i]);
+        BinaryIO::write(out, saturatedTime[i]);
+        BinaryIO::write(out, saturatedCrossings[i]);
+    }
+    BinaryIO::write(out, planPending);
+    BinaryIO::write(out, measuredRoad);
+    BinaryIO::write(out, lastCrossings);
+    BinaryIO::write(out, lastTickTime);
+    BinaryIO::write(out, lastPlanTime);
+}
+
+bool WebsterController::loadState(std::istream& in) {
+    for (int i = 0; i < 4; i++) {
+        if (!BinaryIO::read(in, activeGreen[i]) || !BinaryIO::read(in, pendingGreen[i]) ||
+            !BinaryIO::read(in, saturationFlow[i]) || !BinaryIO::read(in, saturatedTime[i]) ||
+            !BinaryIO::read(in, saturatedCrossings[i]) || !(saturationFlow[i] > 0.0f)) {
+            return false;
+        }
+    }
+    return BinaryIO::readBool(in, planPending) && BinaryIO::read(in, measuredRoad) &&
+           BinaryIO::read(in, lastCrossings) && BinaryIO::read(in, lastTickTime) &&
+           BinaryIO::read(in, lastPlanTime);
+}
+
+// ---------------------------------------------------------------------------
+// Coordinated (clock-driven fixed time)
+
+uint32_t CoordinatedController::cycleLength(const SignalTiming& timing) {
+    return 4u * static_cast<uint32_t>(timing.fixedGreen + timing.allRed);
+}
+
+TrafficLight::State CoordinatedController::selectState(const SignalContext& context) {
+    const uint32_t slot = static_cast<uint32_t>(context.timing.fixedGreen + context.timing.allRed);
+    const uint32_t cycle = cycleLength(context.timing);
+    if (slot == 0) {
+        return context.current;
+    }
+
+    // Position in the cycle, which starts at the offset
+    const uint32_t offset = static_cast<uint32_t>(((context.timing.cycleOffset % static_cast<int>(cycle)) +
+                                                   static_cast<int>(cycle)) % static_cast<int>(cycle));
+    const uint32_t position = (context.currentTime % cycle + cycle - offset) % cycle;
+    const uint32_t index = position / slot;
+
+    // The green of the slot, then its all-red (the light enforces the clearance)
+    if (position % slot < static_cast<uint32_t>(context.timing.fixedGreen)) {
+        return greenFor(ROADS[index]);
+    }
+    return TrafficLight::State::ALL_RED;
+}
+
+// ---------------------------------------------------------------------------
+// Q-learning
+
+namespace {
+    int queueLevel(int queued) {
+        if (queued == 0) return 0;
+        if (queued <= 2) return 1;
+        if (queued <= 5) return 2;
+        return 3;
+    }
+}
+
+QLearningController::QLearningController()
+    : learning(false),
+      epsilon(0.0f),
+      lastState(-1),
+      lastAction(EXTEND),
+      lastDecisionTime(0),
+      decisionCrossings(0),
+      target(TrafficLight::State::ALL_RED) {
+}
+
+void QLearningController::reset() {
+    lastState = -1;
+    lastAction = EXTEND;
+    lastDecisionTime = 0;
+    decisionCrossings = 0;
+    target = TrafficLight::State::ALL_RED;
+}
+
+void QLearningController::setLearning(bool enabled, float explore, uint32_t seed) {
+    learning = enabled;
+    epsilon = explore;
+    explorer.seed(seed);
+}
+
+int QLearningController::encodeState(const SignalContext& context) {
+    const TrafficLight::State green = context.current == TrafficLight::State::ALL_RED ? context.lastGreen : context.current;
+    const int road = roadOf(green) - 'A';
+    const int longGreen = context.elapsed * 2 >= static_cast<uint32_t>(context.timing.maxGreen) ? 1 : 0;
+
+    int state = road * QTable::GREEN_LEVELS + longGreen;
+    for (char queueRoad : ROADS) {
+        state = state * QTable::QUEUE_LEVELS + queueLevel(queuedVehicles(context.counters, queueRoad));
+    }
+    return state;
+}
+
+TrafficLight::State QLearningController::apply(int action, const SignalContext& context) const {
+    if (action == EXTEND) {
+        return context.current;
+    }
+
+    if (action == PREEMPT) {
+        char longest = ' ';
+        int longestQueue = 0;
+        for (char road : ROADS) {
+            const int queued = queuedVehicles(context.counters, road);
+            if (road != roadOf(context.current) && queued > longestQueue) {
+                longest = road;
+                longestQueue = queued;
+            }
+        }
+        if (longest != ' ') {
+            return greenFor(longest);
+        }
+    }
+
+    // Next road in rotation with someone waiting (plain rotation when nobody is)
+    TrafficLight::State candidate = context.current;
+    for (int i = 0; i < 3; i++) {
+        candidate = nextInRotation(candidate);
+        if (queuedVehicles(context.counters, roadOf(candidate)) > 0) {
+            return candidate;
+        }
+    }
+    return nextInRotation(context.current);
+}
+
+TrafficLight::State QLearningController::selectState(const SignalContext& context) {
+    if (context.current == TrafficLight::State::ALL_RED) {
+        return target != TrafficLight::State::ALL_RED ? target : nextInRotation(context.lastGreen);
+    }
+    if (context.current != target) {
+        // A green the controller did not ask for (start-up, preemption): decide afresh
+        target = context.current;
+        lastDecisionTime = context.currentTime - context.elapsed;
+    }
+
+    if (context.elapsed < static_cast<uint32_t>(context.timing.minGreen) ||
+        context.currentTime - lastDecisionTime < static_cast<uint32_t>(Constants::QLEARNING_DECISION_INTERVAL)) {
+        return context.current;
+    }
+
+    QTable& table = QTable::policy();
+    const int state = encodeState(context);
+    uint32_t crossings = 0;
+    for (char road : ROADS) {
+        crossings += context.counters.lane(road, 2).crossings;
+    }
+
+    if (learning && lastState >= 0) {
+        // Semi-Markov step: discount by the number of decision intervals that passed
+        const double intervals = static_cast<double>(context.currentTime - lastDecisionTime) /
+                                 Constants::QLEARNING_DECISION_INTERVAL;
+        const float reward = static_cast<float>(crossings - decisionCrossings);
+        const float discount = static_cast<float>(std::pow(Constants::QLEARNING_DISCOUNT, intervals));
+        table.update(lastState, lastAction, reward + discount * table.maxValue(state),
+                     Constants::QLEARNING_LEARNING_RATE);
+    }
+
+    int action = table.bestAction(state);
+    if (learning && std::uniform_real_distribution<float>(0.0f, 1.0f)(explorer) < epsilon) {
+        action = std::uniform_int_distribution<int>(0, QTable::ACTION_COUNT - 1)(explorer);
+    } else if (action < 0) {
+        action = context.elapsed >= static_cast<uint32_t>(context.timing.fixedGreen) ? SWITCH : EXTEND;
+    }
+    if (action == EXTEND && context.elapsed >= static_cast<uint32_t>(context.timing.maxGreen)) {
+        action = SWITCH;
+    }
+
+    lastState = state;
+    lastAction = action;
+    lastDecisionTime = context.currentTime;
+    decisionCrossings = crossings;
+    target = apply(action, context);
+    return target;
+}
+
+void QLearningController::saveState(std::ostream& out) const {
+    BinaryIO::write(out, lastState);
+    BinaryIO::write(out, lastAction);
+    BinaryIO::write(out, lastDecisionTime);
+    BinaryIO::write(out, decisionCrossings);
+    BinaryIO::writeEnum(out, target);
+}
+
+bool QLearningController::loadState(std::istream& in) {
+    // The state and action index the Q-table
+    return BinaryIO::read(in, lastState) && BinaryIO::read(in, lastAction) &&
+           lastState >= -1 && lastState < QTable::STATE_COUNT &&
+           lastAction >= 0 && lastAction < QTable::ACTION_COUNT &&
+           BinaryIO::read(in, lastDecisionTime) && BinaryIO::read(in, decisionCrossings) &&
+           BinaryIO::readEnum(in, target, TrafficLight::State::PHASE);
+}
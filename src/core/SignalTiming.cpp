@@ -0,0 +1,87 @@
+// FILE: src/core/SignalTiming.cpp
+#include "core/SignalTiming.h"
+#include "utils/DebugLogger.h"
+#include <fstream>
+#include <sstream>
+
+namespace {
+    struct TimingField {
+        const char* key;
+        int SignalTiming::* value;
+    };
+
+    const TimingField TIMING_FIELDS[] = {
+        {"priority_high", &SignalTiming::priorityThresholdHigh},
+        {"priority_low", &SignalTiming::priorityThresholdLow},
+        {"min_green", &SignalTiming::minGreen},
+        {"max_green", &SignalTiming::maxGreen},
+        {"green_per_vehicle", &SignalTiming::greenPerVehicle},
+        {"all_red", &SignalTiming::allRed},
+        {"priority_green", &SignalTiming::priorityGreen},
+        {"fixed_green", &SignalTiming::fixedGreen},
+        {"actuated_gap", &SignalTiming::actuatedGap},
+        {"prediction_horizon", &SignalTiming::predictionHorizon},
+        {"webster_interval", &SignalTiming::websterInterval},
+        {"max_cycle", &SignalTiming::maxCycle},
+        {"cycle_offset", &SignalTiming::cycleOffset}
+    };
+}
+
+bool loadSignalTiming(const std::string& path, SignalTiming& timing) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        DebugLogger::log("Could not open timing file " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    SignalTiming loaded = timing;
+    std::string text;
+    int lineNumber = 0;
+    while (std::getline(file, text)) {
+        lineNumber++;
+        text = text.substr(0, text.find('#'));
+
+        std::istringstream ss(text);
+        std::string key;
+        if (!(ss >> key)) {
+            continue;
+        }
+
+        const TimingField* field = nullptr;
+        for (const auto& candidate : TIMING_FIELDS) {
+            if (key == candidate.key) {
+                field = &candidate;
+            }
+        }
+
+        int value = 0;
+        if (!field || !(ss >> value)) {
+            std::ostringstream oss;
+            oss << path << ":" << lineNumber << ": invalid timing entry \"" << text << "\"";
+            DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
+            return false;
+        }
+        loaded.*(field->value) = value;
+    }
+
+    timing = loaded;
+    return true;
+}
+
+bool saveSignalTiming(const std::string& path, const SignalTiming& timing) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        DebugLogger::log("Could not write timing file " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    file << "# Signal timing (durations in ms)\n";
+    writeSignalTiming(file, timing);
+    return static_cast<bool>(file);
+}
+
+void writeSignalTiming(std::ostream& out, const SignalTiming& timing) {
+    for (const auto& field : TIMING_FIELDS) {
+        out << field.key << " " << timing.*(field.value) << "\n";
+    }
+}
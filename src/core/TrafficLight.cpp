@@ -1,6 +1,9 @@
 // FILE: src/core/TrafficLight.cpp
 #include "core/TrafficLight.h"
+#include "core/SignalController.h"
 #include "utils/DebugLogger.h"
+#include "utils/BinaryIO.h"
+#include "utils/TraceRecorder.h"
 #include <sstream>
 #include <cmath>
 #include <SDL3/SDL.h>
@@ -9,194 +12,213 @@
 TrafficLight::TrafficLight()
     : currentState(State::ALL_RED),
       nextState(State::A_GREEN),
-      lastStateChangeTime(SDL_GetTicks()),
-      isPriorityMode(false),
-      shouldResumeNormalMode(false),
-      forceAGreen(false),
-      priorityModeStartTime(0) {
+      lastStateChangeTime(0),
+      lastGreenState(State::D_GREEN),
+      greenMovements(0),
+      controller(new QueueAverageController()),
+      preemptRoad(' '),
+      resumeLastGreen(State::D_GREEN) {
 
     DebugLogger::log("TrafficLight initialized");
 }
 
 TrafficLight::~TrafficLight() {
+    delete controller;
     DebugLogger::log("TrafficLight destroyed");
 }
 
-void TrafficLight::update(const std::vector<Lane*>& lanes) {
-    uint32_t currentTime = SDL_GetTicks();
-    uint32_t elapsedTime = currentTime - lastStateChangeTime;
-
-    // CRITICAL: Find priority lane A2 directly
-    Lane* al2Lane = nullptr;
-    for (auto* lane : lanes) {
-        if (lane->getLaneId() == 'A' && lane->getLaneNumber() == 2) {
-            al2Lane = lane;
-            break;
+namespace {
+    const char* stateName(TrafficLight::State state) {
+        switch (state) {
+            case TrafficLight::State::ALL_RED: return "ALL_RED";
+            case TrafficLight::State::A_GREEN: return "A_GREEN";
+            case TrafficLight::State::B_GREEN: return "B_GREEN";
+            case TrafficLight::State::C_GREEN: return "C_GREEN";
+            case TrafficLight::State::D_GREEN: return "D_GREEN";
+            case TrafficLight::State::PHASE: return "PHASE";
         }
+        return "UNKNOWN";
     }
 
-    // CRITICAL FIX: Direct priority detection and override
-    if (al2Lane) {
-        int vehicleCount = al2Lane->getVehicleCount();
-
-        // CRITICAL: Force immediate transition to A_GREEN when vehicle count exceeds threshold
-        if (vehicleCount > Constants::PRIORITY_THRESHOLD_HIGH) {
-            if (!isPriorityMode) {
-                isPriorityMode = true;
-                forceAGreen = true;
-                priorityModeStartTime = currentTime;
-
-                std::ostringstream oss;
-                oss << "!!! PRIORITY MODE ACTIVATED: A2 has " << vehicleCount << " vehicles (>10)";
-                DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
-
-                // Force immediate transition to A_GREEN
-                if (currentState != State::A_GREEN) {
-                    // If not in ALL_RED, go to ALL_RED first
-                    if (currentState != State::ALL_RED) {
-                        currentState = State::ALL_RED;
-                        nextState = State::A_GREEN;
-                        lastStateChangeTime = currentTime;
-                    } else {
-                        // If already in ALL_RED, go directly to A_GREEN
-                        currentState = State::A_GREEN;
-                        nextState = State::ALL_RED;
-                        lastStateChangeTime = currentTime;
-                    }
-                }
-            }
-        }
-        // Exit priority mode when count drops below threshold
-        else if (isPriorityMode && vehicleCount < Constants::PRIORITY_THRESHOLD_LOW) {
-            isPriorityMode = false;
-            forceAGreen = false;
-
-            std::ostringstream oss;
-            oss << "!!! PRIORITY MODE DEACTIVATED: A2 now has " << vehicleCount << " vehicles (<5)";
-            DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
-        }
+    bool isRoadGreen(TrafficLight::State state) {
+        return state != TrafficLight::State::ALL_RED && state != TrafficLight::State::PHASE;
+    }
 
-        // CRITICAL: Force-log the priority state for debugging
-        if (isPriorityMode && currentTime - priorityModeStartTime > 5000) {
-            std::ostringstream oss;
-            oss << "Priority mode active: A2 has " << vehicleCount << " vehicles, light state: "
-                << (currentState == State::A_GREEN ? "A_GREEN" :
-                   (currentState == State::ALL_RED ? "ALL_RED" : "OTHER"));
-            DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
-            priorityModeStartTime = currentTime;
-        }
+    char roadOf(TrafficLight::State state) {
+        return isRoadGreen(state) ? static_cast<char>('A' + static_cast<int>(state) - 1) : ' ';
     }
 
-    // CRITICAL FIX: If in priority mode, force the light to stay on A_GREEN longer
-    if (isPriorityMode && forceAGreen) {
-        if (currentState != State::A_GREEN) {
-            if (elapsedTime >= allRedDuration) {
-                // After ALL_RED, go back to A_GREEN in priority mode
-                currentState = State::A_GREEN;
-                nextState = State::ALL_RED;
-                lastStateChangeTime = currentTime;
+    TrafficLight::State greenFor(char road) {
+        return static_cast<TrafficLight::State>(road - 'A' + 1);
+    }
 
-                DebugLogger::log("PRIORITY MODE: Forcing A_GREEN", DebugLogger::LogLevel::ERROR);
-            }
-        } else {
-            // Extend the green duration in priority mode
-            int priorityGreenDuration = 6000; // 6 seconds of green in priority mode
+    // Rotation order A -> B -> C -> D -> A, one step back
+    TrafficLight::State previousGreen(TrafficLight::State state) {
+        return state == TrafficLight::State::A_GREEN ? TrafficLight::State::D_GREEN :
+               static_cast<TrafficLight::State>(static_cast<int>(state) - 1);
+    }
+}
 
-            if (elapsedTime >= priorityGreenDuration) {
-                // Go to ALL_RED briefly before returning to A_GREEN
-                currentState = State::ALL_RED;
-                nextState = State::A_GREEN;
-                lastStateChangeTime = currentTime;
+void TrafficLight::update(const std::vector<Lane*>& lanes, const TrafficCounters& counters, const TrafficRates& rates,
+                          uint32_t currentTime) {
+    uint32_t elapsedTime = currentTime - lastStateChangeTime;
 
-                DebugLogger::log("PRIORITY MODE: Brief ALL_RED before returning to A_GREEN");
-            }
-        }
+    // Every green is preceded by a full all-red clearance
+    if (currentState == State::ALL_RED && elapsedTime < static_cast<uint32_t>(timing.allRed)) {
+        return;
+    }
 
-        return; // Skip normal light cycling in priority mode
+    if (updatePreemption(counters, currentTime)) {
+        return;
     }
 
-    // NORMAL MODE - Calculate appropriate duration
-    int stateDuration;
+    SignalContext context = {lanes, counters, rates, currentTime, elapsedTime, currentState, lastGreenState,
+                             greenMovements, timing};
+    State requested = controller->selectState(context);
+    MovementMask movements = requested == State::PHASE ? controller->phaseMovements() :
+                             ConflictMatrix::roadMovements(roadOf(requested));
+    if (requested != currentState || movements != greenMovements) {
+        changeState(requested, movements, currentTime);
+    }
+}
+
+void TrafficLight::changeState(State requested, MovementMask movements, uint32_t currentTime) {
     if (currentState == State::ALL_RED) {
-        stateDuration = allRedDuration; // 2 seconds for ALL_RED
+        // Clearance over: start the requested green
+        currentState = requested;
+        greenMovements = movements;
+        if (isRoadGreen(requested)) {
+            lastGreenState = requested;
+        }
+        nextState = State::ALL_RED;
     } else {
-        // Calculate average using lane counts
-        float averageVehicleCount = calculateAverageVehicleCount(lanes);
-
-        // Set duration using formula: Total time = |V| * t (2 seconds per vehicle)
-        stateDuration = static_cast<int>(averageVehicleCount * 2000);
-
-        // Apply minimum and maximum limits for reasonable times
-        if (stateDuration < 3000) stateDuration = 3000; // Min 3 seconds
-        if (stateDuration > 15000) stateDuration = 15000; // Max 15 seconds
-
-        // Log the calculation
-        std::ostringstream oss;
-        oss << "Traffic light timing: |V| = " << averageVehicleCount
-            << ", Duration = " << stateDuration / 1000.0f << " seconds";
-        DebugLogger::log(oss.str());
-    }
-
-    // State transition in normal mode
-    if (elapsedTime >= stateDuration) {
-        // Change to next state
-        currentState = nextState;
-
-        // Log the state change clearly
-        std::string stateStr;
-        switch (currentState) {
-            case State::ALL_RED: stateStr = "ALL_RED"; break;
-            case State::A_GREEN: stateStr = "A_GREEN"; break;
-            case State::B_GREEN: stateStr = "B_GREEN"; break;
-            case State::C_GREEN: stateStr = "C_GREEN"; break;
-            case State::D_GREEN: stateStr = "D_GREEN"; break;
+        // Leaving a green always goes through ALL_RED first
+        currentState = State::ALL_RED;
+        greenMovements = 0;
+        nextState = requested;
+    }
+    lastStateChangeTime = currentTime;
+    TraceRecorder::instant(stateName(currentState), "light");
+
+    std::string name = stateName(currentState);
+    if (currentState == State::PHASE) {
+        name += " (" + ConflictMatrix::describe(greenMovements) + ")";
+    }
+    DebugLogger::log("Traffic light changed to: " + name);
+}
+
+bool TrafficLight::updatePreemption(const TrafficCounters& counters, uint32_t currentTime) {
+    if (preemptRoad != ' ' && counters.lane(preemptRoad, 2).emergenciesQueued <= 0) {
+        // Emergency vehicles through: resume the rotation where it was interrupted
+        DebugLogger::log(std::string("Emergency preemption of road ") + preemptRoad + " ended",
+                         DebugLogger::LogLevel::WARNING);
+        preemptRoad = ' ';
+        lastGreenState = resumeLastGreen;
+        if (currentState != State::ALL_RED) {
+            changeState(State::ALL_RED, 0, currentTime);
+            return true;
         }
+    }
 
-        DebugLogger::log("Traffic light changed to: " + stateStr);
-
-        // Normal rotation pattern: ALL_RED → A → ALL_RED → B → ALL_RED → C → ALL_RED → D → ...
-        if (currentState == State::ALL_RED) {
-            // Cycle through green states
-            switch (nextState) {
-                case State::A_GREEN: nextState = State::B_GREEN; break;
-                case State::B_GREEN: nextState = State::C_GREEN; break;
-                case State::C_GREEN: nextState = State::D_GREEN; break;
-                case State::D_GREEN: nextState = State::A_GREEN; break;
-                default: nextState = State::A_GREEN; break;
+    if (preemptRoad == ' ') {
+        // First road in rotation order with an emergency vehicle waiting
+        State candidate = isRoadGreen(currentState) ? currentState : lastGreenState;
+        for (int i = 0; i < 4 && preemptRoad == ' '; i++) {
+            candidate = candidate == State::D_GREEN ? State::A_GREEN : static_cast<State>(static_cast<int>(candidate) + 1);
+            if (counters.lane(roadOf(candidate), 2).emergenciesQueued > 0) {
+                preemptRoad = roadOf(candidate);
             }
-        } else {
-            // Always go to ALL_RED after any green state
-            nextState = State::ALL_RED;
         }
+        if (preemptRoad == ' ') {
+            return false;
+        }
+
+        // An interrupted green is served again first
+        resumeLastGreen = isRoadGreen(currentState) ? previousGreen(currentState) : lastGreenState;
+        DebugLogger::log(std::string("Emergency vehicle waiting on road ") + preemptRoad + " - preempting",
+                         DebugLogger::LogLevel::WARNING);
+    }
 
-        lastStateChangeTime = currentTime;
+    const State target = greenFor(preemptRoad);
+    if (currentState != target) {
+        changeState(target, ConflictMatrix::roadMovements(preemptRoad), currentTime);
     }
+    return true;
 }
 
-float TrafficLight::calculateAverageVehicleCount(const std::vector<Lane*>& lanes) {
-    int normalLaneCount = 0;
-    int totalVehicleCount = 0;
-
-    for (auto* lane : lanes) {
-        // Only count lane 2 (normal lanes)
-        // In priority mode, exclude the priority lane (A2) from calculation
-        if (lane->getLaneNumber() == 2 &&
-            !(isPriorityMode && lane->getLaneId() == 'A')) {
-            normalLaneCount++;
-            totalVehicleCount += lane->getVehicleCount();
-        }
+void TrafficLight::setTiming(const SignalTiming& newTiming) {
+    timing = newTiming;
+}
+
+void TrafficLight::setController(SignalController* newController) {
+    if (!newController || newController == controller) {
+        return;
     }
 
-    // Calculate average: |V| = (1/n) * Σ|Li|
-    float average = (normalLaneCount > 0) ?
-        static_cast<float>(totalVehicleCount) / normalLaneCount : 0.0f;
+    delete controller;
+    controller = newController;
+    DebugLogger::log(std::string("Signal controller: ") + signalControllerName(controller->getType()));
+}
 
-    // Return at least 1 to ensure some duration
-    return std::max(1.0f, average);
+void TrafficLight::reset() {
+    currentState = State::ALL_RED;
+    nextState = State::A_GREEN;
+    lastStateChangeTime = 0;
+    lastGreenState = State::D_GREEN;
+    greenMovements = 0;
+    preemptRoad = ' ';
+    resumeLastGreen = State::D_GREEN;
+    controller->reset();
 }
 
-void TrafficLight::setNextState(State state) {
-    nextState = state;
+void TrafficLight::saveState(std::ostream& out) const {
+    BinaryIO::writeEnum(out, currentState);
+    BinaryIO::writeEnum(out, nextState);
+    BinaryIO::write(out, lastStateChangeTime);
+    BinaryIO::writeEnum(out, lastGreenState);
+    BinaryIO::write(out, greenMovements);
+    BinaryIO::write(out, preemptRoad);
+    BinaryIO::writeEnum(out, resumeLastGreen);
+    BinaryIO::writeEnum(out, controller->getType());
+    controller->saveState(out);
+}
+
+bool TrafficLight::loadState(std::istream& in) {
+    State savedCurrent = State::ALL_RED;
+    State savedNext = State::A_GREEN;
+    State savedLastGreen = State::D_GREEN;
+    char savedPreemptRoad = ' ';
+    State savedResume = State::D_GREEN;
+    MovementMask savedMovements = 0;
+    SignalControllerType savedType = SignalControllerType::QUEUE_AVERAGE;
+    uint32_t savedChangeTime = 0;
+    if (!BinaryIO::readEnum(in, savedCurrent, State::PHASE) || !BinaryIO::readEnum(in, savedNext, State::PHASE) ||
+        !BinaryIO::read(in, savedChangeTime) || !BinaryIO::readEnum(in, savedLastGreen, State::D_GREEN) ||
+        !BinaryIO::read(in, savedMovements) || !BinaryIO::read(in, savedPreemptRoad) ||
+        !BinaryIO::readEnum(in, savedResume, State::D_GREEN) ||
+        !BinaryIO::readEnum(in, savedType, SignalControllerType::QLEARNING) ||
+        (savedPreemptRoad != ' ' && (savedPreemptRoad < 'A' || savedPreemptRoad > 'D'))) {
+        return false;
+    }
+
+    // The snapshot decides the policy
+    if (savedType != controller->getType()) {
+        setController(SignalController::create(savedType));
+    }
+
+    controller->reset();
+    if (!controller->loadState(in)) {
+        return false;
+    }
+
+    currentState = savedCurrent;
+    nextState = savedNext;
+    lastStateChangeTime = savedChangeTime;
+    lastGreenState = savedLastGreen;
+    greenMovements = savedMovements;
+    preemptRoad = savedPreemptRoad;
+    resumeLastGreen = savedResume;
+    return true;
 }
 
 bool TrafficLight::isGreen(char lane) const {
@@ -206,11 +228,16 @@ bool TrafficLight::isGreen(char lane) const {
         case State::B_GREEN: return lane == 'B';
         case State::C_GREEN: return lane == 'C';
         case State::D_GREEN: return lane == 'D';
+        case State::PHASE: return (greenMovements & ConflictMatrix::roadMovements(lane)) != 0;
         case State::ALL_RED: return false;
         default: return false;
     }
 }
 
+bool TrafficLight::isPriorityActive() const {
+    return controller && controller->isPriorityActive();
+}
+
 void TrafficLight::render(SDL_Renderer* renderer) {
     const int windowWidth = 800;
     const int windowHeight = 800;
@@ -265,6 +292,19 @@ void TrafficLight::render(SDL_Renderer* renderer) {
             SDL_RenderFillRect(renderer, &topRightLight);
             SDL_RenderFillRect(renderer, &bottomLeftLight);
             break;
+        case State::PHASE: {
+            // Every road with a released movement shows green
+            const SDL_FRect* roadLights[] = {&topLeftLight, &topRightLight, &bottomLeftLight, &bottomRightLight};
+            for (int i = 0; i < 4; i++) {
+                if (isGreen(static_cast<char>('A' + i))) {
+                    SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255); // Green
+                } else {
+                    SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255); // Red
+                }
+                SDL_RenderFillRect(renderer, roadLights[i]);
+            }
+            break;
+        }
     }
 
     // Draw traffic light control box in the corner
@@ -366,7 +406,7 @@ void TrafficLight::render(SDL_Renderer* renderer) {
                           LIGHT_SIZE, LABEL_HEIGHT, 'D', isDRed);
 
     // Draw priority mode indicator if active
-    if (isPriorityMode) {
+    if (controller->isPriorityActive()) {
         // Flash the indicator
         uint32_t time = SDL_GetTicks();
         bool flash = (time / 500) % 2 == 0;
@@ -396,6 +436,28 @@ void TrafficLight::render(SDL_Renderer* renderer) {
         SDL_RenderLine(renderer, boxX + boxWidth + 35, boxY + 30, boxX + boxWidth + 35, boxY + 40);
     }
 
+    // Draw emergency preemption indicator below it
+    if (preemptRoad != ' ') {
+        uint32_t time = SDL_GetTicks();
+        bool flash = (time / 250) % 2 == 0;
+
+        SDL_SetRenderDrawColor(renderer, flash ? 255 : 180, 0, 0, 255);
+        SDL_FRect emergencyBox = {
+            static_cast<float>(boxX + boxWidth + 10),
+            static_cast<float>(boxY + 60),
+            50.0f,
+            50.0f
+        };
+        SDL_RenderFillRect(renderer, &emergencyBox);
+
+        // Draw "E" for emergency
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        SDL_RenderLine(renderer, boxX + boxWidth + 25, boxY + 70, boxX + boxWidth + 25, boxY + 100);
+        SDL_RenderLine(renderer, boxX + boxWidth + 25, boxY + 70, boxX + boxWidth + 45, boxY + 70);
+        SDL_RenderLine(renderer, boxX + boxWidth + 25, boxY + 85, boxX + boxWidth + 40, boxY + 85);
+        SDL_RenderLine(renderer, boxX + boxWidth + 25, boxY + 100, boxX + boxWidth + 45, boxY + 100);
+    }
+
     // Draw the individual traffic lights at road positions
     drawLightForA(renderer, !isGreen('A'));
     drawLightForB(renderer, !isGreen('B'));
@@ -2,6 +2,8 @@
 #include "core/Vehicle.h"
 #include "core/Constants.h"
 #include "utils/DebugLogger.h"
+#include "utils/BinaryIO.h"
+#include <chrono>
 #include <cmath>
 #include <sstream>
 #include <random> // Add this for random number generation
@@ -11,7 +13,16 @@ Vehicle::Vehicle(const std::string& id, char lane, int laneNumber, bool isEmerge
       lane(lane),
       laneNumber(laneNumber),
       isEmergency(isEmergency),
-      arrivalTime(time(nullptr)),
+      generatedTime(0),
+      ingestedTime(wallClockMs()),
+      queueEntryTime(0),
+      seenGreen(false),
+      firstGreenTime(0),
+      stopLineTime(0),
+      exitTime(0),
+      stops(0),
+      haltedTime(0),
+      halted(false),
       animPos(0.0f),
       turning(false),
       turnProgress(0.0f),
@@ -23,6 +34,8 @@ Vehicle::Vehicle(const std::string& id, char lane, int laneNumber, bool isEmerge
       state(VehicleState::APPROACHING),
       currentWaypoint(0) {
 
+    MemoryAccounting::allocated(MemoryTag::VEHICLE_IDS, MemoryAccounting::stringHeapBytes(this->id));
+
     // Log creation
     std::ostringstream oss;
     oss << "Created vehicle " << id << " in lane " << lane << laneNumber;
@@ -170,6 +183,8 @@ Vehicle::Vehicle(const std::string& id, char lane, int laneNumber, bool isEmerge
 }
 
 Vehicle::~Vehicle() {
+    MemoryAccounting::released(MemoryTag::VEHICLE_IDS, MemoryAccounting::stringHeapBytes(id));
+
     std::ostringstream oss;
     oss << "Destroyed vehicle " << id;
     DebugLogger::log(oss.str());
@@ -186,7 +201,7 @@ void Vehicle::initializeWaypoints() {
     waypoints.clear();
 
     // Adjust intersection boundaries
-    const float intersectionHalf = 70.0f; // Intersection size
+    const float intersectionHalf = Constants::INTERSECTION_HALF_SIZE; // Intersection size
     const float leftEdge = centerX - intersectionHalf;
     const float rightEdge = centerX + intersectionHalf;
     const float topEdge = centerY - intersectionHalf;
@@ -468,8 +483,16 @@ bool Vehicle::isEmergencyVehicle() const {
     return isEmergency;
 }
 
-time_t Vehicle::getArrivalTime() const {
-    return arrivalTime;
+int64_t Vehicle::wallClockMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void Vehicle::markGreen(uint32_t time) {
+    if (!seenGreen) {
+        seenGreen = true;
+        firstGreenTime = time;
+    }
 }
 
 float Vehicle::getAnimationPos() const {
@@ -536,39 +559,355 @@ Destination Vehicle::getDestination() const {
     return destination;
 }
 
+Point Vehicle::getStopLinePoint() const {
+    // Waypoint 1 is always the approach point just outside the junction box
+    if (waypoints.size() > 1) {
+        return waypoints[1];
+    }
+    return {turnPosX, turnPosY};
+}
+
+void Vehicle::saveState(std::ostream& out) const {
+    BinaryIO::writeString(out, id);
+    BinaryIO::write(out, lane);
+    BinaryIO::write(out, static_cast<int32_t>(laneNumber));
+    BinaryIO::write(out, isEmergency);
+    BinaryIO::write(out, generatedTime);
+    BinaryIO::write(out, ingestedTime);
+    BinaryIO::write(out, queueEntryTime);
+    BinaryIO::write(out, seenGreen);
+    BinaryIO::write(out, firstGreenTime);
+    BinaryIO::write(out, stopLineTime);
+    BinaryIO::write(out, exitTime);
+    BinaryIO::write(out, static_cast<int32_t>(stops));
+    BinaryIO::write(out, haltedTime);
+    BinaryIO::write(out, halted);
+
+    BinaryIO::write(out, animPos);
+    BinaryIO::write(out, turning);
+    BinaryIO::write(out, turnProgress);
+    BinaryIO::write(out, turnPosX);
+    BinaryIO::write(out, turnPosY);
+    BinaryIO::write(out, static_cast<int32_t>(queuePos));
+
+    BinaryIO::writeEnum(out, destination);
+    BinaryIO::writeEnum(out, currentDirection);
+    BinaryIO::writeEnum(out, state);
+
+    // Waypoints are stored as-is so the restored path is exactly the saved one
+    BinaryIO::write(out, static_cast<uint32_t>(waypoints.size()));
+    for (const auto& point : waypoints) {
+        BinaryIO::write(out, point);
+    }
+    BinaryIO::write(out, static_cast<uint32_t>(currentWaypoint));
+}
+
+Vehicle* Vehicle::loadState(std::istream& in) {
+    std::string vehicleId;
+    char laneId = 0;
+    int32_t laneNum = 0;
+    bool emergency = false;
+    if (!BinaryIO::readString(in, vehicleId, 256) || !BinaryIO::read(in, laneId) ||
+        !BinaryIO::read(in, laneNum) || !BinaryIO::readBool(in, emergency) ||
+        laneId < 'A' || laneId > 'D' || laneNum < 1 || laneNum > 3) {
+        return nullptr;
+    }
+
+    Vehicle* vehicle = new Vehicle(vehicleId, laneId, laneNum, emergency);
+
+    int32_t savedQueuePos = 0;
+    int32_t savedStops = 0;
+    uint32_t waypointCount = 0;
+    bool ok = BinaryIO::read(in, vehicle->generatedTime) &&
+              BinaryIO::read(in, vehicle->ingestedTime) &&
+              BinaryIO::read(in, vehicle->queueEntryTime) &&
+              BinaryIO::readBool(in, vehicle->seenGreen) &&
+              BinaryIO::read(in, vehicle->firstGreenTime) &&
+              BinaryIO::read(in, vehicle->stopLineTime) &&
+              BinaryIO::read(in, vehicle->exitTime) &&
+              BinaryIO::read(in, savedStops) &&
+              BinaryIO::read(in, vehicle->haltedTime) &&
+              BinaryIO::readBool(in, vehicle->halted) &&
+              BinaryIO::read(in, vehicle->animPos) &&
+              BinaryIO::readBool(in, vehicle->turning) &&
+              BinaryIO::read(in, vehicle->turnProgress) &&
+              BinaryIO::read(in, vehicle->turnPosX) &&
+              BinaryIO::read(in, vehicle->turnPosY) &&
+              BinaryIO::read(in, savedQueuePos) &&
+              BinaryIO::readEnum(in, vehicle->destination, Destination::RIGHT) &&
+              BinaryIO::readEnum(in, vehicle->currentDirection, Direction::RIGHT) &&
+              BinaryIO::readEnum(in, vehicle->state, VehicleState::EXITED) &&
+              BinaryIO::read(in, waypointCount) &&
+              waypointCount > 0 && waypointCount <= 64;
+
+    if (ok) {
+        vehicle->waypoints.resize(waypointCount);
+        for (auto& point : vehicle->waypoints) {
+            ok = ok && BinaryIO::read(in, point);
+        }
+
+        uint32_t waypointIndex = 0;
+        ok = ok && BinaryIO::read(in, waypointIndex) && waypointIndex < waypointCount;
+        vehicle->currentWaypoint = waypointIndex;
+    }
+
+    if (!ok) {
+        DebugLogger::log("Invalid vehicle record for " + vehicleId + " in snapshot", DebugLogger::LogLevel::ERROR);
+        delete vehicle;
+        return nullptr;
+    }
+
+    vehicle->queuePos = savedQueuePos;
+    vehicle->stops = savedStops;
+    return vehicle;
+}
+
 float Vehicle::easeInOutQuad(float t) const {
     return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
 }
 
-void Vehicle::update(uint32_t delta, bool isGreenLight, float targetPos) {
-    // CRITICAL FIX: Free lane vehicles (L3) can ALWAYS move regardless of traffic light
-    bool canMove = isGreenLight;
+void Vehicle::onWaypointReached() {
+    // Log progress through waypoints for debugging
+    if (laneNumber == 3 || (lane == 'A' && laneNumber == 2)) {
+        DebugLogger::log("Vehicle " + id + " on " + lane + std::to_string(laneNumber) +
+                     " reached waypoint " + std::to_string(currentWaypoint) +
+                     " of " + std::to_string(waypoints.size()),
+                     DebugLogger::LogLevel::DEBUG);
+    }
+
+    // For L3 (always turns left) and L2 (turns left if specified)
+    if ((laneNumber == 3) ||
+        (laneNumber == 2 && destination == Destination::LEFT)) {
+
+        // When entering turning points (varies by direction)
+        if (currentWaypoint == 2) {
+            turning = true;
+            turnProgress = 0.0f;
+            state = VehicleState::IN_INTERSECTION;
+
+            // Log turn start
+            std::ostringstream oss;
+            oss << "Vehicle " << id << " on " << lane << laneNumber << " is now turning LEFT";
+            DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
+        }
+    }
+
+    // Determine when a vehicle has exited the intersection
+    bool isExiting = false;
 
-    // L3 is free lane - ALWAYS allowed to move
     if (laneNumber == 3) {
-        canMove = true;
-
-        // Debug log for free lane
-        static uint32_t lastLogTime = 0;
-        uint32_t currentTime = SDL_GetTicks();
-        if (currentTime - lastLogTime > 3000) {
-DebugLogger::log("FREE LANE (" + std::string(1, lane) + "3): Vehicle " + id + " moving freely",
-               DebugLogger::LogLevel::ERROR);
-            lastLogTime = currentTime;
+        // L3 vehicles typically reach exit point at waypoint 3
+        isExiting = (currentWaypoint == 3);
+    } else if (laneNumber == 2) {
+        if (destination == Destination::LEFT) {
+            // L2 turning left typically reaches exit at waypoint 3
+            isExiting = (currentWaypoint == 3);
+        } else {
+            // L2 going straight typically reaches exit at waypoint 2
+            isExiting = (currentWaypoint == 2);
+        }
+    }
+
+    // Update vehicle state when exiting
+    if (isExiting) {
+        turning = false;
+        state = VehicleState::EXITING;
+
+        // CRITICAL: Ensure the lane assignments strictly follow the rules
+        std::string newLaneStr;
+        switch (currentDirection) {
+            case Direction::DOWN:  // From North (A)
+                if (laneNumber == 3) {
+                    // AL3 → BL1
+                    lane = 'B';
+                    laneNumber = 1;
+                    currentDirection = Direction::LEFT;
+                    newLaneStr = "B1 (turned LEFT from A3)";
+                }
+                else if (destination == Destination::LEFT) {
+                    // AL2(left) → DL1
+                    lane = 'D';
+                    laneNumber = 1;
+                    currentDirection = Direction::RIGHT;
+                    newLaneStr = "D1 (turned LEFT from A2)";
+                }
+                else {
+                    // AL2(straight) → CL1
+                    lane = 'C';
+                    laneNumber = 1;
+                    currentDirection = Direction::UP;
+                    newLaneStr = "C1 (going STRAIGHT from A2)";
+                }
+                break;
+
+            case Direction::UP:    // From South (C)
+                if (laneNumber == 3) {
+                    // CL3 → DL1
+                    lane = 'D';
+                    laneNumber = 1;
+                    currentDirection = Direction::RIGHT;
+                    newLaneStr = "D1 (turned LEFT from C3)";
+                }
+                else if (destination == Destination::LEFT) {
+                    // CL2(left) → BL1
+                    lane = 'B';
+                    laneNumber = 1;
+                    currentDirection = Direction::LEFT;
+                    newLaneStr = "B1 (turned LEFT from C2)";
+                }
+                else {
+                    // CL2(straight) → AL1
+                    lane = 'A';
+                    laneNumber = 1;
+                    currentDirection = Direction::DOWN;
+                    newLaneStr = "A1 (going STRAIGHT from C2)";
+                }
+                break;
+
+            case Direction::LEFT:  // From East (B)
+                if (laneNumber == 3) {
+                    // BL3 → CL1
+                    lane = 'C';
+                    laneNumber = 1;
+                    currentDirection = Direction::UP;
+                    newLaneStr = "C1 (turned LEFT from B3)";
+                }
+                else if (destination == Destination::LEFT) {
+                    // BL2(left) → AL1
+                    lane = 'A';
+                    laneNumber = 1;
+                    currentDirection = Direction::DOWN;
+                    newLaneStr = "A1 (turned LEFT from B2)";
+                }
+                else {
+                    // BL2(straight) → DL1
+                    lane = 'D';
+                    laneNumber = 1;
+                    currentDirection = Direction::RIGHT;
+                    newLaneStr = "D1 (going STRAIGHT from B2)";
+                }
+                break;
+
+            case Direction::RIGHT: // From West (D)
+                if (laneNumber == 3) {
+                    // DL3 → AL1
+                    lane = 'A';
+                    laneNumber = 1;
+                    currentDirection = Direction::DOWN;
+                    newLaneStr = "A1 (turned LEFT from D3)";
+                }
+                else if (destination == Destination::LEFT) {
+                    // DL2(left) → CL1
+                    lane = 'C';
+                    laneNumber = 1;
+                    currentDirection = Direction::UP;
+                    newLaneStr = "C1 (turned LEFT from D2)";
+                }
+                else {
+                    // DL2(straight) → BL1
+                    lane = 'B';
+                    laneNumber = 1;
+                    currentDirection = Direction::LEFT;
+                    newLaneStr = "B1 (going STRAIGHT from D2)";
+                }
+                break;
         }
+
+        // Log lane change
+        DebugLogger::log("==================== Vehicle " + id + " now on " + newLaneStr +
+                      " ====================", DebugLogger::LogLevel::ERROR);
+    }
+
+    // The last waypoint is placed off screen - flag for removal once it is reached
+    if (currentWaypoint == waypoints.size() - 1) {
+        state = VehicleState::EXITED;
+        DebugLogger::log("Vehicle " + id + " has left the screen", DebugLogger::LogLevel::DEBUG);
     }
+}
 
-    // DEBUG: Log A2 priority lane status
-    if (lane == 'A' && laneNumber == 2) {
-        static uint32_t lastLogTime = 0;
-        uint32_t currentTime = SDL_GetTicks();
-        if (currentTime - lastLogTime > 3000) {
-            DebugLogger::log("PRIORITY LANE (A2): Vehicle " + id + " canMove=" +
-                         (canMove ? "true" : "false"), DebugLogger::LogLevel::ERROR);
-            lastLogTime = currentTime;
+void Vehicle::advanceAlongPath(float distance, uint32_t delta) {
+    const float travelled = distance;
+
+    // Walk the waypoint polyline by exactly the requested distance
+    while (distance > 0.0f && currentWaypoint + 1 < waypoints.size()) {
+        const Point& next = waypoints[currentWaypoint + 1];
+        float dx = next.x - turnPosX;
+        float dy = next.y - turnPosY;
+        float remaining = std::sqrt(dx*dx + dy*dy);
+
+        if (distance < remaining) {
+            turnPosX += dx / remaining * distance;
+            turnPosY += dy / remaining * distance;
+            distance = 0.0f;
+        } else {
+            // Snap to the waypoint and carry the rest over to the next segment
+            turnPosX = next.x;
+            turnPosY = next.y;
+            distance -= remaining;
+            currentWaypoint++;
+            onWaypointReached();
         }
     }
 
+    // Update animation position
+    animPos = (currentDirection == Direction::UP || currentDirection == Direction::DOWN) ?
+             turnPosY : turnPosX;
+
+    // Update turn progress for visualization
+    if (turning) {
+        turnProgress = std::min(1.0f, turnProgress + 0.002f * delta);
+    }
+
+    trackStops(travelled, delta);
+}
+
+void Vehicle::trackStops(float distance, uint32_t delta) {
+    if (hasPassedStopLine() || delta == 0) {
+        return;
+    }
+
+    if (distance * 1000.0f / delta >= Constants::STOP_SPEED_THRESHOLD) {
+        haltedTime = 0;
+        halted = false;
+        return;
+    }
+
+    haltedTime += delta;
+    if (!halted && haltedTime >= static_cast<uint32_t>(Constants::STOP_MIN_DURATION)) {
+        halted = true;
+        stops++;
+    }
+}
+
+float Vehicle::getPathDistance() const {
+    float distance = 0.0f;
+    for (size_t i = 0; i < currentWaypoint && i + 1 < waypoints.size(); i++) {
+        distance += std::hypot(waypoints[i + 1].x - waypoints[i].x, waypoints[i + 1].y - waypoints[i].y);
+    }
+
+    if (currentWaypoint < waypoints.size()) {
+        distance += std::hypot(turnPosX - waypoints[currentWaypoint].x, turnPosY - waypoints[currentWaypoint].y);
+    }
+
+    return distance;
+}
+
+float Vehicle::getStopLineDistance() const {
+    if (waypoints.size() < 2) {
+        return 0.0f;
+    }
+
+    return std::hypot(waypoints[1].x - waypoints[0].x, waypoints[1].y - waypoints[0].y);
+}
+
+void Vehicle::update(uint32_t delta, bool isGreenLight, float targetPos) {
+    const float startX = turnPosX;
+    const float startY = turnPosY;
+
+    // Free lane vehicles (L3) already get a green from TrafficManager; it only
+    // withholds it while the junction entry is blocked by crossing traffic
+    bool canMove = isGreenLight;
+
     // Fine-tune speed for smoother animation
     const float SPEED_BASE = 0.018f;
     const float SPEED = SPEED_BASE * delta;
@@ -592,156 +931,7 @@ DebugLogger::log("FREE LANE (" + std::string(1, lane) + "3): Vehicle " + id + "
             if (distance < 3.0f) {
                 currentWaypoint++;
 
-                // Log progress through waypoints for debugging
-                if (laneNumber == 3 || (lane == 'A' && laneNumber == 2)) {
-                    DebugLogger::log("Vehicle " + id + " on " + lane + std::to_string(laneNumber) +
-                                 " reached waypoint " + std::to_string(currentWaypoint) +
-                                 " of " + std::to_string(waypoints.size()),
-                                 DebugLogger::LogLevel::DEBUG);
-                }
-
-                // For L3 (always turns left) and L2 (turns left if specified)
-                if ((laneNumber == 3) ||
-                    (laneNumber == 2 && destination == Destination::LEFT)) {
-
-                    // When entering turning points (varies by direction)
-                    if (currentWaypoint == 2) {
-                        turning = true;
-                        turnProgress = 0.0f;
-                        state = VehicleState::IN_INTERSECTION;
-
-                        // Log turn start
-                        std::ostringstream oss;
-                        oss << "Vehicle " << id << " on " << lane << laneNumber << " is now turning LEFT";
-                        DebugLogger::log(oss.str(), DebugLogger::LogLevel::ERROR);
-                    }
-                }
-
-                // Determine when a vehicle has exited the intersection
-                bool isExiting = false;
-
-                if (laneNumber == 3) {
-                    // L3 vehicles typically reach exit point at waypoint 3
-                    isExiting = (currentWaypoint == 3);
-                } else if (laneNumber == 2) {
-                    if (destination == Destination::LEFT) {
-                        // L2 turning left typically reaches exit at waypoint 3
-                        isExiting = (currentWaypoint == 3);
-                    } else {
-                        // L2 going straight typically reaches exit at waypoint 2
-                        isExiting = (currentWaypoint == 2);
-                    }
-                }
-
-                // Update vehicle state when exiting
-                if (isExiting) {
-                    turning = false;
-                    state = VehicleState::EXITING;
-
-                    // CRITICAL: Ensure the lane assignments strictly follow the rules
-                    std::string newLaneStr;
-                    switch (currentDirection) {
-                        case Direction::DOWN:  // From North (A)
-                            if (laneNumber == 3) {
-                                // AL3 → BL1
-                                lane = 'B';
-                                laneNumber = 1;
-                                currentDirection = Direction::LEFT;
-                                newLaneStr = "B1 (turned LEFT from A3)";
-                            }
-                            else if (destination == Destination::LEFT) {
-                                // AL2(left) → DL1
-                                lane = 'D';
-                                laneNumber = 1;
-                                currentDirection = Direction::RIGHT;
-                                newLaneStr = "D1 (turned LEFT from A2)";
-                            }
-                            else {
-                                // AL2(straight) → CL1
-                                lane = 'C';
-                                laneNumber = 1;
-                                currentDirection = Direction::UP;
-                                newLaneStr = "C1 (going STRAIGHT from A2)";
-                            }
-                            break;
-
-                        case Direction::UP:    // From South (C)
-                            if (laneNumber == 3) {
-                                // CL3 → DL1
-                                lane = 'D';
-                                laneNumber = 1;
-                                currentDirection = Direction::RIGHT;
-                                newLaneStr = "D1 (turned LEFT from C3)";
-                            }
-                            else if (destination == Destination::LEFT) {
-                                // CL2(left) → BL1
-                                lane = 'B';
-                                laneNumber = 1;
-                                currentDirection = Direction::LEFT;
-                                newLaneStr = "B1 (turned LEFT from C2)";
-                            }
-                            else {
-                                // CL2(straight) → AL1
-                                lane = 'A';
-                                laneNumber = 1;
-                                currentDirection = Direction::DOWN;
-                                newLaneStr = "A1 (going STRAIGHT from C2)";
-                            }
-                            break;
-
-                        case Direction::LEFT:  // From East (B)
-                            if (laneNumber == 3) {
-                                // BL3 → CL1
-                                lane = 'C';
-                                laneNumber = 1;
-                                currentDirection = Direction::UP;
-                                newLaneStr = "C1 (turned LEFT from B3)";
-                            }
-                            else if (destination == Destination::LEFT) {
-                                // BL2(left) → AL1
-                                lane = 'A';
-                                laneNumber = 1;
-                                currentDirection = Direction::DOWN;
-                                newLaneStr = "A1 (turned LEFT from B2)";
-                            }
-                            else {
-                                // BL2(straight) → DL1
-                                lane = 'D';
-                                laneNumber = 1;
-                                currentDirection = Direction::RIGHT;
-                                newLaneStr = "D1 (going STRAIGHT from B2)";
-                            }
-                            break;
-
-                        case Direction::RIGHT: // From West (D)
-                            if (laneNumber == 3) {
-                                // DL3 → AL1
-                                lane = 'A';
-                                laneNumber = 1;
-                                currentDirection = Direction::DOWN;
-                                newLaneStr = "A1 (turned LEFT from D3)";
-                            }
-                            else if (destination == Destination::LEFT) {
-                                // DL2(left) → CL1
-                                lane = 'C';
-                                laneNumber = 1;
-                                currentDirection = Direction::UP;
-                                newLaneStr = "C1 (turned LEFT from D2)";
-                            }
-                            else {
-                                // DL2(straight) → BL1
-                                lane = 'B';
-                                laneNumber = 1;
-                                currentDirection = Direction::LEFT;
-                                newLaneStr = "B1 (going STRAIGHT from D2)";
-                            }
-                            break;
-                    }
-
-                    // Log lane change
-                    DebugLogger::log("==================== Vehicle " + id + " now on " + newLaneStr +
-                                  " ====================", DebugLogger::LogLevel::ERROR);
-                }
+                onWaypointReached();
             }
 
             // Adjust speed based on position and turn status
@@ -781,20 +971,6 @@ DebugLogger::log("FREE LANE (" + std::string(1, lane) + "3): Vehicle " + id + "
             }
         }
 
-        // Check if we've reached the last waypoint
-        if (currentWaypoint == waypoints.size() - 1) {
-            // Get screen dimensions
-            const int windowWidth = 800;
-            const int windowHeight = 800;
-
-            // Check if off-screen
-            if (turnPosX < -30.0f || turnPosX > windowWidth + 30.0f ||
-                turnPosY < -30.0f || turnPosY > windowHeight + 30.0f) {
-                // Flag for removal
-                state = VehicleState::EXITED;
-                DebugLogger::log("Vehicle " + id + " has left the screen", DebugLogger::LogLevel::DEBUG);
-            }
-        }
     }
     else {
         // Red light - handle queue positioning with deceleration
@@ -851,6 +1027,8 @@ DebugLogger::log("FREE LANE (" + std::string(1, lane) + "3): Vehicle " + id + "
             }
         }
     }
+
+    trackStops(std::hypot(turnPosX - startX, turnPosY - startY), delta);
 }
 
 void Vehicle::calculateTurnPath(float startX, float startY, float controlX, float controlY,
@@ -0,0 +1,251 @@
+// FILE: src/corridor_benchmark.cpp
+// Headless green-wave benchmark: runs a corridor of junctions with the
+// coordinated controller twice, once with every junction on the same offset
+// and once with offsets coordinated from the link travel times, and reports
+// the stops per vehicle of both.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <random>
+
+#include "managers/Corridor.h"
+#include "managers/ArrivalGenerator.h"
+#include "core/SignalController.h"
+#include "utils/DebugLogger.h"
+
+struct CorridorOptions {
+    std::string outputPath;          // Optional CSV of the results
+    std::string timingPath;          // Optional signal timing file
+    int junctions = 4;
+    uint32_t linkMs = 15000;         // Link travel time at the start
+    uint32_t driftMs = 0;            // Added to the link travel time by the end of the run
+    uint32_t durationMs = 1800000;
+    uint32_t stepMs = 16;
+    uint32_t seed = 1;
+    int greenMs = 20000;             // Green of every road (the timing file's when only that is given)
+    bool greenSet = false;
+    float crossIntervalMs = 40000.0f; // Mean time between random arrivals at each junction
+    float mainIntervalMs = 25000.0f; // Mean time between eastbound main-street arrivals at junction 0
+    float throughShare = 0.9f;
+    MovementModel model = MovementModel::FIXED_SPEED;
+};
+
+// Results of one corridor run
+struct CorridorResult {
+    std::string mode;
+    uint32_t exited = 0;
+    double meanStops = 0.0;
+    double throughStops = 0.0;       // Per junction passed by eastbound through traffic
+    uint32_t throughPassages = 0;
+    int offsetUpdates = 0;
+    std::string offsets;
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: corridor_benchmark [options]\n"
+        "  --junctions N      junctions in the corridor (default 4)\n"
+        "  --link S           link travel time between junctions (default 15)\n"
+        "  --drift S          link travel time added linearly over the run (default 0)\n"
+        "  --duration S       simulated seconds (default 1800)\n"
+        "  --seed N           seed of the arrivals and the simulation (default 1)\n"
+        "  --green MS         green of every road, the cycle is 4 * (green + all-red) (default 20000)\n"
+        "  --interval MS      mean time between random arrivals at each junction (default 40000)\n"
+        "  --main-interval MS mean time between eastbound arrivals at the first junction (default 25000)\n"
+        "  --through P        share of link traffic carrying on straight (default 0.9)\n"
+        "  --step MS          simulation step in ms (default 16)\n"
+        "  --model idm|fixed  movement model (default fixed)\n"
+        "  --timing FILE      signal timing file (its fixed_green replaces --green's default)\n"
+        "  --out FILE         also write the results as CSV\n";
+}
+
+bool parseOptions(int argc, char* argv[], CorridorOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--out") options.outputPath = value;
+        else if (arg == "--timing") options.timingPath = value;
+        else if (arg == "--junctions") options.junctions = std::stoi(value);
+        else if (arg == "--link") options.linkMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--drift") options.driftMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--duration") options.durationMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--green") {
+            options.greenMs = std::stoi(value);
+            options.greenSet = true;
+        }
+        else if (arg == "--interval") options.crossIntervalMs = std::stof(value);
+        else if (arg == "--main-interval") options.mainIntervalMs = std::stof(value);
+        else if (arg == "--through") options.throughShare = std::stof(value);
+        else if (arg == "--step") options.stepMs = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--model") options.model = (value == "fixed") ? MovementModel::FIXED_SPEED : MovementModel::CAR_FOLLOWING;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.stepMs == 0 || options.junctions < 2 || options.greenMs <= 0 || options.crossIntervalMs <= 0.0f ||
+        options.mainIntervalMs <= 0.0f) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// One run of the corridor; both modes see the same arrivals
+bool runCorridor(bool coordinated, const CorridorOptions& options, const SignalTiming& timing,
+                 CorridorResult& result) {
+    Corridor corridor(options.junctions, options.linkMs, options.throughShare, options.seed);
+    if (!corridor.initialize(SignalControllerType::COORDINATED, timing, options.model)) {
+        return false;
+    }
+    corridor.setCoordination(coordinated);
+
+    std::mt19937 arrivalRng(options.seed);
+    std::vector<ArrivalGenerator> generators(options.junctions, ArrivalGenerator(options.crossIntervalMs));
+    std::exponential_distribution<float> mainHeadway(1.0f / options.mainIntervalMs);
+    float untilMain = mainHeadway(arrivalRng);
+    int mainCount = 0;
+
+    std::vector<std::string> lines;
+    for (uint32_t time = 0; time < options.durationMs; time += options.stepMs) {
+        if (options.driftMs > 0) {
+            const double progress = static_cast<double>(time) / options.durationMs;
+            corridor.setLinkTravelTime(options.linkMs + static_cast<uint32_t>(progress * options.driftMs));
+        }
+
+        // Random arrivals on every road of every junction (ids prefixed by the junction)
+        for (int j = 0; j < options.junctions; j++) {
+            lines.clear();
+            generators[j].update(options.stepMs, arrivalRng, lines);
+            for (const auto& line : lines) {
+                corridor.injectVehicle(j, "J" + std::to_string(j) + line);
+            }
+        }
+
+        // The main street entering the corridor eastbound
+        untilMain -= static_cast<float>(options.stepMs);
+        while (untilMain <= 0.0f) {
+            corridor.injectVehicle(0, "M" + std::to_string(++mainCount) + "_L2_STRAIGHT:D");
+            untilMain += mainHeadway(arrivalRng);
+        }
+
+        corridor.update(options.stepMs);
+    }
+
+    result.mode = coordinated ? "coordinated" : "independent";
+    result.exited = corridor.getVehiclesExited();
+    result.meanStops = corridor.getMeanStops();
+    result.throughStops = corridor.getThroughMeanStops();
+    result.throughPassages = corridor.getThroughPassages();
+    result.offsetUpdates = corridor.getOffsetUpdates();
+
+    std::ostringstream offsets;
+    for (int j = 0; j < corridor.getJunctionCount(); j++) {
+        offsets << (j > 0 ? " " : "") << corridor.getOffset(j);
+    }
+    result.offsets = offsets.str();
+    return true;
+}
+
+void printResults(const std::vector<CorridorResult>& results) {
+    std::cout << std::left << std::setw(13) << "mode"
+              << std::right << std::setw(9) << "exited" << std::setw(12) << "stops/veh"
+              << std::setw(14) << "through_stops" << std::setw(10) << "passages"
+              << std::setw(9) << "updates" << "   offsets_ms\n";
+
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(13) << result.mode
+                  << std::right << std::setw(9) << result.exited << std::setw(12) << result.meanStops
+                  << std::setw(14) << result.throughStops << std::setw(10) << result.throughPassages
+                  << std::setw(9) << result.offsetUpdates << "   " << result.offsets << "\n";
+    }
+
+    if (results.size() == 2 && results[0].meanStops > 0.0 && results[0].throughStops > 0.0) {
+        std::cout << std::setprecision(1)
+                  << "Coordination: stops per vehicle "
+                  << 100.0 * (results[1].meanStops / results[0].meanStops - 1.0) << "%, through traffic "
+                  << 100.0 * (results[1].throughStops / results[0].throughStops - 1.0) << "%\n";
+    }
+}
+
+bool writeResults(const std::string& path, const std::vector<CorridorResult>& results) {
+    std::ofstream csv(path);
+    if (!csv.is_open()) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+
+    csv << "mode,exited,mean_stops,through_stops,through_passages,offset_updates,offsets_ms\n";
+    csv << std::fixed << std::setprecision(4);
+    for (const auto& result : results) {
+        csv << result.mode << "," << result.exited << "," << result.meanStops << ","
+            << result.throughStops << "," << result.throughPassages << "," << result.offsetUpdates << ","
+            << result.offsets << "\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        CorridorOptions options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        DebugLogger::setEnabled(false);
+
+        SignalTiming timing;
+        if (!options.timingPath.empty() && !loadSignalTiming(options.timingPath, timing)) {
+            std::cerr << "Could not load timing " << options.timingPath << std::endl;
+            return 1;
+        }
+        if (options.timingPath.empty() || options.greenSet) {
+            timing.fixedGreen = options.greenMs;
+        }
+
+        std::cout << options.junctions << " junctions, " << options.linkMs / 1000.0 << " s links";
+        if (options.driftMs > 0) {
+            std::cout << " (+" << options.driftMs / 1000.0 << " s by the end)";
+        }
+        std::cout << ", cycle " << CoordinatedController::cycleLength(timing) / 1000.0 << " s, "
+                  << options.durationMs / 1000.0 << " s simulated" << std::endl;
+
+        std::vector<CorridorResult> results;
+        for (bool coordinated : {false, true}) {
+            CorridorResult result;
+            if (!runCorridor(coordinated, options, timing, result)) {
+                std::cerr << "Failed to initialize a simulation" << std::endl;
+                return 1;
+            }
+            results.push_back(result);
+        }
+
+        printResults(results);
+
+        if (!options.outputPath.empty() && !writeResults(options.outputPath, results)) {
+            return 1;
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,66 @@
+// FILE: src/managers/ArrivalGenerator.cpp
+#include "managers/ArrivalGenerator.h"
+
+ArrivalGenerator::ArrivalGenerator(float meanIntervalMs, int initialPriorityVehicles)
+    : meanIntervalMs(meanIntervalMs),
+      initialPriorityVehicles(initialPriorityVehicles),
+      generatedCount(0),
+      emergencyShare(0.0f),
+      untilNextArrival(-1.0f) {
+}
+
+void ArrivalGenerator::reset() {
+    generatedCount = 0;
+    untilNextArrival = -1.0f;
+}
+
+void ArrivalGenerator::update(uint32_t delta, std::mt19937& rng, std::vector<std::string>& lines) {
+    // Same jitter as traffic_generator: interval * U(0.7, 1.3)
+    std::uniform_real_distribution<float> jitter(0.7f, 1.3f);
+
+    if (untilNextArrival < 0.0f) {
+        untilNextArrival = meanIntervalMs * jitter(rng);
+    }
+
+    untilNextArrival -= static_cast<float>(delta);
+    while (untilNextArrival <= 0.0f) {
+        lines.push_back(nextVehicle(rng));
+        untilNextArrival += meanIntervalMs * jitter(rng);
+    }
+}
+
+std::string ArrivalGenerator::nextVehicle(std::mt19937& rng) {
+    std::string id = "V" + std::to_string(++generatedCount);
+
+    // Start-up burst on the priority lane, alternating straight and left
+    if (generatedCount <= initialPriorityVehicles) {
+        return id + "_L2" + (generatedCount % 2 == 1 ? "_STRAIGHT" : "_LEFT") + ":A";
+    }
+
+    std::uniform_int_distribution<int> roadDist(0, 3);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    char road = static_cast<char>('A' + roadDist(rng));
+    int laneNumber = unit(rng) < 0.6f ? 2 : 3;         // L2 60%, L3 40%
+    bool straight = laneNumber == 2 && unit(rng) < 0.6f; // L2 goes straight 60% of the time
+
+    // Occasional bias toward A2 to exercise the priority condition
+    if (rng() % 10 == 0) {
+        road = 'A';
+        laneNumber = 2;
+        straight = rng() % 2 == 0;
+    }
+
+    // And toward the free lane
+    if (rng() % 15 == 0) {
+        road = static_cast<char>('A' + roadDist(rng));
+        laneNumber = 3;
+        straight = false;
+    }
+
+    // Only draw when enabled so plain traces keep their sequence
+    bool emergency = emergencyShare > 0.0f && unit(rng) < emergencyShare;
+
+    return id + "_L" + std::to_string(laneNumber) + (straight ? "_STRAIGHT" : "_LEFT") +
+           (emergency ? "_E" : "") + ":" + road;
+}
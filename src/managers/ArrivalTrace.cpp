@@ -0,0 +1,74 @@
+// FILE: src/managers/ArrivalTrace.cpp
+#include "managers/ArrivalTrace.h"
+#include "managers/ArrivalGenerator.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+
+namespace ArrivalTrace {
+
+std::vector<Arrival> generate(float meanIntervalMs, int initialPriorityVehicles,
+                              uint32_t durationMs, uint32_t stepMs, uint32_t seed,
+                              float emergencyShare) {
+    std::mt19937 rng(seed);
+    ArrivalGenerator generator(meanIntervalMs, initialPriorityVehicles);
+    generator.setEmergencyShare(emergencyShare);
+
+    std::vector<Arrival> trace;
+    std::vector<std::string> lines;
+    for (uint32_t time = 0; time < durationMs; time += stepMs) {
+        lines.clear();
+        generator.update(stepMs, rng, lines);
+        for (const auto& line : lines) {
+            trace.push_back({time + stepMs, line});
+        }
+    }
+    return trace;
+}
+
+bool load(const std::string& path, std::vector<Arrival>& trace) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Could not open trace " << path << std::endl;
+        return false;
+    }
+
+    std::string text;
+    int lineNumber = 0;
+    while (std::getline(file, text)) {
+        lineNumber++;
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+
+        std::istringstream ss(text);
+        Arrival arrival;
+        if (!(ss >> arrival.timeMs >> arrival.line)) {
+            std::cerr << path << ":" << lineNumber << ": expected \"time_ms vehicle_line\"" << std::endl;
+            return false;
+        }
+        if (!trace.empty() && arrival.timeMs < trace.back().timeMs) {
+            std::cerr << path << ":" << lineNumber << ": arrivals must be in time order" << std::endl;
+            return false;
+        }
+        trace.push_back(arrival);
+    }
+    return true;
+}
+
+bool save(const std::string& path, const std::vector<Arrival>& trace) {
+    std::ofstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Could not write trace " << path << std::endl;
+        return false;
+    }
+
+    file << "# time_ms vehicle_line\n";
+    for (const auto& arrival : trace) {
+        file << arrival.timeMs << " " << arrival.line << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+}
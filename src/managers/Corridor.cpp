@@ -0,0 +1,227 @@
+// FILE: src/managers/Corridor.cpp
+#include "managers/Corridor.h"
+#include "core/Constants.h"
+#include "core/Vehicle.h"
+#include "utils/DebugLogger.h"
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    // Speed-up from the stop line and settling in behind the vehicle ahead (ms)
+    const uint32_t ACCELERATION_LAG = 2000;
+
+    int wrap(int value, int cycle) {
+        return cycle > 0 ? ((value % cycle) + cycle) % cycle : 0;
+    }
+}
+
+Corridor::Corridor(int junctionCount, uint32_t linkTravelTime, float throughShare, uint32_t seed)
+    : linkTravelTime(linkTravelTime),
+      throughShare(throughShare),
+      rng(seed),
+      coordination(true),
+      offsetUpdates(0),
+      throughStops(0),
+      throughPassages(0),
+      vehiclesExited(0) {
+
+    for (int i = 0; i < junctionCount; i++) {
+        junctions.push_back(new TrafficManager());
+    }
+    offsets.assign(junctions.size(), 0);
+    linkEstimates.assign(junctions.size() > 0 ? junctions.size() - 1 : 0, 0);
+    measuredTravel.assign(linkEstimates.size(), 0.0);
+}
+
+Corridor::~Corridor() {
+    for (auto* junction : junctions) {
+        junction->stop();
+        delete junction;
+    }
+    junctions.clear();
+}
+
+bool Corridor::initialize(SignalControllerType controller, const SignalTiming& signalTiming, MovementModel model) {
+    timing = signalTiming;
+
+    for (size_t i = 0; i < junctions.size(); i++) {
+        TrafficManager* junction = junctions[i];
+        junction->setFileInputEnabled(false);
+        if (!junction->initialize()) {
+            DebugLogger::log("Corridor junction " + std::to_string(i) + " failed to initialize",
+                             DebugLogger::LogLevel::ERROR);
+            return false;
+        }
+        junction->setMovementModel(model);
+        junction->setSignalController(controller);
+        junction->setSeed(static_cast<uint32_t>(rng() + i));
+        junction->setExitRecording(true);
+        junction->start();
+    }
+
+    for (auto& estimate : linkEstimates) {
+        estimate = freeFlowTravelTime();
+    }
+    applyOffsets(0);
+    return true;
+}
+
+void Corridor::setCoordination(bool enabled) {
+    coordination = enabled;
+    applyOffsets(0);
+}
+
+void Corridor::setLinkTravelTime(uint32_t travelTime) {
+    linkTravelTime = travelTime;
+}
+
+uint32_t Corridor::freeFlowTravelTime() const {
+    // An eastbound vehicle drives the rest of its D2 straight path at the
+    // upstream junction, the link, then the D2 approach downstream: together
+    // that is one whole D2 straight path
+    Vehicle probe("corridor_probe", 'D', 2);
+    probe.setDestination(Destination::STRAIGHT);
+
+    const Vehicle::WaypointList& waypoints = probe.getWaypoints();
+    float length = 0.0f;
+    for (size_t i = 0; i + 1 < waypoints.size(); i++) {
+        length += std::hypot(waypoints[i + 1].x - waypoints[i].x, waypoints[i + 1].y - waypoints[i].y);
+    }
+
+    const float driveMs = length / Constants::IDM_DESIRED_SPEED * 1000.0f;
+    return linkTravelTime + static_cast<uint32_t>(driveMs) + ACCELERATION_LAG;
+}
+
+void Corridor::applyOffsets(int from) {
+    if (junctions.empty()) {
+        return;
+    }
+
+    const int cycle = static_cast<int>(CoordinatedController::cycleLength(timing));
+    offsets[0] = timing.cycleOffset;
+    for (size_t i = 1; i < junctions.size(); i++) {
+        offsets[i] = coordination
+            ? wrap(offsets[i - 1] + static_cast<int>(linkEstimates[i - 1]) - Constants::CORRIDOR_GREEN_LEAD, cycle)
+            : timing.cycleOffset;
+    }
+
+    for (size_t i = static_cast<size_t>(from); i < junctions.size(); i++) {
+        SignalTiming junctionTiming = timing;
+        junctionTiming.cycleOffset = offsets[i];
+        junctions[i]->setSignalTiming(junctionTiming);
+    }
+}
+
+bool Corridor::injectVehicle(int junction, const std::string& line) {
+    if (junction < 0 || junction >= getJunctionCount()) {
+        return false;
+    }
+    return junctions[junction]->injectVehicle(line);
+}
+
+void Corridor::update(uint32_t delta) {
+    for (auto* junction : junctions) {
+        junction->update(delta);
+    }
+    const uint32_t now = junctions.empty() ? 0 : junctions[0]->getSimulationTime();
+
+    for (size_t i = 0; i < junctions.size(); i++) {
+        junctions[i]->takeExits(exits);
+        for (const auto& exit : exits) {
+            recordExit(static_cast<int>(i), exit);
+            transfer(static_cast<int>(i), exit, now);
+        }
+    }
+
+    // Vehicles reaching the end of their link join the next approach
+    while (!inTransit.empty() && inTransit.begin()->first <= now) {
+        const Transfer& arrival = inTransit.begin()->second;
+        if (junctions[arrival.junction]->injectVehicle(arrival.line)) {
+            const std::string id = arrival.line.substr(0, arrival.line.find(':'));
+            const int link = arrival.eastbound ? arrival.junction - 1 : arrival.junction;
+            origins[id] = {link, arrival.upstreamCrossing, arrival.eastbound};
+        }
+        inTransit.erase(inTransit.begin());
+    }
+}
+
+void Corridor::transfer(int junction, const VehicleExit& exit, uint32_t now) {
+    int next = -1;
+    char approach = ' ';
+    if (exit.toRoad == 'B' && junction + 1 < getJunctionCount()) {
+        next = junction + 1;
+        approach = 'D';
+    } else if (exit.toRoad == 'D' && junction > 0) {
+        next = junction - 1;
+        approach = 'B';
+    }
+    if (next < 0) {
+        vehiclesExited++;
+        return;
+    }
+
+    std::uniform_real_distribution<float> share(0.0f, 1.0f);
+    const bool straight = share(rng) < throughShare;
+
+    // Keep the original vehicle number so a vehicle can be followed along the corridor
+    const std::string base = exit.id.substr(0, exit.id.find("_L"));
+    std::ostringstream line;
+    line << base << "J" << junction << "x" << next << "_L2" << (straight ? "_STRAIGHT" : "_LEFT")
+         << (exit.emergency ? "_E" : "") << ":" << approach;
+
+    inTransit.insert({now + linkTravelTime, {next, line.str(), exit.stopLineTime, next > junction}});
+}
+
+void Corridor::recordExit(int junction, const VehicleExit& exit) {
+    auto origin = origins.find(exit.id);
+    if (origin == origins.end()) {
+        return;
+    }
+    const Origin from = origin->second;
+    origins.erase(origin);
+
+    if (!from.eastbound) {
+        return;
+    }
+    throughStops += static_cast<uint32_t>(exit.stops);
+    throughPassages++;
+
+    // Only a vehicle that never stopped measures the link rather than the queue
+    if (exit.stops > 0 || exit.stopLineTime <= from.upstreamCrossing || from.link < 0 ||
+        from.link >= static_cast<int>(measuredTravel.size())) {
+        return;
+    }
+
+    const double sample = static_cast<double>(exit.stopLineTime - from.upstreamCrossing);
+    double& measured = measuredTravel[from.link];
+    measured = (measured == 0.0) ? sample
+             : measured + Constants::CORRIDOR_TRAVEL_SMOOTHING * (sample - measured);
+
+    const double drift = measured - static_cast<double>(linkEstimates[from.link]);
+    if (coordination && std::fabs(drift) >= Constants::CORRIDOR_OFFSET_TOLERANCE) {
+        linkEstimates[from.link] = static_cast<uint32_t>(std::lround(measured));
+        applyOffsets(from.link + 1);
+        offsetUpdates++;
+
+        std::ostringstream oss;
+        oss << "Corridor link " << from.link << " (junction " << junction - 1 << " to " << junction
+            << ") travel time now " << linkEstimates[from.link] << " ms, offsets re-coordinated from junction "
+            << from.link + 1;
+        DebugLogger::log(oss.str());
+    }
+}
+
+double Corridor::getMeanStops() const {
+    uint32_t stops = 0;
+    uint32_t vehicles = 0;
+    for (const auto* junction : junctions) {
+        stops += junction->getStopTotal();
+        vehicles += junction->getStopsCounted();
+    }
+    return vehicles > 0 ? static_cast<double>(stops) / vehicles : 0.0;
+}
+
+double Corridor::getThroughMeanStops() const {
+    return throughPassages > 0 ? static_cast<double>(throughStops) / throughPassages : 0.0;
+}
@@ -20,7 +20,7 @@ FileHandler::~FileHandler() {
 }
 
 std::vector<Vehicle*> FileHandler::readVehiclesFromFiles() {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<InstrumentedMutex> lock(mutex);
     std::vector<Vehicle*> vehicles;
 
     // Ensure directory exists before trying to read
@@ -134,6 +134,7 @@ Vehicle* FileHandler::parseVehicleLine(const std::string& line) {
     // Expected formats:
     // "vehicleId_L{laneNumber}:laneId"
     // "vehicleId_L{laneNumber}_DIRECTION:laneId"
+    // either optionally followed by "@epoch_ms", the generation time
     size_t pos = line.find(":");
     if (pos == std::string::npos) {
         DebugLogger::log("Error parsing line (missing colon): " + line, DebugLogger::LogLevel::ERROR);
@@ -197,6 +198,15 @@ Vehicle* FileHandler::parseVehicleLine(const std::string& line) {
     Vehicle* vehicle = new Vehicle(vehicleId, laneId, laneNumber, isEmergency);
     vehicle->setDestination(destination);
 
+    size_t stampPos = line.find('@', pos);
+    if (stampPos != std::string::npos) {
+        try {
+            vehicle->setGeneratedTime(std::stoll(line.substr(stampPos + 1)));
+        } catch (const std::exception&) {
+            DebugLogger::log("Ignoring invalid generation stamp: " + line, DebugLogger::LogLevel::WARNING);
+        }
+    }
+
     std::ostringstream oss;
     oss << "Created vehicle " << vehicleId << " for lane " << laneId << laneNumber;
     switch (destination) {
@@ -213,7 +223,7 @@ Vehicle* FileHandler::parseVehicleLine(const std::string& line) {
 }
 
 void FileHandler::writeLaneStatus(char laneId, int laneNumber, int vehicleCount, bool isPriority) {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<InstrumentedMutex> lock(mutex);
     std::string statusPath = getLaneStatusFilePath();
 
     // Make sure the directory exists
@@ -260,7 +270,7 @@ bool FileHandler::checkFilesExist() {
 }
 
 bool FileHandler::initializeFiles() {
-    std::lock_guard<std::mutex> lock(mutex);
+    std::lock_guard<InstrumentedMutex> lock(mutex);
 
     try {
         // Create data directory if it doesn't exist
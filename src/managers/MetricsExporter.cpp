@@ -0,0 +1,330 @@
+// FILE: src/managers/MetricsExporter.cpp
+#include "managers/MetricsExporter.h"
+#include "core/Constants.h"
+#include "utils/DebugLogger.h"
+#include <sstream>
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#ifdef _WIN32
+    using SocketHandle = SOCKET;
+
+    bool startSockets() {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }
+
+    void stopSockets() {
+        WSACleanup();
+    }
+
+    void closeSocket(SocketHandle handle) {
+        closesocket(handle);
+    }
+
+    bool isValid(SocketHandle handle) {
+        return handle != INVALID_SOCKET;
+    }
+#else
+    using SocketHandle = int;
+
+    bool startSockets() {
+        return true;
+    }
+
+    void stopSockets() {
+    }
+
+    void closeSocket(SocketHandle handle) {
+        close(handle);
+    }
+
+    bool isValid(SocketHandle handle) {
+        return handle >= 0;
+    }
+#endif
+
+    // A client hanging up mid-response must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    // How long accept() waits before checking for stop(), and how long a client may take to send its request
+    const int ACCEPT_POLL_MS = 200;
+    const int CLIENT_TIMEOUT_MS = 1000;
+
+    const char* const LIGHT_STATE_NAMES[MetricsSnapshot::LIGHT_STATE_COUNT] = {
+        "all_red", "a_green", "b_green", "c_green", "d_green", "phase"
+    };
+
+    void writeHeader(std::ostringstream& out, const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << " " << help << "\n";
+        out << "# TYPE " << name << " " << type << "\n";
+    }
+
+    // Summary with quantiles; values are scaled to seconds
+    void writeSummary(std::ostringstream& out, const char* name, const char* help,
+                      const LatencySummary& summary, double secondsPerUnit) {
+        writeHeader(out, name, "summary", help);
+        out << name << "{quantile=\"0.5\"} " << summary.p50 * secondsPerUnit << "\n";
+        out << name << "{quantile=\"0.95\"} " << summary.p95 * secondsPerUnit << "\n";
+        out << name << "{quantile=\"0.99\"} " << summary.p99 * secondsPerUnit << "\n";
+        out << name << "_sum " << summary.sum * secondsPerUnit << "\n";
+        out << name << "_count " << summary.count << "\n";
+    }
+}
+
+MetricsExporter::MetricsExporter(TrafficManager& manager)
+    : manager(manager), running(false), listenSocket(-1) {}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(uint16_t port) {
+    if (isRunning()) {
+        return true;
+    }
+    if (!startSockets()) {
+        DebugLogger::log("Metrics endpoint: socket startup failed", DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    SocketHandle handle = socket(AF_INET, SOCK_STREAM, 0);
+    if (!isValid(handle)) {
+        DebugLogger::log("Metrics endpoint: could not create a socket", DebugLogger::LogLevel::ERROR);
+        stopSockets();
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(handle, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+
+    if (bind(handle, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(handle, 8) != 0) {
+        DebugLogger::log("Metrics endpoint: could not listen on 127.0.0.1:" + std::to_string(port),
+                         DebugLogger::LogLevel::ERROR);
+        closeSocket(handle);
+        stopSockets();
+        return false;
+    }
+
+    manager.setMetricsPublishing(true);
+    listenSocket = static_cast<intptr_t>(handle);
+    running.store(true, std::memory_order_release);
+    thread = std::thread(&MetricsExporter::serve, this);
+    DebugLogger::log("Metrics endpoint at http://127.0.0.1:" + std::to_string(port) + "/metrics");
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    if (thread.joinable()) {
+        thread.join();
+    }
+    closeSocket(static_cast<SocketHandle>(listenSocket));
+    listenSocket = -1;
+    stopSockets();
+}
+
+void MetricsExporter::serve() {
+    const SocketHandle listener = static_cast<SocketHandle>(listenSocket);
+
+    while (running.load(std::memory_order_acquire)) {
+        // Wait for a connection, waking up regularly to notice stop()
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(listener, &readable);
+        timeval timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_usec = ACCEPT_POLL_MS * 1000;
+        if (select(static_cast<int>(listener) + 1, &readable, nullptr, nullptr, &timeout) <= 0) {
+            continue;
+        }
+
+        SocketHandle client = accept(listener, nullptr, nullptr);
+        if (!isValid(client)) {
+            continue;
+        }
+        respond(static_cast<intptr_t>(client));
+        closeSocket(client);
+    }
+}
+
+void MetricsExporter::respond(intptr_t clientHandle) {
+    const SocketHandle client = static_cast<SocketHandle>(clientHandle);
+
+#ifdef _WIN32
+    DWORD timeout = CLIENT_TIMEOUT_MS;
+#else
+    timeval timeout;
+    timeout.tv_sec = CLIENT_TIMEOUT_MS / 1000;
+    timeout.tv_usec = (CLIENT_TIMEOUT_MS % 1000) * 1000;
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+    // Only the request line matters; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        const int received = static_cast<int>(recv(client, buffer, sizeof(buffer), 0));
+        if (received <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string status = "404 Not Found";
+    std::string contentType = "text/plain; charset=utf-8";
+    std::string body = "Not found\n";
+
+    const size_t lineEnd = request.find("\r\n");
+    std::istringstream requestLine(request.substr(0, lineEnd));
+    std::string method;
+    std::string path;
+    requestLine >> method >> path;
+
+    if (method != "GET" && method != "HEAD") {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    } else if (path == "/metrics" || path.rfind("/metrics?", 0) == 0) {
+        status = "200 OK";
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = format(manager.getMetricsSnapshot());
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 " << status << "\r\n"
+             << "Content-Type: " << contentType << "\r\n"
+             << "Content-Length: " << body.size() << "\r\n"
+             << "Connection: close\r\n\r\n";
+    if (method != "HEAD") {
+        response << body;
+    }
+
+    const std::string text = response.str();
+    size_t sent = 0;
+    while (sent < text.size()) {
+        const int written = static_cast<int>(send(client, text.data() + sent, static_cast<int>(text.size() - sent), SEND_FLAGS));
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+}
+
+std::string MetricsExporter::format(const MetricsSnapshot& snapshot) {
+    std::ostringstream out;
+    const TrafficCounters& counters = snapshot.counters;
+    const char roads[] = {'A', 'B', 'C', 'D'};
+
+    writeHeader(out, "trafficsim_simulation_time_seconds", "gauge", "Simulated time of the snapshot.");
+    out << "trafficsim_simulation_time_seconds " << snapshot.simTime / 1000.0 << "\n";
+
+    // Per-lane flow counters; a lane label is the lane number on its road
+    struct LaneMetric {
+        const char* name;
+        const char* type;
+        const char* help;
+        int64_t (*value)(const FlowCounters&);
+    };
+    const LaneMetric laneMetrics[] = {
+        {"trafficsim_lane_vehicles", "gauge", "Vehicles in the lane.",
+         [](const FlowCounters& c) { return static_cast<int64_t>(c.occupancy); }},
+        {"trafficsim_lane_queue_length", "gauge", "Vehicles in the lane not yet past the stop line.",
+         [](const FlowCounters& c) { return static_cast<int64_t>(c.queued); }},
+        {"trafficsim_lane_arrivals_total", "counter", "Vehicles that joined the lane.",
+         [](const FlowCounters& c) { return static_cast<int64_t>(c.arrivals); }},
+        {"trafficsim_lane_crossings_total", "counter", "Vehicles that crossed the lane's stop line.",
+         [](const FlowCounters& c) { return static_cast<int64_t>(c.crossings); }},
+        {"trafficsim_lane_departures_total", "counter", "Vehicles that left the simulation from the lane.",
+         [](const FlowCounters& c) { return static_cast<int64_t>(c.departures); }},
+    };
+    for (const auto& metric : laneMetrics) {
+        writeHeader(out, metric.name, metric.type, metric.help);
+        for (char road : roads) {
+            for (int lane = 1; lane <= TrafficCounters::LANES_PER_ROAD; lane++) {
+                out << metric.name << "{road=\"" << road << "\",lane=\"" << lane << "\"} "
+                    << metric.value(counters.lane(road, lane)) << "\n";
+            }
+        }
+    }
+
+    writeHeader(out, "trafficsim_lane_fill_ratio", "gauge", "Vehicles in the lane over the lane capacity.");
+    for (char road : roads) {
+        for (int lane = 1; lane <= TrafficCounters::LANES_PER_ROAD; lane++) {
+            out << "trafficsim_lane_fill_ratio{road=\"" << road << "\",lane=\"" << lane << "\"} "
+                << static_cast<double>(counters.lane(road, lane).occupancy) / Constants::MAX_QUEUE_SIZE << "\n";
+        }
+    }
+
+    writeHeader(out, "trafficsim_vehicles", "gauge", "Vehicles in the simulation.");
+    out << "trafficsim_vehicles " << snapshot.vehiclesActive << "\n";
+    writeHeader(out, "trafficsim_vehicles_exited_total", "counter", "Vehicles that left the simulation.");
+    out << "trafficsim_vehicles_exited_total " << snapshot.vehiclesExited << "\n";
+
+    writeHeader(out, "trafficsim_light_state", "gauge", "1 for the current traffic light state.");
+    for (int i = 0; i < MetricsSnapshot::LIGHT_STATE_COUNT; i++) {
+        out << "trafficsim_light_state{state=\"" << LIGHT_STATE_NAMES[i] << "\"} "
+            << (snapshot.lightState == i ? 1 : 0) << "\n";
+    }
+    writeHeader(out, "trafficsim_light_state_seconds_total", "counter", "Simulated time spent in each light state.");
+    for (int i = 0; i < MetricsSnapshot::LIGHT_STATE_COUNT; i++) {
+        out << "trafficsim_light_state_seconds_total{state=\"" << LIGHT_STATE_NAMES[i] << "\"} "
+            << snapshot.lightStateTime[i] / 1000.0 << "\n";
+    }
+
+    // Heap use per subsystem; allocation rates are rate() of the totals
+    struct MemoryMetric {
+        const char* name;
+        const char* type;
+        const char* help;
+        uint64_t MemoryAccounting::TagStats::*value;
+    };
+    const MemoryMetric memoryMetrics[] = {
+        {"trafficsim_memory_live_bytes", "gauge", "Heap bytes in use by the subsystem.",
+         &MemoryAccounting::TagStats::liveBytes},
+        {"trafficsim_memory_peak_bytes", "gauge", "Most heap bytes the subsystem had in use at once.",
+         &MemoryAccounting::TagStats::peakBytes},
+        {"trafficsim_memory_allocations_total", "counter", "Heap allocations made by the subsystem.",
+         &MemoryAccounting::TagStats::allocations},
+        {"trafficsim_memory_allocated_bytes_total", "counter", "Heap bytes allocated by the subsystem.",
+         &MemoryAccounting::TagStats::allocatedBytes},
+    };
+    for (const auto& metric : memoryMetrics) {
+        writeHeader(out, metric.name, metric.type, metric.help);
+        for (int i = 0; i < MemoryAccounting::TAG_COUNT; i++) {
+            out << metric.name << "{tag=\"" << MemoryAccounting::tagName(static_cast<MemoryTag>(i)) << "\"} "
+                << snapshot.memory[i].*metric.value << "\n";
+        }
+    }
+
+    writeSummary(out, "trafficsim_queue_wait_seconds",
+                 "Simulated time from joining a lane to crossing its stop line.", snapshot.wait, 1e-3);
+    writeSummary(out, "trafficsim_ingest_lag_seconds",
+                 "Wall time from the generator writing a vehicle to the simulator reading it.", snapshot.ingestLag, 1e-3);
+    writeSummary(out, "trafficsim_frame_time_seconds",
+                 "Wall time of a render frame, simulation steps included.", snapshot.frameTime, 1e-6);
+    return out.str();
+}
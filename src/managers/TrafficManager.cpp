@@ -2,17 +2,48 @@
 #include "../include/managers/TrafficManager.h"
 #include "utils/DebugLogger.h"
 #include <sstream>
+#include <fstream>
 #include <algorithm>
+#include <iomanip>
 #include <wchar.h>
 #include "core/Constants.h"
+#include "utils/BinaryIO.h"
+#include "utils/Statistics.h"
+#include "utils/Profiler.h"
+#include "utils/TraceRecorder.h"
 #include "math.h"
 
 TrafficManager::TrafficManager()
     : trafficLight(nullptr),
       fileHandler(nullptr),
+      simTime(0),
       lastFileCheckTime(0),
       lastPriorityUpdateTime(0),
-      running(false) {
+      lastDebugTime(0),
+      lastStatusTime(0),
+      rng(std::random_device{}()),
+      running(false),
+      junctionGrid(Constants::WINDOW_WIDTH / 2 - Constants::INTERSECTION_HALF_SIZE - Constants::JUNCTION_GRID_MARGIN,
+                   Constants::WINDOW_HEIGHT / 2 - Constants::INTERSECTION_HALF_SIZE - Constants::JUNCTION_GRID_MARGIN,
+                   2.0f * (Constants::INTERSECTION_HALF_SIZE + Constants::JUNCTION_GRID_MARGIN),
+                   2.0f * (Constants::INTERSECTION_HALF_SIZE + Constants::JUNCTION_GRID_MARGIN),
+                   Constants::JUNCTION_CELL_SIZE),
+      movementModel(MovementModel::FIXED_SPEED),
+      controllerType(SignalControllerType::QUEUE_AVERAGE),
+      fileInputEnabled(true),
+      vehiclesExited(0),
+      priorityModeTime(0),
+      stopTotal(0),
+      stoppedVehicleCount(0),
+      lightStateTime(),
+      exitRecording(false),
+      metricsPublishing(false),
+      lastMetricsTime(0),
+      seriesRecorder(nullptr),
+      seriesInterval(0),
+      lastSeriesTime(0),
+      junctionOverlaps(0),
+      totalJunctionOverlaps(0) {
 
     DebugLogger::log("TrafficManager created");
 }
@@ -40,7 +71,7 @@ TrafficManager::~TrafficManager() {
 bool TrafficManager::initialize() {
     // Create file handler with consistent path
     fileHandler = new FileHandler(Constants::DATA_PATH);
-    if (!fileHandler->initializeFiles()) {
+    if (fileInputEnabled && !fileHandler->initializeFiles()) {
         DebugLogger::log("Failed to initialize lane files", DebugLogger::LogLevel::ERROR);
         return false;
     }
@@ -49,6 +80,8 @@ bool TrafficManager::initialize() {
     for (char road : {'A', 'B', 'C', 'D'}) {
         for (int laneNum = 1; laneNum <= 3; laneNum++) {
             Lane* lane = new Lane(road, laneNum);
+            lane->setPriorityThresholds(signalTiming.priorityThresholdHigh, signalTiming.priorityThresholdLow);
+            lane->setCounters(&counters);
             lanes.push_back(lane);
 
             // Add to priority queue with initial priority
@@ -56,8 +89,16 @@ bool TrafficManager::initialize() {
         }
     }
 
+    laneEntryBlocked.assign(lanes.size(), 0);
+    laneWaitTimes.assign(lanes.size(), std::vector<uint32_t>());
+    laneWaitHistograms.assign(lanes.size(), LatencyHistogram());
+    laneIngestLag.assign(lanes.size(), LatencyHistogram());
+    laneDeparted.assign(lanes.size(), 0);
+
     // Create traffic light
     trafficLight = new TrafficLight();
+    trafficLight->setTiming(signalTiming);
+    trafficLight->setController(SignalController::create(controllerType));
 
     std::ostringstream oss;
     oss << "TrafficManager initialized with " << lanes.size() << " lanes";
@@ -78,39 +119,77 @@ void TrafficManager::stop() {
 
 void TrafficManager::update(uint32_t delta) {
     if (!running) return;
+    PROFILE_ZONE(SIM_UPDATE);
 
-    uint32_t currentTime = SDL_GetTicks();
+    simTime += delta;
+    uint32_t currentTime = simTime;
 
     // Check for new vehicles more frequently (every 200ms)
-    if (currentTime - lastFileCheckTime >= 200) {
+    if (fileInputEnabled && currentTime - lastFileCheckTime >= 200) {
+        PROFILE_ZONE(READ_VEHICLES);
         readVehicles();
         lastFileCheckTime = currentTime;
     }
 
     // CRITICAL: Update lane priorities FIRST - this must happen before traffic light updates
-    updatePriorities();
+    {
+        PROFILE_ZONE(UPDATE_PRIORITIES);
+        updatePriorities();
+    }
+
+    // Index vehicles in the junction area, then hold lanes whose entry is occupied
+    rebuildJunctionGrid();
+    preventVehicleOverlap();
 
     // CRITICAL: Process vehicles based on traffic light state and lane type
-    processVehicles(delta);
+    {
+        PROFILE_ZONE(PROCESS_VEHICLES);
+        processVehicles(delta);
+    }
+    recordDepartures();
 
     // Check for vehicles leaving the simulation
     checkVehicleBoundaries();
 
     // Update traffic light - AFTER priorities have been updated
     if (trafficLight) {
-        trafficLight->update(lanes);
+        PROFILE_ZONE(TRAFFIC_LIGHT);
+        trafficLight->update(lanes, counters, rates, currentTime);
+    }
+
+    if (trafficLight) {
+        lightStateTime[static_cast<int>(trafficLight->getCurrentState())] += delta;
+
+        // Time the controller spent serving the priority lane
+        if (trafficLight->isPriorityActive()) {
+            priorityModeTime += delta;
+        }
     }
 
+    Lane* priorityLane = getPriorityLane();
+
     // Debug log current state
-    static uint32_t lastDebugTime = 0;
-    if (currentTime - lastDebugTime > 2000) {  // Every 2 seconds
-        Lane* priorityLane = findLane('A', 2);
+    if (currentTime - lastDebugTime > 2000 && DebugLogger::isEnabled()) {  // Every 2 seconds
         if (priorityLane) {
-            DebugLogger::log("A2 (Priority lane) has " + std::to_string(priorityLane->getVehicleCount()) +
+            DebugLogger::log("A2 (Priority lane) has " + std::to_string(counters.lane('A', 2).occupancy) +
                           " vehicles (Priority: " + std::to_string(priorityLane->getPriority()) + ")",
                           DebugLogger::LogLevel::INFO);
         }
 
+        // Occupied lanes
+        std::ostringstream oss;
+        oss << "Lane Status: ";
+        for (auto* lane : lanes) {
+            int count = counters.lane(lane->getLaneId(), lane->getLaneNumber()).occupancy;
+            if (count > 0) {
+                oss << lane->getName() << ":" << count << " ";
+                if (lane->getPriority() > 0) {
+                    oss << "(PRIORITY) ";
+                }
+            }
+        }
+        DebugLogger::log(oss.str(), DebugLogger::LogLevel::DEBUG);
+
         // Log traffic light state
         if (trafficLight) {
             std::string stateStr;
@@ -120,12 +199,24 @@ void TrafficManager::update(uint32_t delta) {
                 case TrafficLight::State::B_GREEN: stateStr = "B_GREEN"; break;
                 case TrafficLight::State::C_GREEN: stateStr = "C_GREEN"; break;
                 case TrafficLight::State::D_GREEN: stateStr = "D_GREEN"; break;
+                case TrafficLight::State::PHASE:
+                    stateStr = "PHASE " + ConflictMatrix::describe(trafficLight->getGreenMovements());
+                    break;
             }
             DebugLogger::log("Current light state: " + stateStr, DebugLogger::LogLevel::INFO);
         }
 
         lastDebugTime = currentTime;
     }
+
+    if (seriesRecorder && (seriesInterval == 0 || simTime - lastSeriesTime >= seriesInterval)) {
+        recordSeries();
+        // Stay on the interval grid: advance to the last grid point passed,
+        // skipping any the step jumped over
+        lastSeriesTime = seriesInterval == 0 ? simTime : simTime - (simTime - lastSeriesTime) % seriesInterval;
+    }
+
+    publishCounters();
 }
 
 void TrafficManager::readVehicles() {
@@ -146,6 +237,7 @@ void TrafficManager::readVehicles() {
     std::vector<Vehicle*> newVehicles = fileHandler->readVehiclesFromFiles();
 
     if (!newVehicles.empty()) {
+        TraceRecorder::counter("ingest_batch", static_cast<int64_t>(newVehicles.size()));
         std::ostringstream oss;
         oss << "Read " << newVehicles.size() << " new vehicles from files";
         DebugLogger::log(oss.str());
@@ -157,8 +249,7 @@ void TrafficManager::readVehicles() {
     }
 
     // Write status to file periodically for monitoring
-    static uint32_t lastStatusTime = 0;
-    uint32_t currentTime = SDL_GetTicks();
+    uint32_t currentTime = simTime;
 
     if (currentTime - lastStatusTime >= 5000) { // Every 5 seconds
         for (auto* lane : lanes) {
@@ -180,7 +271,16 @@ void TrafficManager::addVehicle(Vehicle* vehicle) {
 
     Lane* targetLane = findLane(vehicle->getLane(), vehicle->getLaneNumber());
     if (targetLane) {
+        vehicle->setQueueEntryTime(simTime);
         targetLane->enqueue(vehicle);
+        rates.vehicleArrived(targetLane->getLaneId(), targetLane->getLaneNumber(), simTime);
+
+        if (vehicle->getGeneratedTime() > 0) {
+            const size_t laneIndex = std::find(lanes.begin(), lanes.end(), targetLane) - lanes.begin();
+            const int64_t lag = vehicle->getIngestedTime() - vehicle->getGeneratedTime();
+            laneIngestLag[laneIndex].record(static_cast<uint32_t>(std::max<int64_t>(0, lag)));
+            allIngestLag.record(static_cast<uint32_t>(std::max<int64_t>(0, lag)));
+        }
 
         // Log the action
         std::ostringstream oss;
@@ -211,82 +311,87 @@ void TrafficManager::updatePriorities() {
     }
 
     // CRITICAL: Check if priority condition is met (>10 vehicles in A2)
-    int vehicleCount = priorityLane->getVehicleCount();
+    int vehicleCount = counters.lane('A', 2).occupancy;
     int oldPriority = priorityLane->getPriority();
 
-    // PRIORITY CONDITION: A2 lane has more than 10 vehicles
-    if (vehicleCount > Constants::PRIORITY_THRESHOLD_HIGH && oldPriority == 0) {
+    // PRIORITY CONDITION: A2 lane has more than priorityThresholdHigh vehicles
+    if (vehicleCount > signalTiming.priorityThresholdHigh && oldPriority == 0) {
         // Activate priority mode
         priorityLane->updatePriority();  // This will set priority to 100
 
         DebugLogger::log("*** PRIORITY MODE ACTIVATED: A2 has " + std::to_string(vehicleCount) +
                       " vehicles (>10) ***", DebugLogger::LogLevel::INFO);
-
-        // CRITICAL: Force traffic light to A green if not already
-        if (trafficLight && trafficLight->getCurrentState() != TrafficLight::State::A_GREEN) {
-            // Set next state to ALL_RED (transitional state)
-            trafficLight->setNextState(TrafficLight::State::ALL_RED);
-            DebugLogger::log("Forcing light transition to ALL_RED then A_GREEN due to priority mode");
-        }
     }
     // Check if we should exit priority mode (<5 vehicles)
-    else if (vehicleCount < Constants::PRIORITY_THRESHOLD_LOW && oldPriority > 0) {
+    else if (vehicleCount < signalTiming.priorityThresholdLow && oldPriority > 0) {
         // Deactivate priority mode
         priorityLane->updatePriority();  // This will reset priority to 0
 
         DebugLogger::log("*** PRIORITY MODE DEACTIVATED: A2 now has " + std::to_string(vehicleCount) +
                       " vehicles (<5) ***", DebugLogger::LogLevel::INFO);
     }
-
-    // CRITICAL: Also log current lane state
-    std::ostringstream oss;
-    oss << "Lane Status: ";
-    for (auto* lane : lanes) {
-        if (lane->getVehicleCount() > 0) {
-            oss << lane->getName() << ":" << lane->getVehicleCount() << " ";
-            if (lane->getPriority() > 0) {
-                oss << "(PRIORITY) ";
-            }
-        }
-    }
-    DebugLogger::log(oss.str(), DebugLogger::LogLevel::DEBUG);
 }
 
 
 void TrafficManager::processVehicles(uint32_t delta) {
-    // Determine which road has green light
-    char greenRoad = ' ';
-    if (trafficLight) {
-        auto state = trafficLight->getCurrentState();
-        if (state == TrafficLight::State::A_GREEN) greenRoad = 'A';
-        else if (state == TrafficLight::State::B_GREEN) greenRoad = 'B';
-        else if (state == TrafficLight::State::C_GREEN) greenRoad = 'C';
-        else if (state == TrafficLight::State::D_GREEN) greenRoad = 'D';
-    }
-
     // CRITICAL: Process each lane independently with special rules
-    for (auto* lane : lanes) {
+    for (size_t laneIndex = 0; laneIndex < lanes.size(); laneIndex++) {
+        Lane* lane = lanes[laneIndex];
         bool isGreenLight = false;
 
-        // RULE 1: If this is lane's road has green light, it can move
-        if (lane->getLaneId() == greenRoad) {
-            isGreenLight = true;
-        }
-        // RULE 2: Lane 3 (free lane) can ALWAYS move regardless of traffic light
-        else if (lane->getLaneNumber() == 3) {
+        // RULE 1: Lane 3 (free lane) can ALWAYS move regardless of traffic light
+        if (lane->getLaneNumber() == 3) {
             isGreenLight = true;  // FREE LANE ALWAYS HAS GREEN LIGHT
         }
+        // RULE 2: A controlled lane moves while the movement of its first
+        // waiting vehicle is green (a road green releases all of them)
+        else if (trafficLight) {
+            const Vehicle* head = nullptr;
+            if (lane->getLaneNumber() == 2) {
+                for (auto* vehicle : lane->getVehicles()) {
+                    if (!vehicle->hasPassedStopLine()) {
+                        head = vehicle;
+                        break;
+                    }
+                }
+            }
+            isGreenLight = head ?
+                trafficLight->isMovementGreen(RouteTable::movementIndex(lane->getLaneId(), 2, head->getDestination())) :
+                trafficLight->isGreen(lane->getLaneId());
+        }
+
+        // RULE 3: Nobody enters while crossing traffic occupies the lane's junction entry
+        bool entryBlocked = laneIndex < laneEntryBlocked.size() && laneEntryBlocked[laneIndex];
 
         // Get all vehicles in this lane
         const auto& vehicles = lane->getVehicles();
+
+        // First green of the waiting vehicles. Vehicles that joined earlier saw
+        // every green a later one saw, so the walk from the back stops at the
+        // first vehicle already marked
+        if (isGreenLight) {
+            for (auto it = vehicles.rbegin(); it != vehicles.rend() && !(*it)->hasSeenGreen(); ++it) {
+                if (!(*it)->hasPassedStopLine()) {
+                    (*it)->markGreen(simTime);
+                }
+            }
+        }
         int queuePos = 0;
 
-        // Update each vehicle
-        for (auto* vehicle : vehicles) {
-            if (vehicle) {
-                // CRITICAL: Update vehicle with correct light status
-                vehicle->update(delta, isGreenLight, 0.0f);
-                queuePos++;
+        if (movementModel == MovementModel::CAR_FOLLOWING) {
+            // Car-following: one pass over the lane, each vehicle reacts to its leader
+            lane->updateCarFollowing(delta, isGreenLight && !entryBlocked);
+        } else {
+            // Fixed speed: update each vehicle on its own
+            for (auto* vehicle : vehicles) {
+                if (vehicle) {
+                    // Vehicles past the stop line always clear the junction, even on red
+                    bool canMove = vehicle->hasPassedStopLine() || (isGreenLight && !entryBlocked);
+
+                    // CRITICAL: Update vehicle with correct light status
+                    vehicle->update(delta, canMove, 0.0f);
+                    queuePos++;
+                }
             }
         }
 
@@ -307,7 +412,9 @@ void TrafficManager::processVehicles(uint32_t delta) {
 }
 
 void TrafficManager::checkVehicleBoundaries() {
-    for (auto* lane : lanes) {
+    for (size_t laneIndex = 0; laneIndex < lanes.size(); laneIndex++) {
+        Lane* lane = lanes[laneIndex];
+
         // Check each vehicle
         while (!lane->isEmpty()) {
             Vehicle* vehicle = lane->peek();
@@ -315,6 +422,22 @@ void TrafficManager::checkVehicleBoundaries() {
             if (vehicle && vehicle->hasExited()) {
                 // Remove the vehicle from the queue
                 Vehicle* removedVehicle = lane->dequeue();
+                removedVehicle->setExitTime(simTime);
+                vehiclesExited++;
+                rates.vehicleExited(lane->getLaneId(), lane->getLaneNumber(), simTime);
+                if (laneIndex < laneDeparted.size() && laneDeparted[laneIndex] > 0) {
+                    laneDeparted[laneIndex]--;
+                }
+
+                if (exitRecording) {
+                    // The vehicle has switched to its outgoing lane by now, the queue still names its approach
+                    int movement = RouteTable::movementIndex(lane->getLaneId(), lane->getLaneNumber(),
+                                                             removedVehicle->getDestination());
+                    recordedExits.push_back({removedVehicle->getId(), lane->getLaneId(), lane->getLaneNumber(),
+                                             movement >= 0 ? RouteTable::movement(movement).toRoad : ' ',
+                                             removedVehicle->isEmergencyVehicle(), removedVehicle->getStopLineTime(),
+                                             removedVehicle->getStops()});
+                }
 
                 // Log vehicle exit with lane info
                 std::ostringstream oss;
@@ -332,6 +455,50 @@ void TrafficManager::checkVehicleBoundaries() {
     }
 }
 
+void TrafficManager::recordDepartures() {
+    // Vehicles of a lane cross the stop line in queue order, so only the ones
+    // after the already-departed prefix need checking
+    for (size_t laneIndex = 0; laneIndex < lanes.size() && laneIndex < laneDeparted.size(); laneIndex++) {
+        const Lane* lane = lanes[laneIndex];
+        const auto& vehicles = lane->getVehicles();
+        size_t& departed = laneDeparted[laneIndex];
+
+        while (departed < vehicles.size() && vehicles[departed]->hasPassedStopLine()) {
+            Vehicle* vehicle = vehicles[departed];
+            const uint32_t wait = simTime - vehicle->getQueueEntryTime();
+            laneWaitTimes[laneIndex].push_back(wait);
+            laneWaitHistograms[laneIndex].record(wait);
+            allWaits.record(wait);
+            vehicle->setStopLineTime(simTime);
+            stopTotal += static_cast<uint32_t>(vehicle->getStops());
+            stoppedVehicleCount++;
+
+            if (vehicle->isEmergencyVehicle() && lane->getLaneNumber() == 2) {
+                emergencyClearanceTimes.push_back(wait);
+                DebugLogger::log("Emergency vehicle " + vehicle->getId() + " cleared " + lane->getName() +
+                               " after " + std::to_string(wait) + " ms", DebugLogger::LogLevel::WARNING);
+            }
+
+            int movement = RouteTable::movementIndex(lane->getLaneId(), lane->getLaneNumber(),
+                                                     vehicle->getDestination());
+            counters.vehicleCrossed(lane->getLaneId(), lane->getLaneNumber(), movement,
+                                    vehicle->isEmergencyVehicle());
+            departed++;
+        }
+    }
+}
+
+void TrafficManager::recountDepartures() {
+    for (size_t laneIndex = 0; laneIndex < lanes.size() && laneIndex < laneDeparted.size(); laneIndex++) {
+        const auto& vehicles = lanes[laneIndex]->getVehicles();
+        size_t departed = 0;
+        while (departed < vehicles.size() && vehicles[departed]->hasPassedStopLine()) {
+            departed++;
+        }
+        laneDeparted[laneIndex] = departed;
+    }
+}
+
 Lane* TrafficManager::findLane(char laneId, int laneNumber) const {
     for (auto* lane : lanes) {
         if (lane->getLaneId() == laneId && lane->getLaneNumber() == laneNumber) {
@@ -341,6 +508,533 @@ Lane* TrafficManager::findLane(char laneId, int laneNumber) const {
     return nullptr;
 }
 
+void TrafficManager::setMovementModel(MovementModel model) {
+    movementModel = model;
+    DebugLogger::log(std::string("Movement model: ") +
+                   (model == MovementModel::CAR_FOLLOWING ? "car-following" : "fixed speed"));
+}
+
+MovementModel TrafficManager::getMovementModel() const {
+    return movementModel;
+}
+
+void TrafficManager::reset() {
+    for (auto* lane : lanes) {
+        lane->clear();
+    }
+
+    if (trafficLight) {
+        trafficLight->reset();
+    }
+
+    simTime = 0;
+    lastFileCheckTime = 0;
+    lastPriorityUpdateTime = 0;
+    lastDebugTime = 0;
+    lastStatusTime = 0;
+    junctionOverlaps = 0;
+    totalJunctionOverlaps = 0;
+    junctionGrid.clear();
+    laneEntryBlocked.assign(lanes.size(), 0);
+    laneDeparted.assign(lanes.size(), 0);
+    counters.reset();
+    rates.reset();
+    resetStatistics();
+    publishCounters();
+    lastMetricsTime = 0;
+}
+
+void TrafficManager::setFileInputEnabled(bool enabled) {
+    fileInputEnabled = enabled;
+}
+
+bool TrafficManager::injectVehicle(const std::string& line) {
+    if (!fileHandler) {
+        DebugLogger::log("Cannot inject vehicles before initialize()", DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    Vehicle* vehicle = fileHandler->parseVehicleLine(line);
+    if (!vehicle) {
+        return false;
+    }
+
+    addVehicle(vehicle);
+    return true;
+}
+
+void TrafficManager::setSignalTiming(const SignalTiming& timing) {
+    signalTiming = timing;
+
+    for (auto* lane : lanes) {
+        lane->setPriorityThresholds(timing.priorityThresholdHigh, timing.priorityThresholdLow);
+    }
+
+    if (trafficLight) {
+        trafficLight->setTiming(timing);
+    }
+}
+
+const SignalTiming& TrafficManager::getSignalTiming() const {
+    return signalTiming;
+}
+
+void TrafficManager::setSignalController(SignalControllerType type) {
+    controllerType = type;
+
+    if (trafficLight) {
+        trafficLight->setController(SignalController::create(type));
+    }
+}
+
+SignalControllerType TrafficManager::getSignalController() const {
+    return controllerType;
+}
+
+uint32_t TrafficManager::getVehiclesExited() const {
+    return vehiclesExited;
+}
+
+uint32_t TrafficManager::getPriorityModeTime() const {
+    return priorityModeTime;
+}
+
+const std::vector<uint32_t>& TrafficManager::getLaneWaitTimes(size_t laneIndex) const {
+    static const std::vector<uint32_t> empty;
+    return laneIndex < laneWaitTimes.size() ? laneWaitTimes[laneIndex] : empty;
+}
+
+const LatencyHistogram& TrafficManager::getLaneWaitHistogram(size_t laneIndex) const {
+    static const LatencyHistogram empty;
+    return laneIndex < laneWaitHistograms.size() ? laneWaitHistograms[laneIndex] : empty;
+}
+
+const LatencyHistogram& TrafficManager::getLaneIngestLagHistogram(size_t laneIndex) const {
+    static const LatencyHistogram empty;
+    return laneIndex < laneIngestLag.size() ? laneIngestLag[laneIndex] : empty;
+}
+
+std::string TrafficManager::getLatencyReport() const {
+    std::ostringstream report;
+    report << "Latency report (p50 / p95 / p99)\n";
+    report << std::left << std::setw(8) << "lane" << std::right << std::setw(8) << "waits"
+           << std::setw(26) << "wait_s" << std::setw(8) << "stamped" << std::setw(24) << "ingest_lag_ms" << "\n";
+
+    for (size_t i = 0; i < lanes.size(); i++) {
+        const LatencyHistogram& waits = laneWaitHistograms[i];
+        const LatencyHistogram& lags = laneIngestLag[i];
+        if (waits.count() == 0 && lags.count() == 0) {
+            continue;
+        }
+
+        std::ostringstream waitText;
+        std::ostringstream lagText;
+        waitText << std::fixed << std::setprecision(1) << waits.percentile(50) / 1000.0 << " / "
+                 << waits.percentile(95) / 1000.0 << " / " << waits.percentile(99) / 1000.0;
+        lagText << lags.percentile(50) << " / " << lags.percentile(95) << " / " << lags.percentile(99);
+        report << std::left << std::setw(8) << lanes[i]->getName() << std::right << std::setw(8) << waits.count()
+               << std::setw(26) << waitText.str() << std::setw(8) << lags.count() << std::setw(24) << lagText.str() << "\n";
+    }
+
+    report << "All lanes: " << allWaits.count() << " waits, " << std::fixed << std::setprecision(1)
+           << allWaits.percentile(50) / 1000.0 << " / " << allWaits.percentile(95) / 1000.0 << " / "
+           << allWaits.percentile(99) / 1000.0 << " s; " << allIngestLag.count() << " stamped, "
+           << allIngestLag.percentile(50) << " / " << allIngestLag.percentile(95) << " / "
+           << allIngestLag.percentile(99) << " ms\n";
+    return report.str();
+}
+
+void TrafficManager::resetStatistics() {
+    vehiclesExited = 0;
+    priorityModeTime = 0;
+    for (auto& waits : laneWaitTimes) {
+        waits.clear();
+    }
+    for (auto& histogram : laneWaitHistograms) {
+        histogram.clear();
+    }
+    for (auto& histogram : laneIngestLag) {
+        histogram.clear();
+    }
+    allWaits.clear();
+    allIngestLag.clear();
+    frameTimes.clear();
+    for (auto& time : lightStateTime) {
+        time = 0;
+    }
+    emergencyClearanceTimes.clear();
+    stopTotal = 0;
+    stoppedVehicleCount = 0;
+}
+
+double TrafficManager::getMeanStops() const {
+    return stoppedVehicleCount > 0 ? static_cast<double>(stopTotal) / stoppedVehicleCount : 0.0;
+}
+
+void TrafficManager::setExitRecording(bool enabled) {
+    exitRecording = enabled;
+    if (!enabled) {
+        recordedExits.clear();
+    }
+}
+
+void TrafficManager::takeExits(std::vector<VehicleExit>& exits) {
+    exits.clear();
+    exits.swap(recordedExits);
+}
+
+uint32_t TrafficManager::getSimulationTime() const {
+    return simTime;
+}
+
+void TrafficManager::setSeed(uint32_t seed) {
+    rng.seed(seed);
+    DebugLogger::log("Simulation seed set to " + std::to_string(seed));
+}
+
+std::mt19937& TrafficManager::getRandomEngine() {
+    return rng;
+}
+
+const std::vector<uint32_t>& TrafficManager::getEmergencyClearanceTimes() const {
+    return emergencyClearanceTimes;
+}
+
+const TrafficCounters& TrafficManager::getCounters() const {
+    return counters;
+}
+
+CounterSnapshot TrafficManager::getCounterSnapshot() const {
+    return publishedCounters.load();
+}
+
+const TrafficRates& TrafficManager::getRates() const {
+    return rates;
+}
+
+void TrafficManager::publishCounters() {
+    CounterSnapshot snapshot;
+    snapshot.simTime = simTime;
+    snapshot.counters = counters;
+    publishedCounters.store(snapshot);
+
+    if (metricsPublishing && simTime - lastMetricsTime >= Constants::METRICS_PUBLISH_INTERVAL) {
+        publishMetrics();
+        lastMetricsTime = simTime;
+    }
+}
+
+namespace {
+    LatencySummary summarize(const LatencyHistogram& histogram) {
+        LatencySummary summary;
+        summary.count = histogram.count();
+        summary.sum = histogram.sum();
+        summary.p50 = histogram.percentile(50);
+        summary.p95 = histogram.percentile(95);
+        summary.p99 = histogram.percentile(99);
+        summary.max = histogram.max();
+        return summary;
+    }
+}
+
+void TrafficManager::publishMetrics() {
+    MetricsSnapshot snapshot;
+    snapshot.simTime = simTime;
+    snapshot.counters = counters;
+    for (const auto* lane : lanes) {
+        snapshot.vehiclesActive += static_cast<uint32_t>(lane->getVehicleCount());
+    }
+    snapshot.vehiclesExited = vehiclesExited;
+    snapshot.lightState = trafficLight ? static_cast<int32_t>(trafficLight->getCurrentState()) : 0;
+    for (int i = 0; i < MetricsSnapshot::LIGHT_STATE_COUNT; i++) {
+        snapshot.lightStateTime[i] = lightStateTime[i];
+    }
+    snapshot.wait = summarize(allWaits);
+    snapshot.ingestLag = summarize(allIngestLag);
+    snapshot.frameTime = summarize(frameTimes);
+    for (int i = 0; i < MemoryAccounting::TAG_COUNT; i++) {
+        snapshot.memory[i] = MemoryAccounting::getStats(static_cast<MemoryTag>(i));
+    }
+    publishedMetrics.store(snapshot);
+}
+
+void TrafficManager::setMetricsPublishing(bool enabled) {
+    metricsPublishing = enabled;
+    if (enabled) {
+        publishMetrics();
+        lastMetricsTime = simTime;
+    }
+}
+
+MetricsSnapshot TrafficManager::getMetricsSnapshot() const {
+    return publishedMetrics.load();
+}
+
+void TrafficManager::recordFrameTime(uint32_t microseconds) {
+    frameTimes.record(microseconds);
+}
+
+namespace {
+    const char SERIES_ROADS[] = {'A', 'B', 'C', 'D'};
+}
+
+std::vector<std::string> TrafficManager::seriesColumns() {
+    std::vector<std::string> columns = {"time_ms", "light_state"};
+    for (char road : SERIES_ROADS) {
+        for (int lane = 1; lane <= TrafficCounters::LANES_PER_ROAD; lane++) {
+            const std::string name = std::string(1, road) + std::to_string(lane);
+            columns.push_back(name + "_queue");
+            columns.push_back(name + "_arrivals");
+            columns.push_back(name + "_departures");
+        }
+    }
+    return columns;
+}
+
+void TrafficManager::setSeriesRecorder(TimeSeriesRecorder* recorder, uint32_t intervalMs) {
+    seriesRecorder = recorder;
+    seriesInterval = intervalMs;
+    // Samples fall on multiples of the interval, so runs (and restored runs) line up
+    lastSeriesTime = intervalMs == 0 ? simTime : simTime - simTime % intervalMs;
+}
+
+void TrafficManager::recordSeries() {
+    // Same order as seriesColumns()
+    int64_t row[2 + TrafficCounters::ROAD_COUNT * TrafficCounters::LANES_PER_ROAD * 3];
+    size_t column = 0;
+    row[column++] = simTime;
+    row[column++] = trafficLight ? static_cast<int64_t>(trafficLight->getCurrentState()) : 0;
+    for (char road : SERIES_ROADS) {
+        for (int lane = 1; lane <= TrafficCounters::LANES_PER_ROAD; lane++) {
+            const FlowCounters& flow = counters.lane(road, lane);
+            row[column++] = flow.queued;
+            row[column++] = flow.arrivals;
+            row[column++] = flow.departures;
+        }
+    }
+    seriesRecorder->append(row);
+}
+
+bool TrafficManager::saveSnapshot(const std::string& path) const {
+    if (!trafficLight) {
+        DebugLogger::log("Cannot save snapshot before initialize()", DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    // Serialize the payload first so the header can carry its size and checksum
+    std::ostringstream payload(std::ios::binary);
+
+    BinaryIO::write(payload, simTime);
+    BinaryIO::write(payload, lastFileCheckTime);
+    BinaryIO::write(payload, lastPriorityUpdateTime);
+    BinaryIO::write(payload, lastDebugTime);
+    BinaryIO::write(payload, lastStatusTime);
+    BinaryIO::writeEnum(payload, movementModel);
+    BinaryIO::write(payload, static_cast<int32_t>(junctionOverlaps));
+    BinaryIO::write(payload, static_cast<int32_t>(totalJunctionOverlaps));
+
+    // The standard text form of mt19937 is portable and exact
+    std::ostringstream rngState;
+    rngState << rng;
+    BinaryIO::writeString(payload, rngState.str());
+
+    trafficLight->saveState(payload);
+
+    BinaryIO::write(payload, static_cast<uint32_t>(lanes.size()));
+    for (auto* lane : lanes) {
+        BinaryIO::write(payload, lane->getLaneId());
+        BinaryIO::write(payload, static_cast<int32_t>(lane->getLaneNumber()));
+        lane->saveState(payload);
+    }
+
+    rates.saveState(payload);
+
+    const std::string data = payload.str();
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        DebugLogger::log("Failed to open snapshot file for writing: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    BinaryIO::write(file, Constants::SNAPSHOT_MAGIC);
+    BinaryIO::write(file, Constants::SNAPSHOT_VERSION);
+    BinaryIO::write(file, static_cast<uint64_t>(data.size()));
+    BinaryIO::write(file, BinaryIO::checksum(data.data(), data.size()));
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    if (!file) {
+        DebugLogger::log("Failed to write snapshot: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    std::ostringstream oss;
+    oss << "Saved snapshot to " << path << " (" << data.size() << " bytes, t=" << simTime << " ms)";
+    DebugLogger::log(oss.str());
+    return true;
+}
+
+namespace {
+    // Scalar state at the start of a snapshot payload
+    struct SnapshotHeader {
+        uint32_t simTime = 0;
+        uint32_t lastFileCheckTime = 0;
+        uint32_t lastPriorityUpdateTime = 0;
+        uint32_t lastDebugTime = 0;
+        uint32_t lastStatusTime = 0;
+        MovementModel movementModel = MovementModel::CAR_FOLLOWING;
+        int32_t overlaps = 0;
+        int32_t totalOverlaps = 0;
+        std::mt19937 rng;
+    };
+
+    // Decode a payload into header, light, the lanes laneFor returns (nullptr
+    // for an unknown lane) and rates. Stops at the first invalid section.
+    template<typename LaneLookup>
+    bool decodeSnapshot(std::istream& payload, SnapshotHeader& header, TrafficLight& light,
+                        LaneLookup laneFor, TrafficRates& rates) {
+        std::string rngState;
+        bool ok = BinaryIO::read(payload, header.simTime) &&
+                  BinaryIO::read(payload, header.lastFileCheckTime) &&
+                  BinaryIO::read(payload, header.lastPriorityUpdateTime) &&
+                  BinaryIO::read(payload, header.lastDebugTime) &&
+                  BinaryIO::read(payload, header.lastStatusTime) &&
+                  BinaryIO::readEnum(payload, header.movementModel, MovementModel::CAR_FOLLOWING) &&
+                  BinaryIO::read(payload, header.overlaps) &&
+                  BinaryIO::read(payload, header.totalOverlaps) &&
+                  BinaryIO::readString(payload, rngState);
+
+        if (ok) {
+            std::istringstream rngStream(rngState);
+            rngStream >> header.rng;
+            ok = !rngStream.fail();
+        }
+
+        ok = ok && light.loadState(payload);
+
+        uint32_t laneCount = 0;
+        ok = ok && BinaryIO::read(payload, laneCount);
+        for (uint32_t i = 0; ok && i < laneCount; i++) {
+            char laneId = 0;
+            int32_t laneNumber = 0;
+            ok = BinaryIO::read(payload, laneId) && BinaryIO::read(payload, laneNumber);
+
+            Lane* lane = ok ? laneFor(laneId, laneNumber) : nullptr;
+            ok = lane && lane->loadState(payload);
+        }
+
+        return ok && rates.loadState(payload);
+    }
+}
+
+bool TrafficManager::loadSnapshot(const std::string& path) {
+    if (!trafficLight) {
+        DebugLogger::log("Cannot load snapshot before initialize()", DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        DebugLogger::log("Failed to open snapshot file: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t size = 0;
+    uint64_t checksum = 0;
+    if (!BinaryIO::read(file, magic) || !BinaryIO::read(file, version) ||
+        !BinaryIO::read(file, size) || !BinaryIO::read(file, checksum)) {
+        DebugLogger::log("Snapshot header is truncated: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    if (magic != Constants::SNAPSHOT_MAGIC) {
+        DebugLogger::log("Not a simulation snapshot: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    if (version != Constants::SNAPSHOT_VERSION) {
+        DebugLogger::log("Unsupported snapshot version " + std::to_string(version) + " (expected " +
+                       std::to_string(Constants::SNAPSHOT_VERSION) + ")", DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    // The payload must be the rest of the file; checked before allocating
+    // so a damaged size field cannot ask for gigabytes
+    const std::streampos payloadStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff available = file.tellg() - payloadStart;
+    file.seekg(payloadStart);
+    if (!file || available < 0 || size != static_cast<uint64_t>(available)) {
+        DebugLogger::log("Snapshot is truncated or corrupted: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    // Verify the whole payload before touching any state
+    std::string data(static_cast<size_t>(size), '\0');
+    file.read(&data[0], static_cast<std::streamsize>(size));
+    if (!file || BinaryIO::checksum(data.data(), data.size()) != checksum) {
+        DebugLogger::log("Snapshot is truncated or corrupted: " + path, DebugLogger::LogLevel::ERROR);
+        return false;
+    }
+
+    // Decode everything into scratch objects first: a payload that is intact
+    // but invalid further in must leave the running simulation untouched
+    SnapshotHeader header;
+    {
+        std::istringstream payload(data, std::ios::binary);
+        TrafficLight scratchLight;
+        TrafficRates scratchRates;
+        std::vector<Lane*> scratchLanes;
+        auto scratchLane = [&](char laneId, int laneNumber) -> Lane* {
+            if (!findLane(laneId, laneNumber)) {
+                return nullptr;
+            }
+            scratchLanes.push_back(new Lane(laneId, laneNumber));
+            return scratchLanes.back();
+        };
+
+        const bool ok = decodeSnapshot(payload, header, scratchLight, scratchLane, scratchRates);
+        for (auto* lane : scratchLanes) {
+            delete lane;
+        }
+        if (!ok) {
+            DebugLogger::log("Snapshot payload is invalid: " + path, DebugLogger::LogLevel::ERROR);
+            return false;
+        }
+    }
+
+    // Valid: decode it again into the live state (this cannot fail now)
+    std::istringstream payload(data, std::ios::binary);
+    auto liveLane = [this](char laneId, int laneNumber) { return findLane(laneId, laneNumber); };
+    decodeSnapshot(payload, header, *trafficLight, liveLane, rates);
+
+    simTime = header.simTime;
+    lastFileCheckTime = header.lastFileCheckTime;
+    lastPriorityUpdateTime = header.lastPriorityUpdateTime;
+    lastDebugTime = header.lastDebugTime;
+    lastStatusTime = header.lastStatusTime;
+    movementModel = header.movementModel;
+    rng = header.rng;
+    controllerType = trafficLight->getController()->getType();
+
+    junctionOverlaps = header.overlaps;
+    totalJunctionOverlaps = header.totalOverlaps;
+    laneEntryBlocked.assign(lanes.size(), 0);
+    recountDepartures();
+    publishCounters();
+
+    int vehicleCount = 0;
+    for (auto* lane : lanes) {
+        vehicleCount += lane->getVehicleCount();
+    }
+    std::ostringstream oss;
+    oss << "Restored snapshot " << path << " at t=" << simTime << " ms with " << vehicleCount << " vehicles";
+    DebugLogger::log(oss.str());
+    return true;
+}
+
 const std::vector<Lane*>& TrafficManager::getLanes() const {
     return lanes;
 }
@@ -368,6 +1062,13 @@ std::string TrafficManager::getStatistics() const {
         totalVehicles += count;
 
         stats << lane->getName() << ": " << count << " vehicles";
+        // Vehicles only join lanes 2 and 3; rates in vehicles per minute
+        if (lane->getLaneNumber() != 1) {
+            stats << std::fixed << std::setprecision(1)
+                  << ", in " << 60.0 * rates.arrivalRate(lane->getLaneId(), lane->getLaneNumber(), simTime)
+                  << " out " << 60.0 * rates.departureRate(lane->getLaneId(), lane->getLaneNumber(), simTime)
+                  << "/min";
+        }
         if (lane->isPriorityLane() && lane->getPriority() > 0) {
             stats << " (PRIORITY)";
         }
@@ -375,6 +1076,30 @@ std::string TrafficManager::getStatistics() const {
     }
 
     stats << "Total Vehicles: " << totalVehicles << "\n";
+    stats << "Exited Vehicles: " << vehiclesExited << "\n";
+    stats << "Stops: " << getMeanStops() << " per vehicle\n";
+
+    if (allWaits.count() > 0) {
+        stats << "Wait p50/p95/p99: " << allWaits.percentile(50) / 1000.0 << " / "
+              << allWaits.percentile(95) / 1000.0 << " / " << allWaits.percentile(99) / 1000.0 << " s\n";
+    }
+    if (allIngestLag.count() > 0) {
+        stats << "Ingest lag p50/p95/p99: " << allIngestLag.percentile(50) << " / "
+              << allIngestLag.percentile(95) << " / " << allIngestLag.percentile(99) << " ms\n";
+    }
+
+    int heldLanes = 0;
+    for (char blocked : laneEntryBlocked) {
+        heldLanes += blocked ? 1 : 0;
+    }
+    if (!emergencyClearanceTimes.empty()) {
+        uint32_t longest = *std::max_element(emergencyClearanceTimes.begin(), emergencyClearanceTimes.end());
+        stats << "Emergency: " << emergencyClearanceTimes.size() << " cleared, mean "
+              << Statistics::mean(emergencyClearanceTimes) / 1000.0 << " s, max " << longest / 1000.0 << " s\n";
+    }
+
+    stats << "Junction: " << junctionGrid.size() << " vehicles, " << heldLanes
+          << " lanes held, " << totalJunctionOverlaps << " overlaps\n";
 
     // Add traffic light status
     if (trafficLight) {
@@ -385,6 +1110,13 @@ std::string TrafficManager::getStatistics() const {
             case TrafficLight::State::B_GREEN: stats << "B GREEN"; break;
             case TrafficLight::State::C_GREEN: stats << "C GREEN"; break;
             case TrafficLight::State::D_GREEN: stats << "D GREEN"; break;
+            case TrafficLight::State::PHASE:
+                stats << "PHASE " << ConflictMatrix::describe(trafficLight->getGreenMovements());
+                break;
+        }
+        stats << " (" << signalControllerName(controllerType) << ")";
+        if (trafficLight->getPreemptedRoad() != ' ') {
+            stats << " PREEMPTED " << trafficLight->getPreemptedRoad();
         }
         stats << "\n";
     }
@@ -446,41 +1178,80 @@ void TrafficManager::limitVehiclesPerLane() {
 
 
 
-void TrafficManager::preventVehicleOverlap() {
-    // For each lane, check for vehicles that are too close to each other
+void TrafficManager::rebuildJunctionGrid() {
+    junctionGrid.clear();
+
+    // O(n): every vehicle is bucketed once; vehicles outside the junction area are skipped
     for (auto* lane : lanes) {
-        const auto& vehicles = lane->getVehicles();
+        for (auto* vehicle : lane->getVehicles()) {
+            if (vehicle) {
+                junctionGrid.insert({vehicle, lane}, vehicle->getTurnPosX(), vehicle->getTurnPosY());
+            }
+        }
+    }
 
-        // Skip if fewer than 2 vehicles
-        if (vehicles.size() < 2) continue;
+    junctionGrid.build();
+}
 
-        // Check each vehicle against others in the lane
-        for (size_t i = 0; i < vehicles.size() - 1; i++) {
-            Vehicle* current = vehicles[i];
-            Vehicle* next = vehicles[i+1];
+bool TrafficManager::isJunctionEntryClear(const Lane* lane) const {
+    // Find the first vehicle of this lane that still has to enter the junction
+    const Vehicle* next = nullptr;
+    for (auto* vehicle : lane->getVehicles()) {
+        if (vehicle && !vehicle->hasPassedStopLine()) {
+            next = vehicle;
+            break;
+        }
+    }
 
-            if (!current || !next) continue;
+    if (!next) {
+        return true;
+    }
 
-            // Calculate distance between vehicles
-            float dx = current->getTurnPosX() - next->getTurnPosX();
-            float dy = current->getTurnPosY() - next->getTurnPosY();
-            float distance = std::sqrt(dx*dx + dy*dy);
+    // The entry is blocked by committed vehicles from other lanes that are
+    // still inside the junction box near the stop line
+    const float centerX = Constants::WINDOW_WIDTH / 2.0f;
+    const float centerY = Constants::WINDOW_HEIGHT / 2.0f;
+    Point stopLine = next->getStopLinePoint();
+    bool clear = true;
+    junctionGrid.forEachNeighbor(stopLine.x, stopLine.y, Constants::JUNCTION_CLEARANCE,
+        [&](const JunctionOccupant& occupant, float) {
+            if (occupant.lane == lane || !occupant.vehicle->hasPassedStopLine()) {
+                return;
+            }
 
-            // Minimum distance between vehicles
-            const float MIN_DISTANCE = 35.0f;
+            float dx = std::fabs(occupant.vehicle->getTurnPosX() - centerX);
+            float dy = std::fabs(occupant.vehicle->getTurnPosY() - centerY);
+            if (dx <= Constants::INTERSECTION_HALF_SIZE && dy <= Constants::INTERSECTION_HALF_SIZE) {
+                clear = false;
+            }
+        });
 
-            // If too close, adjust next vehicle position
-            if (distance < MIN_DISTANCE) {
-                // Normalize direction vector
-                float normalize = distance > 0 ? distance : 1.0f;
-                dx /= normalize;
-                dy /= normalize;
+    return clear;
+}
 
-                // Move next vehicle back to maintain spacing
-                float moveDistance = MIN_DISTANCE - distance;
-                next->setTurnPosX(next->getTurnPosX() - dx * moveDistance);
-                next->setTurnPosY(next->getTurnPosY() - dy * moveDistance);
-            }
-        }
+void TrafficManager::preventVehicleOverlap() {
+    // Hold lanes whose junction entry is occupied by crossing traffic
+    for (size_t i = 0; i < lanes.size() && i < laneEntryBlocked.size(); i++) {
+        laneEntryBlocked[i] = isJunctionEntryClear(lanes[i]) ? 0 : 1;
+    }
+
+    // Count vehicles from different lanes that overlap inside the junction
+    int overlaps = 0;
+    junctionGrid.forEach([&](const JunctionOccupant& occupant, float x, float y) {
+        junctionGrid.forEachNeighbor(x, y, Constants::JUNCTION_MIN_SEPARATION,
+            [&](const JunctionOccupant& other, float) {
+                // Each pair is seen from both sides - count it once
+                if (other.lane != occupant.lane && occupant.vehicle < other.vehicle) {
+                    overlaps++;
+                }
+            });
+    });
+
+    // Log only when a new overlap appears
+    if (overlaps > junctionOverlaps) {
+        totalJunctionOverlaps += overlaps - junctionOverlaps;
+        DebugLogger::log("Junction overlap detected: " + std::to_string(overlaps) +
+                       " vehicle pair(s) from different lanes", DebugLogger::LogLevel::WARNING);
     }
+    junctionOverlaps = overlaps;
 }
@@ -0,0 +1,450 @@
+// FILE: src/saturation_benchmark.cpp
+// End-to-end throughput benchmark: drives generated arrivals through ingest,
+// the lanes, the signal controller and out of the junction at increasing
+// arrival rates, and reports the saturation point, the highest rate the
+// junction sustains before its queues diverge or a simulation step exceeds
+// its wall-time budget. Compared against a stored baseline it fails when the
+// sustained throughput dropped by more than a set percentage.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <cmath>
+
+#include "managers/TrafficManager.h"
+#include "managers/ArrivalGenerator.h"
+#include "core/SignalController.h"
+#include "utils/DebugLogger.h"
+#include "utils/PerfCounters.h"
+#include "utils/Statistics.h"
+
+struct SaturationOptions {
+    SignalControllerType controller = SignalControllerType::QUEUE_AVERAGE;
+    MovementModel model = MovementModel::FIXED_SPEED;
+    uint32_t seed = 1;
+    uint32_t stepMs = 16;
+    double rateStart = 0.05;        // Arrivals per second of the first run
+    double rateStep = 0.05;
+    double rateMax = 3.0;
+    int refineSteps = 3;            // Bisections between the last stable and first unstable rate
+    uint32_t warmupMs = 120000;     // Simulated time before measuring
+    uint32_t measureMs = 600000;    // Simulated time measured
+    double maxQueueGrowth = 0.02;   // Queue growth (vehicles/s) still counted as stable
+    double tickBudgetMs = 4.0;      // p99 wall time one simulation step may take
+    std::string outputPath;         // JSON results
+    std::string baselinePath;       // Compare against this result
+    double maxRegressionPct = 10.0;
+    bool perfCounters = false;      // Sample hardware counters per stage
+};
+
+// Outcome of one arrival rate
+struct RatePoint {
+    double rate = 0.0;              // Offered arrivals per second
+    double throughput = 0.0;        // Exits per second while measuring
+    double queueGrowth = 0.0;       // Least-squares slope of the queued vehicles, per second
+    uint32_t queuedAtEnd = 0;
+    double tickP99Ms = 0.0;
+    double tickMeanMs = 0.0;
+    bool stable = false;
+};
+
+struct SaturationResult {
+    std::vector<RatePoint> points;  // In the order they were run
+    bool saturated = false;         // An unstable rate was found below rateMax
+    double saturationRate = 0.0;    // Highest stable rate
+    double saturationThroughput = 0.0;
+    std::string limit;              // What made the next rate unstable
+};
+
+namespace {
+    // Slope of evenly spaced samples, per sample interval
+    double leastSquaresSlope(const std::vector<double>& samples) {
+        const size_t n = samples.size();
+        if (n < 2) {
+            return 0.0;
+        }
+        const double meanX = (n - 1) / 2.0;
+        const double meanY = Statistics::mean(samples);
+        double covariance = 0.0;
+        double variance = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            covariance += (i - meanX) * (samples[i] - meanY);
+            variance += (i - meanX) * (i - meanX);
+        }
+        return covariance / variance;
+    }
+
+    int32_t totalQueued(const TrafficCounters& counters) {
+        int32_t queued = 0;
+        for (char road : {'A', 'B', 'C', 'D'}) {
+            queued += counters.road(road).queued;
+        }
+        return queued;
+    }
+
+    // Value of "key": in a flat JSON object written by writeResult (the
+    // baseline format); the text between the colon and the next , or }
+    bool readJsonValue(const std::string& json, const std::string& key, std::string& value) {
+        const size_t keyPos = json.find("\"" + key + "\"");
+        if (keyPos == std::string::npos) {
+            return false;
+        }
+        const size_t colon = json.find(':', keyPos);
+        if (colon == std::string::npos) {
+            return false;
+        }
+        const size_t end = json.find_first_of(",}\n", colon);
+        value = json.substr(colon + 1, end == std::string::npos ? std::string::npos : end - colon - 1);
+        const size_t first = value.find_first_not_of(" \t\"");
+        const size_t last = value.find_last_not_of(" \t\"\r");
+        value = first == std::string::npos ? "" : value.substr(first, last - first + 1);
+        return true;
+    }
+}
+
+void printUsage() {
+    std::cout <<
+        "Usage: saturation_benchmark [options]\n"
+        "  --controller NAME  signal controller (default queue)\n"
+        "  --model idm|fixed  movement model (default fixed)\n"
+        "  --seed N           seed of the arrivals and the simulation (default 1)\n"
+        "  --step MS          simulation step in ms (default 16)\n"
+        "  --rates A:S:B      arrival rates in vehicles/s, from A in steps of S up to B\n"
+        "                     (default 0.05:0.05:3)\n"
+        "  --refine N         bisections around the saturation point (default 3)\n"
+        "  --warmup S         simulated seconds before measuring (default 120)\n"
+        "  --measure S        simulated seconds measured per rate (default 600)\n"
+        "  --max-growth V     queue growth in vehicles/s still counted as stable (default 0.02)\n"
+        "  --tick-budget MS   p99 wall time a simulation step may take (default 4)\n"
+        "  --out FILE         write the result as JSON (usable as a baseline)\n"
+        "  --baseline FILE    compare the saturation throughput with a stored result\n"
+        "  --max-regression P fail when it dropped by more than P percent (default 10)\n"
+        "  --perf-counters    sample hardware counters per simulation stage (Linux)\n"
+        "Exits with 2 when the throughput regressed against the baseline.\n";
+}
+
+bool parseOptions(int argc, char* argv[], SaturationOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (arg == "--perf-counters") {
+            options.perfCounters = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--controller") {
+            if (!parseSignalControllerType(value, options.controller)) {
+                std::cerr << "Unknown signal controller " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--model") options.model = (value == "fixed") ? MovementModel::FIXED_SPEED : MovementModel::CAR_FOLLOWING;
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--step") options.stepMs = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--rates") {
+            std::stringstream ss(value);
+            std::string start, step, max;
+            if (!std::getline(ss, start, ':') || !std::getline(ss, step, ':') || !std::getline(ss, max)) {
+                std::cerr << "Rates must be START:STEP:MAX" << std::endl;
+                return false;
+            }
+            options.rateStart = std::stod(start);
+            options.rateStep = std::stod(step);
+            options.rateMax = std::stod(max);
+        }
+        else if (arg == "--refine") options.refineSteps = std::stoi(value);
+        else if (arg == "--warmup") options.warmupMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--measure") options.measureMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--max-growth") options.maxQueueGrowth = std::stod(value);
+        else if (arg == "--tick-budget") options.tickBudgetMs = std::stod(value);
+        else if (arg == "--out") options.outputPath = value;
+        else if (arg == "--baseline") options.baselinePath = value;
+        else if (arg == "--max-regression") options.maxRegressionPct = std::stod(value);
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.stepMs == 0 || options.rateStart <= 0.0 || options.rateStep <= 0.0 ||
+        options.rateMax < options.rateStart || options.measureMs < 10000 || options.refineSteps < 0) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Run the whole pipeline at one arrival rate
+bool runRate(double rate, const SaturationOptions& options, RatePoint& point) {
+    TrafficManager manager;
+    manager.setFileInputEnabled(false);
+    manager.setMovementModel(options.model);
+    manager.setSignalController(options.controller);
+    if (!manager.initialize()) {
+        return false;
+    }
+    manager.setSeed(options.seed);
+    manager.start();
+
+    std::mt19937 rng(options.seed);
+    ArrivalGenerator generator(static_cast<float>(1000.0 / rate));
+    std::vector<std::string> lines;
+
+    point.rate = rate;
+    uint32_t exitedAtStart = 0;
+    std::vector<double> queued;          // Sampled every simulated second while measuring
+    std::vector<double> tickMs;
+    tickMs.reserve(options.measureMs / options.stepMs + 1);
+
+    const uint32_t endMs = options.warmupMs + options.measureMs;
+    uint32_t nextSample = options.warmupMs;
+    for (uint32_t time = 0; time < endMs; time += options.stepMs) {
+        lines.clear();
+        generator.update(options.stepMs, rng, lines);
+        for (const auto& line : lines) {
+            manager.injectVehicle(line);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        manager.update(options.stepMs);
+        const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        if (time < options.warmupMs) {
+            exitedAtStart = manager.getVehiclesExited();
+            continue;
+        }
+        tickMs.push_back(elapsedMs);
+        if (time >= nextSample) {
+            queued.push_back(totalQueued(manager.getCounters()));
+            nextSample += 1000;
+        }
+    }
+
+    point.throughput = (manager.getVehiclesExited() - exitedAtStart) / (options.measureMs / 1000.0);
+    point.queueGrowth = leastSquaresSlope(queued);
+    point.queuedAtEnd = static_cast<uint32_t>(std::max(0, totalQueued(manager.getCounters())));
+    point.tickMeanMs = Statistics::mean(tickMs);
+    point.tickP99Ms = Statistics::percentile(tickMs, 99.0);
+    point.stable = point.queueGrowth <= options.maxQueueGrowth && point.tickP99Ms <= options.tickBudgetMs;
+    return true;
+}
+
+// Why a rate was unstable
+std::string limitOf(const RatePoint& point, const SaturationOptions& options) {
+    std::ostringstream reason;
+    reason << std::fixed << std::setprecision(3);
+    if (point.queueGrowth > options.maxQueueGrowth) {
+        reason << "queues grow by " << point.queueGrowth << " vehicles/s";
+    } else {
+        reason << "tick p99 " << point.tickP99Ms << " ms over the " << options.tickBudgetMs << " ms budget";
+    }
+    return reason.str();
+}
+
+void printPoint(const RatePoint& point) {
+    std::cout << std::fixed << std::setprecision(3)
+              << std::setw(9) << point.rate << std::setw(12) << point.throughput
+              << std::setw(12) << point.queueGrowth << std::setw(9) << point.queuedAtEnd
+              << std::setw(11) << point.tickMeanMs << std::setw(11) << point.tickP99Ms
+              << "  " << (point.stable ? "stable" : "unstable") << std::endl;
+}
+
+// Sweep the rates upwards until one is unstable, then bisect towards the saturation point
+bool findSaturation(const SaturationOptions& options, SaturationResult& result) {
+    std::cout << std::setw(9) << "rate/s" << std::setw(12) << "exits/s" << std::setw(12) << "growth/s"
+              << std::setw(9) << "queued" << std::setw(11) << "tick_ms" << std::setw(11) << "tick_p99"
+              << "  state" << std::endl;
+
+    RatePoint best;
+    bool anyStable = false;
+    double unstableRate = 0.0;
+    const int steps = static_cast<int>(std::floor((options.rateMax - options.rateStart) / options.rateStep + 1e-9));
+    for (int i = 0; i <= steps; i++) {
+        RatePoint point;
+        if (!runRate(options.rateStart + i * options.rateStep, options, point)) {
+            return false;
+        }
+        result.points.push_back(point);
+        printPoint(point);
+        if (!point.stable) {
+            result.saturated = true;
+            result.limit = limitOf(point, options);
+            unstableRate = point.rate;
+            break;
+        }
+        best = point;
+        anyStable = true;
+    }
+
+    if (result.saturated && anyStable) {
+        double low = best.rate;
+        double high = unstableRate;
+        for (int i = 0; i < options.refineSteps; i++) {
+            RatePoint point;
+            if (!runRate((low + high) / 2.0, options, point)) {
+                return false;
+            }
+            result.points.push_back(point);
+            printPoint(point);
+            if (point.stable) {
+                best = point;
+                low = point.rate;
+            } else {
+                result.limit = limitOf(point, options);
+                high = point.rate;
+            }
+        }
+    }
+
+    result.saturationRate = best.rate;
+    result.saturationThroughput = best.throughput;
+    return true;
+}
+
+bool writeResult(const std::string& path, const SaturationOptions& options, const SaturationResult& result) {
+    std::ofstream json(path);
+    if (!json.is_open()) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+
+    json << std::fixed << std::setprecision(4);
+    json << "{\n"
+         << "  \"controller\": \"" << signalControllerName(options.controller) << "\",\n"
+         << "  \"model\": \"" << (options.model == MovementModel::FIXED_SPEED ? "fixed" : "idm") << "\",\n"
+         << "  \"seed\": " << options.seed << ",\n"
+         << "  \"step_ms\": " << options.stepMs << ",\n"
+         << "  \"warmup_s\": " << options.warmupMs / 1000.0 << ",\n"
+         << "  \"measure_s\": " << options.measureMs / 1000.0 << ",\n"
+         << "  \"max_queue_growth\": " << options.maxQueueGrowth << ",\n"
+         << "  \"tick_budget_ms\": " << options.tickBudgetMs << ",\n"
+         << "  \"saturated\": " << (result.saturated ? "true" : "false") << ",\n"
+         << "  \"saturation_rate\": " << result.saturationRate << ",\n"
+         << "  \"saturation_throughput\": " << result.saturationThroughput << ",\n"
+         << "  \"limit\": \"" << result.limit << "\",\n"
+         << "  \"points\": [";
+    for (size_t i = 0; i < result.points.size(); i++) {
+        const RatePoint& point = result.points[i];
+        json << (i == 0 ? "\n" : ",\n")
+             << "    {\"rate\": " << point.rate << ", \"throughput\": " << point.throughput
+             << ", \"queue_growth\": " << point.queueGrowth << ", \"queued_at_end\": " << point.queuedAtEnd
+             << ", \"tick_mean_ms\": " << point.tickMeanMs << ", \"tick_p99_ms\": " << point.tickP99Ms
+             << ", \"stable\": " << (point.stable ? "true" : "false") << "}";
+    }
+    json << "\n  ]\n}\n";
+    return true;
+}
+
+// Compare with the baseline; false when the throughput regressed
+bool checkBaseline(const std::string& path, const SaturationOptions& options, const SaturationResult& result) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open baseline " + path);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string json = buffer.str();
+
+    std::string value;
+    if (!readJsonValue(json, "saturation_throughput", value)) {
+        throw std::runtime_error("No saturation_throughput in baseline " + path);
+    }
+    const double baseline = std::stod(value);
+
+    // Results of another scenario are not comparable; say so, but still compare
+    const std::string expected[][2] = {
+        {"controller", signalControllerName(options.controller)},
+        {"model", options.model == MovementModel::FIXED_SPEED ? "fixed" : "idm"},
+        {"seed", std::to_string(options.seed)},
+        {"step_ms", std::to_string(options.stepMs)},
+    };
+    for (const auto& setting : expected) {
+        if (readJsonValue(json, setting[0], value) && value != setting[1]) {
+            std::cout << "Warning: baseline " << setting[0] << " is " << value << ", this run used "
+                      << setting[1] << std::endl;
+        }
+    }
+
+    const double change = baseline > 0.0 ? 100.0 * (result.saturationThroughput / baseline - 1.0) : 0.0;
+    std::cout << std::fixed << std::setprecision(3)
+              << "Baseline " << baseline << " vehicles/s, now " << result.saturationThroughput
+              << " (" << std::showpos << std::setprecision(1) << change << std::noshowpos << "%)" << std::endl;
+
+    if (change < -options.maxRegressionPct) {
+        std::cout << "REGRESSION: throughput dropped by more than " << options.maxRegressionPct << "%" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        SaturationOptions options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        DebugLogger::setEnabled(false);
+
+        if (options.perfCounters) {
+            std::string error;
+            if (!PerfCounters::enable(error)) {
+                std::cerr << "Hardware counters unavailable: " << error << std::endl;
+            }
+        }
+
+        std::cout << "Saturation sweep of the " << signalControllerName(options.controller) << " controller, "
+                  << options.measureMs / 1000.0 << " s measured per rate" << std::endl;
+
+        SaturationResult result;
+        if (!findSaturation(options, result)) {
+            std::cerr << "Failed to initialize a simulation" << std::endl;
+            return 1;
+        }
+
+        std::cout << std::fixed << std::setprecision(3);
+        if (result.saturated) {
+            std::cout << "Saturation at " << result.saturationRate << " arrivals/s, sustained throughput "
+                      << result.saturationThroughput << " vehicles/s (next rate: " << result.limit << ")" << std::endl;
+        } else {
+            std::cout << "Not saturated up to " << result.saturationRate << " arrivals/s, throughput "
+                      << result.saturationThroughput << " vehicles/s" << std::endl;
+        }
+
+        if (PerfCounters::isEnabled()) {
+            PerfCounters::disable();
+            std::cout << "Hardware counters per stage:\n" << PerfCounters::getReport();
+        }
+
+        if (!options.outputPath.empty()) {
+            if (!writeResult(options.outputPath, options, result)) {
+                return 1;
+            }
+            std::cout << "Result written to " << options.outputPath << std::endl;
+        }
+
+        if (!options.baselinePath.empty() && !checkBaseline(options.baselinePath, options, result)) {
+            return 2;
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,314 @@
+// FILE: src/signal_benchmark.cpp
+// Headless comparison of the signal controllers: replays one recorded arrival
+// trace through every policy and reports average delay and throughput.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+
+#include "managers/TrafficManager.h"
+#include "managers/ArrivalTrace.h"
+#include "core/SignalController.h"
+#include "core/QTable.h"
+#include "utils/DebugLogger.h"
+#include "utils/Statistics.h"
+
+struct BenchmarkOptions {
+    std::string tracePath;          // Replay this trace instead of generating one
+    std::string recordPath;         // Save the generated trace here
+    std::string outputPath;         // Optional CSV of the results
+    std::string timingPath;         // Optional signal timing file
+    std::string qtablePath;         // Q-table of the qlearning controller
+    uint32_t durationMs = 1800000;  // Generated trace length / simulated time
+    bool durationSet = false;
+    uint32_t stepMs = 16;
+    uint32_t seed = 1;
+    float arrivalIntervalMs = 2000.0f;
+    int initialPriorityVehicles = 12;
+    float emergencyShare = 0.0f;
+    MovementModel model = MovementModel::FIXED_SPEED;
+    std::vector<SignalControllerType> controllers = {
+        SignalControllerType::FIXED_TIME,
+        SignalControllerType::QUEUE_AVERAGE,
+        SignalControllerType::ACTUATED,
+        SignalControllerType::MAX_PRESSURE
+    };
+};
+
+// Results of one controller on the trace
+struct BenchmarkResult {
+    SignalControllerType controller;
+    uint32_t arrived = 0;
+    uint32_t exited = 0;
+    uint32_t stillQueued = 0;        // Controlled-lane vehicles that never got through
+    double meanDelayS = 0.0;
+    double p95DelayS = 0.0;
+    double throughputPerHour = 0.0;
+    uint32_t emergencies = 0;        // Emergency vehicles that cleared an L2 stop line
+    double meanEmergencyS = 0.0;     // Their mean clearance latency
+    double maxEmergencyS = 0.0;
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: signal_benchmark [options]\n"
+        "  --trace FILE       replay a recorded trace (\"time_ms vehicle_line\" per line)\n"
+        "  --record FILE      save the generated trace to FILE\n"
+        "  --duration S       simulated seconds (default 1800, or the trace length)\n"
+        "  --seed N           seed of the generated trace and the simulation (default 1)\n"
+        "  --interval MS      mean time between generated arrivals (default 2000)\n"
+        "  --burst N          A2 vehicles at the start of a generated trace (default 12)\n"
+        "  --emergency P      fraction of generated vehicles that are emergency vehicles (default 0)\n"
+        "  --step MS          simulation step in ms (default 16)\n"
+        "  --model idm|fixed  movement model (default fixed)\n"
+        "  --controller LIST  controllers to compare (default fixed,queue,actuated,pressure;\n"
+        "                     also phased, phased-single, webster, coordinated,\n"
+        "                     qlearning)\n"
+        "  --timing FILE      signal timing file (e.g. from signal_optimizer)\n"
+        "  --qtable FILE      Q-table of the qlearning controller (from signal_train)\n"
+        "  --out FILE         also write the results as CSV\n";
+}
+
+bool parseOptions(int argc, char* argv[], BenchmarkOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--trace") options.tracePath = value;
+        else if (arg == "--record") options.recordPath = value;
+        else if (arg == "--out") options.outputPath = value;
+        else if (arg == "--timing") options.timingPath = value;
+        else if (arg == "--qtable") options.qtablePath = value;
+        else if (arg == "--duration") {
+            options.durationMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+            options.durationSet = true;
+        }
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--interval") options.arrivalIntervalMs = std::stof(value);
+        else if (arg == "--burst") options.initialPriorityVehicles = std::stoi(value);
+        else if (arg == "--emergency") options.emergencyShare = std::stof(value);
+        else if (arg == "--step") options.stepMs = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--model") options.model = (value == "fixed") ? MovementModel::FIXED_SPEED : MovementModel::CAR_FOLLOWING;
+        else if (arg == "--controller") {
+            options.controllers.clear();
+            std::stringstream ss(value);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                SignalControllerType type;
+                if (!parseSignalControllerType(item, type)) {
+                    std::cerr << "Unknown signal controller " << item << std::endl;
+                    return false;
+                }
+                options.controllers.push_back(type);
+            }
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.stepMs == 0 || options.controllers.empty()) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Replay the trace through one controller
+bool runController(SignalControllerType controller, const std::vector<Arrival>& trace,
+                   const BenchmarkOptions& options, const SignalTiming& timing, BenchmarkResult& result) {
+    TrafficManager manager;
+    manager.setFileInputEnabled(false);
+    manager.setMovementModel(options.model);
+    manager.setSignalController(controller);
+    manager.setSignalTiming(timing);
+    if (!manager.initialize()) {
+        return false;
+    }
+    manager.setSeed(options.seed);
+    manager.start();
+
+    result.controller = controller;
+
+    size_t next = 0;
+    for (uint32_t time = 0; time < options.durationMs; time += options.stepMs) {
+        // Vehicles arriving during this step join before it runs
+        while (next < trace.size() && trace[next].timeMs <= time + options.stepMs) {
+            result.arrived += manager.injectVehicle(trace[next].line) ? 1 : 0;
+            next++;
+        }
+        manager.update(options.stepMs);
+    }
+
+    // Delay of the signal-controlled lanes (L2). Vehicles still waiting at the
+    // end count with their wait so far, so a policy cannot look good by starving a road.
+    std::vector<uint32_t> delays;
+    const auto& lanes = manager.getLanes();
+    const uint32_t now = manager.getSimulationTime();
+    for (size_t i = 0; i < lanes.size(); i++) {
+        if (lanes[i]->getLaneNumber() != 2) {
+            continue;
+        }
+
+        const auto& waits = manager.getLaneWaitTimes(i);
+        delays.insert(delays.end(), waits.begin(), waits.end());
+
+        for (auto* vehicle : lanes[i]->getVehicles()) {
+            if (!vehicle->hasPassedStopLine()) {
+                delays.push_back(now - vehicle->getQueueEntryTime());
+                result.stillQueued++;
+            }
+        }
+    }
+
+    std::vector<uint32_t> clearances = manager.getEmergencyClearanceTimes();
+    result.emergencies = static_cast<uint32_t>(clearances.size());
+    if (!clearances.empty()) {
+        result.meanEmergencyS = Statistics::mean(clearances) / 1000.0;
+        result.maxEmergencyS = Statistics::percentile(clearances, 100.0) / 1000.0;
+    }
+
+    result.exited = manager.getVehiclesExited();
+    result.throughputPerHour = result.exited / (options.durationMs / 3600000.0);
+    if (!delays.empty()) {
+        result.meanDelayS = Statistics::mean(delays) / 1000.0;
+        result.p95DelayS = Statistics::percentile(delays, 95.0) / 1000.0;
+    }
+    return true;
+}
+
+void printResults(const std::vector<BenchmarkResult>& results) {
+    // The original queue-average policy is the baseline when it was run
+    const BenchmarkResult* baseline = nullptr;
+    for (const auto& result : results) {
+        if (result.controller == SignalControllerType::QUEUE_AVERAGE) {
+            baseline = &result;
+        }
+    }
+
+    std::cout << std::left << std::setw(14) << "controller"
+              << std::right << std::setw(9) << "arrived" << std::setw(9) << "exited"
+              << std::setw(9) << "queued" << std::setw(12) << "veh/hour"
+              << std::setw(12) << "delay_s" << std::setw(12) << "p95_s";
+    if (baseline) {
+        std::cout << std::setw(14) << "vs_queue_%";
+    }
+    std::cout << std::setw(8) << "emerg" << std::setw(11) << "emerg_s" << std::setw(11) << "emerg_max";
+    std::cout << "\n";
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& result : results) {
+        std::cout << std::left << std::setw(14) << signalControllerName(result.controller)
+                  << std::right << std::setw(9) << result.arrived << std::setw(9) << result.exited
+                  << std::setw(9) << result.stillQueued << std::setw(12) << result.throughputPerHour
+                  << std::setw(12) << result.meanDelayS << std::setw(12) << result.p95DelayS;
+        if (baseline) {
+            // Throughput change relative to the baseline
+            double change = baseline->throughputPerHour > 0.0 ?
+                100.0 * (result.throughputPerHour / baseline->throughputPerHour - 1.0) : 0.0;
+            std::cout << std::setw(14) << change;
+        }
+        std::cout << std::setw(8) << result.emergencies << std::setw(11) << result.meanEmergencyS
+                  << std::setw(11) << result.maxEmergencyS;
+        std::cout << "\n";
+    }
+}
+
+bool writeResults(const std::string& path, const std::vector<BenchmarkResult>& results) {
+    std::ofstream csv(path);
+    if (!csv.is_open()) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+
+    csv << "controller,arrived,exited,still_queued,throughput_per_hour,mean_delay_s,p95_delay_s,"
+           "emergencies,emergency_clearance_mean_s,emergency_clearance_max_s\n";
+    csv << std::fixed << std::setprecision(3);
+    for (const auto& result : results) {
+        csv << signalControllerName(result.controller) << "," << result.arrived << ","
+            << result.exited << "," << result.stillQueued << "," << result.throughputPerHour << ","
+            << result.meanDelayS << "," << result.p95DelayS << "," << result.emergencies << ","
+            << result.meanEmergencyS << "," << result.maxEmergencyS << "\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchmarkOptions options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        DebugLogger::setEnabled(false);
+
+        SignalTiming timing;
+        if (!options.timingPath.empty() && !loadSignalTiming(options.timingPath, timing)) {
+            std::cerr << "Could not load timing " << options.timingPath << std::endl;
+            return 1;
+        }
+        if (!options.qtablePath.empty() && !QTable::policy().load(options.qtablePath)) {
+            std::cerr << "Could not load Q-table " << options.qtablePath << std::endl;
+            return 1;
+        }
+
+        std::vector<Arrival> trace;
+        if (!options.tracePath.empty()) {
+            if (!ArrivalTrace::load(options.tracePath, trace)) {
+                return 1;
+            }
+            if (!options.durationSet && !trace.empty()) {
+                options.durationMs = trace.back().timeMs;
+            }
+        } else {
+            trace = ArrivalTrace::generate(options.arrivalIntervalMs, options.initialPriorityVehicles,
+                                           options.durationMs, options.stepMs, options.seed,
+                                           options.emergencyShare);
+        }
+
+        if (!options.recordPath.empty()) {
+            if (!ArrivalTrace::save(options.recordPath, trace)) {
+                return 1;
+            }
+            std::cout << "Trace written to " << options.recordPath << std::endl;
+        }
+
+        std::cout << "Replaying " << trace.size() << " arrivals over "
+                  << options.durationMs / 1000.0 << " s" << std::endl;
+
+        std::vector<BenchmarkResult> results;
+        for (SignalControllerType controller : options.controllers) {
+            BenchmarkResult result;
+            if (!runController(controller, trace, options, timing, result)) {
+                std::cerr << "Failed to initialize a simulation" << std::endl;
+                return 1;
+            }
+            results.push_back(result);
+        }
+
+        printResults(results);
+
+        if (!options.outputPath.empty() && !writeResults(options.outputPath, results)) {
+            return 1;
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
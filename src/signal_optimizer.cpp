@@ -0,0 +1,502 @@
+// FILE: src/signal_optimizer.cpp
+// Offline signal timing optimizer: a genetic search over the green timing of a
+// controller (minimum green, maximum green and green time per queued vehicle),
+// scoring every candidate by a headless replay of one arrival trace. Candidates
+// of a generation run in parallel, and finished runs are cached on disk by a
+// hash of everything that determines their outcome, so repeated or extended
+// searches only simulate new parameter sets.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <iomanip>
+
+#include "managers/TrafficManager.h"
+#include "managers/ArrivalTrace.h"
+#include "core/Constants.h"
+#include "core/SignalController.h"
+#include "core/SignalTiming.h"
+#include "utils/DebugLogger.h"
+#include "utils/Statistics.h"
+
+// Searched parameters, with their bounds and resolution (ms)
+enum Gene { MIN_GREEN, MAX_GREEN, GREEN_PER_VEHICLE, GENE_COUNT };
+
+namespace {
+    const char* const GENE_NAMES[GENE_COUNT] = {"min_green", "max_green", "green_per_vehicle"};
+    const int GENE_LOW[GENE_COUNT] = {1000, 4000, 250};
+    const int GENE_HIGH[GENE_COUNT] = {10000, 40000, 5000};
+    const int GENE_RESOLUTION = 100;   // Coarser than this makes no measurable difference and helps the cache
+    const int ELITE_COUNT = 2;
+    const int TOURNAMENT_SIZE = 3;
+    const char* const CACHE_HEADER = "key,mean_delay_s,p95_delay_s,throughput_per_hour,still_queued";
+}
+
+struct OptimizerOptions {
+    std::string tracePath;                  // Replay this trace instead of generating one
+    std::string cachePath = "signal_optimizer_cache.csv";   // "none" disables the cache
+    std::string outputPath = "signal_timing.txt";
+    uint32_t durationMs = 1800000;
+    bool durationSet = false;
+    uint32_t stepMs = 16;
+    uint32_t seed = 1;                      // Trace, simulation and search seed
+    float arrivalIntervalMs = 2000.0f;
+    int initialPriorityVehicles = 12;
+    MovementModel model = MovementModel::FIXED_SPEED;
+    SignalControllerType controller = SignalControllerType::QUEUE_AVERAGE;
+    int population = 16;
+    int generations = 12;
+    int threads = 0;                        // 0 = one per hardware thread
+};
+
+// Score of one candidate on the trace (lower mean delay is better)
+struct Evaluation {
+    double meanDelayS = 0.0;
+    double p95DelayS = 0.0;
+    double throughputPerHour = 0.0;
+    uint32_t stillQueued = 0;
+};
+
+struct Candidate {
+    int genes[GENE_COUNT];
+    uint64_t key = 0;
+    Evaluation evaluation;
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: signal_optimizer [options]\n"
+        "  --trace FILE        replay a recorded trace (see signal_benchmark --record)\n"
+        "  --duration S        simulated seconds (default 1800, or the trace length)\n"
+        "  --seed N            seed of the generated trace, the simulation and the search (default 1)\n"
+        "  --interval MS       mean time between generated arrivals (default 2000)\n"
+        "  --burst N           A2 vehicles at the start of a generated trace (default 12)\n"
+        "  --step MS           simulation step in ms (default 16)\n"
+        "  --model idm|fixed   movement model (default fixed)\n"
+        "  --controller NAME   controller whose timing is tuned (default queue)\n"
+        "  --population N      candidates per generation (default 16)\n"
+        "  --generations N     generations (default 12)\n"
+        "  --threads N         worker threads (default: all cores)\n"
+        "  --cache FILE        run cache, \"none\" to disable (default signal_optimizer_cache.csv)\n"
+        "  --out FILE          best timing, loadable with simulator --timing (default signal_timing.txt)\n";
+}
+
+bool parseOptions(int argc, char* argv[], OptimizerOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--trace") options.tracePath = value;
+        else if (arg == "--cache") options.cachePath = value;
+        else if (arg == "--out") options.outputPath = value;
+        else if (arg == "--duration") {
+            options.durationMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+            options.durationSet = true;
+        }
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--interval") options.arrivalIntervalMs = std::stof(value);
+        else if (arg == "--burst") options.initialPriorityVehicles = std::stoi(value);
+        else if (arg == "--step") options.stepMs = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--model") options.model = (value == "fixed") ? MovementModel::FIXED_SPEED : MovementModel::CAR_FOLLOWING;
+        else if (arg == "--controller") {
+            if (!parseSignalControllerType(value, options.controller)) {
+                std::cerr << "Unknown signal controller " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--population") options.population = std::stoi(value);
+        else if (arg == "--generations") options.generations = std::stoi(value);
+        else if (arg == "--threads") options.threads = std::stoi(value);
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.stepMs == 0 || options.population <= ELITE_COUNT || options.generations <= 0) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Run cache
+
+// 64-bit FNV-1a
+uint64_t hashText(const std::string& text, uint64_t hash = 1469598103934665603ULL) {
+    for (unsigned char c : text) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Everything besides the timing that decides the outcome of a run, including
+// the model revision so results of an older simulation are not reused
+uint64_t hashSetup(const OptimizerOptions& options, const std::vector<Arrival>& trace) {
+    std::ostringstream ss;
+    ss << "signal_optimizer/1|" << Constants::SIMULATION_REVISION << "|" << Constants::SNAPSHOT_VERSION << "|"
+       << signalControllerName(options.controller) << "|"
+       << options.durationMs << "|" << options.stepMs << "|" << options.seed << "|"
+       << static_cast<int>(options.model) << "|";
+    uint64_t hash = hashText(ss.str());
+    for (const auto& arrival : trace) {
+        hash = hashText(std::to_string(arrival.timeMs) + " " + arrival.line + "\n", hash);
+    }
+    return hash;
+}
+
+// Every timing field with its key, so fields added to SignalTiming are keyed too
+uint64_t hashTiming(uint64_t setupHash, const SignalTiming& timing) {
+    std::ostringstream ss;
+    writeSignalTiming(ss, timing);
+    return hashText(ss.str(), setupHash);
+}
+
+std::string formatKey(uint64_t key) {
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << key;
+    return ss.str();
+}
+
+void loadCache(const std::string& path, std::unordered_map<uint64_t, Evaluation>& cache) {
+    std::ifstream file(path);
+    std::string text;
+    while (std::getline(file, text)) {
+        if (text.empty() || text == CACHE_HEADER) {
+            continue;
+        }
+
+        std::replace(text.begin(), text.end(), ',', ' ');
+        std::istringstream ss(text);
+        std::string key;
+        Evaluation evaluation;
+        if (ss >> key >> evaluation.meanDelayS >> evaluation.p95DelayS >>
+                evaluation.throughputPerHour >> evaluation.stillQueued) {
+            cache[std::stoull(key, nullptr, 16)] = evaluation;
+        }
+    }
+}
+
+bool appendCache(const std::string& path, const std::vector<Candidate>& fresh) {
+    bool exists = std::ifstream(path).good();
+    std::ofstream file(path, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Could not write cache " << path << std::endl;
+        return false;
+    }
+
+    if (!exists) {
+        file << CACHE_HEADER << "\n";
+    }
+    file << std::setprecision(17);
+    for (const auto& candidate : fresh) {
+        const Evaluation& e = candidate.evaluation;
+        file << formatKey(candidate.key) << "," << e.meanDelayS << "," << e.p95DelayS << ","
+             << e.throughputPerHour << "," << e.stillQueued << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+// ---------------------------------------------------------------------------
+// Evaluation
+
+SignalTiming timingOf(const Candidate& candidate) {
+    SignalTiming timing;
+    timing.minGreen = candidate.genes[MIN_GREEN];
+    timing.maxGreen = candidate.genes[MAX_GREEN];
+    timing.greenPerVehicle = candidate.genes[GREEN_PER_VEHICLE];
+    return timing;
+}
+
+// Replay the trace with one timing on a reused manager. Same measure as
+// signal_benchmark: L2 delay, counting vehicles still waiting at the end with
+// their wait so far.
+Evaluation evaluate(TrafficManager& manager, const SignalTiming& timing,
+                    const std::vector<Arrival>& trace, const OptimizerOptions& options) {
+    manager.setSignalController(options.controller);
+    manager.setSignalTiming(timing);
+    manager.reset();
+    manager.setSeed(options.seed);
+
+    size_t next = 0;
+    for (uint32_t time = 0; time < options.durationMs; time += options.stepMs) {
+        while (next < trace.size() && trace[next].timeMs <= time + options.stepMs) {
+            manager.injectVehicle(trace[next].line);
+            next++;
+        }
+        manager.update(options.stepMs);
+    }
+
+    Evaluation evaluation;
+    std::vector<uint32_t> delays;
+    const auto& lanes = manager.getLanes();
+    const uint32_t now = manager.getSimulationTime();
+    for (size_t i = 0; i < lanes.size(); i++) {
+        if (lanes[i]->getLaneNumber() != 2) {
+            continue;
+        }
+
+        const auto& waits = manager.getLaneWaitTimes(i);
+        delays.insert(delays.end(), waits.begin(), waits.end());
+
+        for (auto* vehicle : lanes[i]->getVehicles()) {
+            if (!vehicle->hasPassedStopLine()) {
+                delays.push_back(now - vehicle->getQueueEntryTime());
+                evaluation.stillQueued++;
+            }
+        }
+    }
+
+    evaluation.throughputPerHour = manager.getVehiclesExited() / (options.durationMs / 3600000.0);
+    if (!delays.empty()) {
+        evaluation.meanDelayS = Statistics::mean(delays) / 1000.0;
+        evaluation.p95DelayS = Statistics::percentile(delays, 95.0) / 1000.0;
+    }
+    return evaluation;
+}
+
+// Simulate the candidates in parallel, one manager per worker
+void evaluateAll(std::vector<Candidate*>& jobs, std::vector<TrafficManager*>& managers,
+                 const std::vector<Arrival>& trace, const OptimizerOptions& options) {
+    std::atomic<size_t> nextJob(0);
+    auto worker = [&](TrafficManager* manager) {
+        for (size_t job = nextJob++; job < jobs.size(); job = nextJob++) {
+            jobs[job]->evaluation = evaluate(*manager, timingOf(*jobs[job]), trace, options);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < managers.size() && i < jobs.size(); i++) {
+        workers.emplace_back(worker, managers[i]);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Search
+
+// Clamp to the bounds and the resolution, and keep max green >= min green
+void repair(Candidate& candidate) {
+    for (int g = 0; g < GENE_COUNT; g++) {
+        int value = std::max(GENE_LOW[g], std::min(candidate.genes[g], GENE_HIGH[g]));
+        candidate.genes[g] = (value + GENE_RESOLUTION / 2) / GENE_RESOLUTION * GENE_RESOLUTION;
+    }
+    candidate.genes[MAX_GREEN] = std::max(candidate.genes[MAX_GREEN], candidate.genes[MIN_GREEN]);
+}
+
+bool better(const Candidate& a, const Candidate& b) {
+    return a.evaluation.meanDelayS < b.evaluation.meanDelayS;
+}
+
+const Candidate& tournament(const std::vector<Candidate>& population, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> pick(0, population.size() - 1);
+    const Candidate* best = &population[pick(rng)];
+    for (int i = 1; i < TOURNAMENT_SIZE; i++) {
+        const Candidate& other = population[pick(rng)];
+        if (better(other, *best)) {
+            best = &other;
+        }
+    }
+    return *best;
+}
+
+// Elites carry over; the rest are blend crossovers of tournament winners with
+// Gaussian mutation whose width shrinks from 15% to 3% of each range
+std::vector<Candidate> nextGeneration(const std::vector<Candidate>& sorted, int generation,
+                                      const OptimizerOptions& options, std::mt19937& rng) {
+    std::vector<Candidate> next(sorted.begin(), sorted.begin() + ELITE_COUNT);
+
+    const double progress = options.generations > 1 ?
+        static_cast<double>(generation) / (options.generations - 1) : 1.0;
+    const double width = 0.15 - 0.12 * progress;
+    std::uniform_real_distribution<double> blend(-0.25, 1.25);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> noise(0.0, 1.0);
+
+    while (static_cast<int>(next.size()) < options.population) {
+        const Candidate& a = tournament(sorted, rng);
+        const Candidate& b = tournament(sorted, rng);
+
+        Candidate child;
+        for (int g = 0; g < GENE_COUNT; g++) {
+            double value = a.genes[g] + blend(rng) * (b.genes[g] - a.genes[g]);
+            if (unit(rng) < 0.4) {
+                value += noise(rng) * width * (GENE_HIGH[g] - GENE_LOW[g]);
+            }
+            child.genes[g] = static_cast<int>(value);
+        }
+        repair(child);
+        next.push_back(child);
+    }
+    return next;
+}
+
+std::string describe(const Candidate& candidate) {
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(2);
+    for (int g = 0; g < GENE_COUNT; g++) {
+        ss << GENE_NAMES[g] << "=" << candidate.genes[g] << " ";
+    }
+    ss << "delay=" << candidate.evaluation.meanDelayS << "s p95=" << candidate.evaluation.p95DelayS
+       << "s veh/h=" << candidate.evaluation.throughputPerHour;
+    return ss.str();
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        OptimizerOptions options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        DebugLogger::setEnabled(false);
+
+        std::vector<Arrival> trace;
+        if (!options.tracePath.empty()) {
+            if (!ArrivalTrace::load(options.tracePath, trace)) {
+                return 1;
+            }
+            if (!options.durationSet && !trace.empty()) {
+                options.durationMs = trace.back().timeMs;
+            }
+        } else {
+            trace = ArrivalTrace::generate(options.arrivalIntervalMs, options.initialPriorityVehicles,
+                                           options.durationMs, options.stepMs, options.seed);
+        }
+
+        const bool useCache = options.cachePath != "none";
+        std::unordered_map<uint64_t, Evaluation> cache;
+        if (useCache) {
+            loadCache(options.cachePath, cache);
+        }
+        const uint64_t setupHash = hashSetup(options, trace);
+
+        int threadCount = options.threads > 0 ? options.threads :
+                          static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        threadCount = std::min(threadCount, options.population);
+
+        std::vector<TrafficManager*> managers;
+        for (int i = 0; i < threadCount; i++) {
+            TrafficManager* manager = new TrafficManager();
+            manager->setFileInputEnabled(false);
+            manager->setMovementModel(options.model);
+            managers.push_back(manager);
+            if (!manager->initialize()) {
+                std::cerr << "Failed to initialize a simulation" << std::endl;
+                for (auto* m : managers) delete m;
+                return 1;
+            }
+            manager->start();
+        }
+
+        std::cout << "Tuning " << signalControllerName(options.controller) << " timing on "
+                  << trace.size() << " arrivals over " << options.durationMs / 1000.0 << " s: "
+                  << options.generations << " generations of " << options.population << " on "
+                  << threadCount << " thread(s), " << cache.size() << " cached run(s)" << std::endl;
+
+        // The hand-tuned defaults seed the search, so the result is never worse than them
+        std::mt19937 rng(options.seed);
+        std::vector<Candidate> population(options.population);
+        SignalTiming defaults;
+        population[0].genes[MIN_GREEN] = defaults.minGreen;
+        population[0].genes[MAX_GREEN] = defaults.maxGreen;
+        population[0].genes[GREEN_PER_VEHICLE] = defaults.greenPerVehicle;
+        for (size_t i = 1; i < population.size(); i++) {
+            for (int g = 0; g < GENE_COUNT; g++) {
+                population[i].genes[g] = std::uniform_int_distribution<int>(GENE_LOW[g], GENE_HIGH[g])(rng);
+            }
+            repair(population[i]);
+        }
+
+        Candidate baseline;
+        Candidate best;
+        size_t simulated = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int generation = 0; generation < options.generations; generation++) {
+            // Simulate each distinct parameter set that is not cached yet
+            std::vector<Candidate*> jobs;
+            std::unordered_map<uint64_t, Candidate*> pending;
+            for (auto& candidate : population) {
+                candidate.key = hashTiming(setupHash, timingOf(candidate));
+                if (cache.count(candidate.key) == 0 && pending.count(candidate.key) == 0) {
+                    pending[candidate.key] = &candidate;
+                    jobs.push_back(&candidate);
+                }
+            }
+
+            evaluateAll(jobs, managers, trace, options);
+            simulated += jobs.size();
+
+            std::vector<Candidate> fresh;
+            for (auto* job : jobs) {
+                cache[job->key] = job->evaluation;
+                fresh.push_back(*job);
+            }
+            if (useCache && !fresh.empty()) {
+                appendCache(options.cachePath, fresh);
+            }
+
+            for (auto& candidate : population) {
+                candidate.evaluation = cache[candidate.key];
+            }
+            if (generation == 0) {
+                baseline = population[0];
+            }
+
+            std::sort(population.begin(), population.end(), better);
+            if (generation == 0 || better(population[0], best)) {
+                best = population[0];
+            }
+
+            std::cout << "  generation " << generation + 1 << ": " << jobs.size() << " simulated, "
+                      << population.size() - jobs.size() << " cached, best " << describe(best) << std::endl;
+
+            if (generation + 1 < options.generations) {
+                population = nextGeneration(population, generation, options, rng);
+            }
+        }
+
+        for (auto* manager : managers) {
+            delete manager;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Simulated " << simulated << " run(s) in " << seconds << " s" << std::endl;
+        std::cout << "Defaults: " << describe(baseline) << std::endl;
+        std::cout << "Best:     " << describe(best) << std::endl;
+
+        if (!saveSignalTiming(options.outputPath, timingOf(best))) {
+            std::cerr << "Could not write " << options.outputPath << std::endl;
+            return 1;
+        }
+        std::cout << "Best timing written to " << options.outputPath << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,317 @@
+// FILE: src/signal_train.cpp
+// Trains the Q-learning signal controller: many headless simulations, one per
+// worker thread, learn into the shared lock-free Q-table, each episode on its
+// own generated trace. The table is written for simulator --qtable and, unless
+// disabled, evaluated greedily against the hand-written controllers on a
+// trace none of the episodes saw.
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+
+#include "managers/TrafficManager.h"
+#include "managers/ArrivalTrace.h"
+#include "core/SignalController.h"
+#include "core/QTable.h"
+#include "utils/DebugLogger.h"
+#include "utils/Statistics.h"
+
+struct TrainOptions {
+    std::string initPath;                   // Continue from this table
+    std::string outputPath = "qtable.bin";
+    std::string timingPath;                 // Optional signal timing file
+    int episodes = 96;
+    uint32_t episodeMs = 900000;
+    uint32_t evaluationMs = 1800000;        // 0 skips the evaluation
+    uint32_t stepMs = 16;
+    uint32_t seed = 1;
+    std::vector<float> arrivalIntervalsMs = {1500.0f, 2500.0f, 4000.0f};   // Cycled over the episodes
+    int initialPriorityVehicles = 12;
+    float epsilonStart = 0.2f;
+    float epsilonEnd = 0.01f;
+    MovementModel model = MovementModel::FIXED_SPEED;
+    int threads = 0;                        // 0 = one per hardware thread
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: signal_train [options]\n"
+        "  --episodes N        training simulations (default 96)\n"
+        "  --duration S        simulated seconds per episode (default 900)\n"
+        "  --interval LIST     mean arrival intervals in ms, cycled over the episodes (default 1500,2500,4000)\n"
+        "  --burst N           A2 vehicles at the start of each episode (default 12)\n"
+        "  --seed N            seed of the first episode (default 1)\n"
+        "  --epsilon A,B       exploration rate, decayed linearly from A to B (default 0.2,0.01)\n"
+        "  --step MS           simulation step in ms (default 16)\n"
+        "  --model idm|fixed   movement model (default fixed)\n"
+        "  --timing FILE       signal timing file (min_green, max_green, fixed_green apply)\n"
+        "  --threads N         worker threads (default: all cores)\n"
+        "  --init FILE         continue training from a saved table\n"
+        "  --evaluate S        simulated seconds of the greedy evaluation, 0 to skip (default 1800)\n"
+        "  --out FILE          trained table, loadable with simulator --qtable (default qtable.bin)\n";
+}
+
+bool parseList(const std::string& value, std::vector<float>& list) {
+    list.clear();
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        list.push_back(std::stof(item));
+    }
+    return !list.empty();
+}
+
+bool parseOptions(int argc, char* argv[], TrainOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--init") options.initPath = value;
+        else if (arg == "--out") options.outputPath = value;
+        else if (arg == "--timing") options.timingPath = value;
+        else if (arg == "--episodes") options.episodes = std::stoi(value);
+        else if (arg == "--duration") options.episodeMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--evaluate") options.evaluationMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--step") options.stepMs = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--seed") options.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--burst") options.initialPriorityVehicles = std::stoi(value);
+        else if (arg == "--threads") options.threads = std::stoi(value);
+        else if (arg == "--model") options.model = (value == "fixed") ? MovementModel::FIXED_SPEED : MovementModel::CAR_FOLLOWING;
+        else if (arg == "--interval") {
+            if (!parseList(value, options.arrivalIntervalsMs)) {
+                std::cerr << "Invalid interval list " << value << std::endl;
+                return false;
+            }
+        }
+        else if (arg == "--epsilon") {
+            std::vector<float> range;
+            if (!parseList(value, range) || range.size() > 2) {
+                std::cerr << "Invalid epsilon " << value << std::endl;
+                return false;
+            }
+            options.epsilonStart = range[0];
+            options.epsilonEnd = range.back();
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.stepMs == 0 || options.episodes < 0 || options.episodeMs == 0) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Replay a trace on a reused manager and return the mean L2 delay (s), the
+// same measure as signal_benchmark: vehicles still waiting at the end count
+// with their wait so far
+double runTrace(TrafficManager& manager, const std::vector<Arrival>& trace, uint32_t durationMs,
+                const TrainOptions& options, uint32_t seed) {
+    manager.reset();
+    manager.setSeed(seed);
+
+    size_t next = 0;
+    for (uint32_t time = 0; time < durationMs; time += options.stepMs) {
+        while (next < trace.size() && trace[next].timeMs <= time + options.stepMs) {
+            manager.injectVehicle(trace[next].line);
+            next++;
+        }
+        manager.update(options.stepMs);
+    }
+
+    std::vector<uint32_t> delays;
+    const auto& lanes = manager.getLanes();
+    const uint32_t now = manager.getSimulationTime();
+    for (size_t i = 0; i < lanes.size(); i++) {
+        if (lanes[i]->getLaneNumber() != 2) {
+            continue;
+        }
+
+        const auto& waits = manager.getLaneWaitTimes(i);
+        delays.insert(delays.end(), waits.begin(), waits.end());
+        for (auto* vehicle : lanes[i]->getVehicles()) {
+            if (!vehicle->hasPassedStopLine()) {
+                delays.push_back(now - vehicle->getQueueEntryTime());
+            }
+        }
+    }
+    return delays.empty() ? 0.0 : Statistics::mean(delays) / 1000.0;
+}
+
+bool createManager(TrafficManager& manager, const TrainOptions& options, const SignalTiming& timing) {
+    manager.setFileInputEnabled(false);
+    manager.setMovementModel(options.model);
+    manager.setSignalTiming(timing);
+    if (!manager.initialize()) {
+        return false;
+    }
+    manager.start();
+    return true;
+}
+
+// Run the episodes on all workers; episodeDelays receives each episode's mean delay
+bool train(const TrainOptions& options, const SignalTiming& timing, int threadCount,
+           std::vector<double>& episodeDelays) {
+    std::vector<TrafficManager*> managers;
+    for (int i = 0; i < threadCount; i++) {
+        managers.push_back(new TrafficManager());
+        if (!createManager(*managers.back(), options, timing)) {
+            for (auto* manager : managers) {
+                delete manager;
+            }
+            return false;
+        }
+    }
+
+    episodeDelays.assign(options.episodes, 0.0);
+    std::atomic<int> nextEpisode(0);
+    auto worker = [&](TrafficManager* manager) {
+        for (int episode = nextEpisode++; episode < options.episodes; episode = nextEpisode++) {
+            const float progress = options.episodes > 1 ? static_cast<float>(episode) / (options.episodes - 1) : 1.0f;
+            const float epsilon = options.epsilonStart + (options.epsilonEnd - options.epsilonStart) * progress;
+            const float interval = options.arrivalIntervalsMs[episode % options.arrivalIntervalsMs.size()];
+            const uint32_t seed = options.seed + static_cast<uint32_t>(episode);
+
+            std::vector<Arrival> trace = ArrivalTrace::generate(interval, options.initialPriorityVehicles,
+                                                                options.episodeMs, options.stepMs, seed);
+
+            manager->setSignalController(SignalControllerType::QLEARNING);
+            auto* controller = dynamic_cast<QLearningController*>(manager->getTrafficLight()->getController());
+            controller->setLearning(true, epsilon, seed);
+            episodeDelays[episode] = runTrace(*manager, trace, options.episodeMs, options, seed);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (auto* manager : managers) {
+        workers.emplace_back(worker, manager);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    for (auto* manager : managers) {
+        delete manager;
+    }
+    return true;
+}
+
+// Greedy table against the hand-written controllers on an unseen trace, one
+// row per arrival interval
+bool evaluate(const TrainOptions& options, const SignalTiming& timing) {
+    const SignalControllerType controllers[] = {
+        SignalControllerType::QLEARNING,
+        SignalControllerType::FIXED_TIME,
+        SignalControllerType::QUEUE_AVERAGE,
+        SignalControllerType::ACTUATED
+    };
+
+    TrafficManager manager;
+    if (!createManager(manager, options, timing)) {
+        return false;
+    }
+
+    std::cout << "\nGreedy evaluation, mean L2 delay (s) over " << options.evaluationMs / 1000.0 << " s\n";
+    std::cout << std::left << std::setw(12) << "interval_ms" << std::right;
+    for (SignalControllerType controller : controllers) {
+        std::cout << std::setw(12) << signalControllerName(controller);
+    }
+    std::cout << "\n" << std::fixed << std::setprecision(2);
+
+    // Far from the training seeds
+    const uint32_t seed = options.seed + 100000;
+    for (float interval : options.arrivalIntervalsMs) {
+        std::vector<Arrival> trace = ArrivalTrace::generate(interval, options.initialPriorityVehicles,
+                                                            options.evaluationMs, options.stepMs, seed);
+        std::cout << std::left << std::setw(12) << static_cast<int>(interval) << std::right;
+        for (SignalControllerType controller : controllers) {
+            manager.setSignalController(controller);
+            std::cout << std::setw(12) << runTrace(manager, trace, options.evaluationMs, options, seed);
+        }
+        std::cout << "\n";
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        TrainOptions options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        DebugLogger::setEnabled(false);
+
+        SignalTiming timing;
+        if (!options.timingPath.empty() && !loadSignalTiming(options.timingPath, timing)) {
+            std::cerr << "Could not load timing " << options.timingPath << std::endl;
+            return 1;
+        }
+
+        QTable& table = QTable::policy();
+        if (!options.initPath.empty() && !table.load(options.initPath)) {
+            std::cerr << "Could not load Q-table " << options.initPath << std::endl;
+            return 1;
+        }
+
+        int threadCount = options.threads > 0 ? options.threads :
+                          static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        threadCount = std::max(1, std::min(threadCount, options.episodes));
+
+        std::cout << "Training " << options.episodes << " episode(s) of " << options.episodeMs / 1000.0
+                  << " s on " << threadCount << " thread(s)" << std::endl;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<double> episodeDelays;
+        if (!train(options, timing, threadCount, episodeDelays)) {
+            std::cerr << "Failed to initialize a simulation" << std::endl;
+            return 1;
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Learning curve: mean delay of each quarter of the episodes
+        std::cout << std::fixed << std::setprecision(2) << "Mean delay by training quarter (s):";
+        const size_t quarter = std::max<size_t>(1, episodeDelays.size() / 4);
+        for (size_t first = 0; first < episodeDelays.size(); first += quarter) {
+            const size_t last = std::min(episodeDelays.size(), first + quarter);
+            std::cout << " " << Statistics::mean(std::vector<double>(episodeDelays.begin() + first,
+                                                                     episodeDelays.begin() + last));
+        }
+        std::cout << "\n" << table.visitedStates() << " of " << QTable::STATE_COUNT << " states visited, "
+                  << std::setprecision(1) << seconds << " s wall time" << std::endl;
+
+        if (!table.save(options.outputPath)) {
+            std::cerr << "Could not write " << options.outputPath << std::endl;
+            return 1;
+        }
+        std::cout << "Q-table written to " << options.outputPath << std::endl;
+
+        if (options.evaluationMs > 0 && !evaluate(options, timing)) {
+            std::cerr << "Failed to initialize a simulation" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,172 @@
+// FILE: src/timeseries_export.cpp
+// Converts a time-series file recorded by the simulator (--series) to CSV,
+// optionally keeping only some columns and a window of simulated time.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "utils/TimeSeries.h"
+
+struct ExportOptions {
+    std::string inputPath;
+    std::string outputPath;             // stdout when empty
+    std::vector<std::string> columns;   // All when empty
+    int64_t fromMs = 0;
+    int64_t toMs = -1;                  // No end when negative
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: timeseries_export FILE [options]\n"
+        "  --out FILE         write the CSV to FILE instead of stdout\n"
+        "  --columns LIST     comma-separated columns to export (default all;\n"
+        "                     time_ms is always included when the file has it)\n"
+        "  --from MS          first simulated time to export\n"
+        "  --to MS            last simulated time to export\n"
+        "  --list             print the column names and exit\n";
+}
+
+bool parseOptions(int argc, char* argv[], ExportOptions& options, bool& listOnly) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (arg == "--list") {
+            listOnly = true;
+            continue;
+        }
+        if (arg.rfind("--", 0) != 0) {
+            options.inputPath = arg;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--out") options.outputPath = value;
+        else if (arg == "--from") options.fromMs = std::stoll(value);
+        else if (arg == "--to") options.toMs = std::stoll(value);
+        else if (arg == "--columns") {
+            std::stringstream ss(value);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                options.columns.push_back(item);
+            }
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.inputPath.empty()) {
+        printUsage();
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        ExportOptions options;
+        bool listOnly = false;
+        if (!parseOptions(argc, argv, options, listOnly)) {
+            return 1;
+        }
+
+        TimeSeriesReader reader;
+        if (!reader.open(options.inputPath)) {
+            std::cerr << "Could not read time series " << options.inputPath << std::endl;
+            return 1;
+        }
+        const std::vector<std::string>& names = reader.getColumns();
+
+        if (listOnly) {
+            for (const auto& name : names) {
+                std::cout << name << "\n";
+            }
+            return 0;
+        }
+
+        // Indices of the exported columns, in file order
+        const auto timeIt = std::find(names.begin(), names.end(), "time_ms");
+        const int timeColumn = timeIt == names.end() ? -1 : static_cast<int>(timeIt - names.begin());
+        std::vector<size_t> selected;
+        for (size_t i = 0; i < names.size(); i++) {
+            const bool wanted = options.columns.empty() || static_cast<int>(i) == timeColumn ||
+                std::find(options.columns.begin(), options.columns.end(), names[i]) != options.columns.end();
+            if (wanted) {
+                selected.push_back(i);
+            }
+        }
+        for (const auto& name : options.columns) {
+            if (std::find(names.begin(), names.end(), name) == names.end()) {
+                std::cerr << "Unknown column " << name << std::endl;
+                return 1;
+            }
+        }
+
+        std::ofstream file;
+        if (!options.outputPath.empty()) {
+            file.open(options.outputPath);
+            if (!file.is_open()) {
+                std::cerr << "Could not open " << options.outputPath << std::endl;
+                return 1;
+            }
+        }
+        std::ostream& out = options.outputPath.empty() ? std::cout : file;
+
+        for (size_t i = 0; i < selected.size(); i++) {
+            out << (i > 0 ? "," : "") << names[selected[i]];
+        }
+        out << "\n";
+
+        uint64_t rows = 0;
+        std::vector<std::vector<int64_t>> block;
+        std::string line;
+        while (reader.readBlock(block)) {
+            const size_t blockRows = block.front().size();
+            for (size_t row = 0; row < blockRows; row++) {
+                if (timeColumn >= 0) {
+                    const int64_t time = block[timeColumn][row];
+                    if (time < options.fromMs || (options.toMs >= 0 && time > options.toMs)) {
+                        continue;
+                    }
+                }
+
+                line.clear();
+                for (size_t i = 0; i < selected.size(); i++) {
+                    if (i > 0) {
+                        line += ',';
+                    }
+                    line += std::to_string(block[selected[i]][row]);
+                }
+                line += '\n';
+                out << line;
+                rows++;
+            }
+        }
+
+        if (reader.hasError()) {
+            std::cerr << "Damaged data after " << rows << " rows" << std::endl;
+            return 1;
+        }
+        if (!options.outputPath.empty()) {
+            std::cout << "Exported " << rows << " rows to " << options.outputPath << std::endl;
+        }
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
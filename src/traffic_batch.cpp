@@ -0,0 +1,354 @@
+// FILE: src/traffic_batch.cpp
+// Headless Monte Carlo runner: evaluates signal timing configurations over many
+// seeded simulations in parallel and writes aggregated results to a CSV file.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <iomanip>
+
+#include "managers/TrafficManager.h"
+#include "managers/ArrivalGenerator.h"
+#include "core/SignalTiming.h"
+#include "core/SignalController.h"
+#include "utils/DebugLogger.h"
+#include "utils/Statistics.h"
+
+// Batch settings (overridable from the command line)
+struct BatchOptions {
+    int runs = 100;                 // Seeded runs per configuration
+    int threads = 0;                // 0 = one per hardware thread
+    uint32_t durationMs = 600000;   // Simulated time per run
+    uint32_t stepMs = 16;           // Simulation step (one frame at 60 FPS)
+    uint32_t baseSeed = 1;
+    float arrivalIntervalMs = 2000.0f;
+    int initialPriorityVehicles = 12;
+    MovementModel model = MovementModel::FIXED_SPEED;
+    std::string outputPath = "batch_results.csv";
+
+    // Sweep values; every combination is one configuration
+    std::vector<SignalControllerType> controllers = {SignalControllerType::QUEUE_AVERAGE};
+    std::vector<int> thresholdHigh = {Constants::PRIORITY_THRESHOLD_HIGH};
+    std::vector<int> thresholdLow = {Constants::PRIORITY_THRESHOLD_LOW};
+    std::vector<int> minGreen = {Constants::GREEN_DURATION_BASE};
+    std::vector<int> allRed = {Constants::ALL_RED_DURATION};
+};
+
+// One point of the sweep
+struct Configuration {
+    SignalControllerType controller;
+    SignalTiming timing;
+};
+
+// Outcome of one simulation run
+struct RunResult {
+    uint32_t vehiclesExited = 0;
+    uint32_t priorityModeTime = 0;
+    std::vector<std::vector<uint32_t>> laneWaitTimes;
+};
+
+void printUsage() {
+    std::cout <<
+        "Usage: traffic_batch [options]\n"
+        "  --runs N          seeded runs per configuration (default 100)\n"
+        "  --threads N       worker threads (default: all cores)\n"
+        "  --duration S      simulated seconds per run (default 600)\n"
+        "  --step MS         simulation step in ms (default 16)\n"
+        "  --seed N          seed of the first run (default 1)\n"
+        "  --interval MS     mean time between arrivals (default 2000)\n"
+        "  --burst N         A2 vehicles at the start of each run (default 12)\n"
+        "  --model idm|fixed movement model (default fixed)\n"
+        "  --controller LIST signal policies: fixed,queue,actuated,pressure,phased,\n"
+        "                    phased-single,webster,coordinated,qlearning (default queue)\n"
+        "  --high LIST       priority-on thresholds, comma separated (default 10)\n"
+        "  --low LIST        priority-off thresholds (default 5)\n"
+        "  --min-green LIST  minimum green durations in ms (default 3000)\n"
+        "  --all-red LIST    all-red durations in ms (default 2000)\n"
+        "  --out FILE        CSV output (default batch_results.csv)\n";
+}
+
+bool parseControllerList(const std::string& text, std::vector<SignalControllerType>& controllers) {
+    controllers.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        SignalControllerType type;
+        if (!parseSignalControllerType(item, type)) {
+            std::cerr << "Unknown signal controller " << item << std::endl;
+            return false;
+        }
+        controllers.push_back(type);
+    }
+    return true;
+}
+
+std::vector<int> parseList(const std::string& text) {
+    std::vector<int> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::stoi(item));
+        }
+    }
+    return values;
+}
+
+bool parseOptions(int argc, char* argv[], BatchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--runs") options.runs = std::stoi(value);
+        else if (arg == "--threads") options.threads = std::stoi(value);
+        else if (arg == "--duration") options.durationMs = static_cast<uint32_t>(std::stod(value) * 1000.0);
+        else if (arg == "--step") options.stepMs = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--seed") options.baseSeed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--interval") options.arrivalIntervalMs = std::stof(value);
+        else if (arg == "--burst") options.initialPriorityVehicles = std::stoi(value);
+        else if (arg == "--model") options.model = (value == "fixed") ? MovementModel::FIXED_SPEED : MovementModel::CAR_FOLLOWING;
+        else if (arg == "--controller") {
+            if (!parseControllerList(value, options.controllers)) return false;
+        }
+        else if (arg == "--high") options.thresholdHigh = parseList(value);
+        else if (arg == "--low") options.thresholdLow = parseList(value);
+        else if (arg == "--min-green") options.minGreen = parseList(value);
+        else if (arg == "--all-red") options.allRed = parseList(value);
+        else if (arg == "--out") options.outputPath = value;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.runs <= 0 || options.stepMs == 0 || options.controllers.empty() || options.thresholdHigh.empty() ||
+        options.thresholdLow.empty() || options.minGreen.empty() || options.allRed.empty()) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Every combination of the sweep values
+std::vector<Configuration> buildConfigurations(const BatchOptions& options) {
+    std::vector<Configuration> configurations;
+    for (SignalControllerType controller : options.controllers) {
+        for (int high : options.thresholdHigh) {
+            for (int low : options.thresholdLow) {
+                for (int green : options.minGreen) {
+                    for (int red : options.allRed) {
+                        Configuration configuration;
+                        configuration.controller = controller;
+                        configuration.timing.priorityThresholdHigh = high;
+                        configuration.timing.priorityThresholdLow = low;
+                        configuration.timing.minGreen = green;
+                        configuration.timing.allRed = red;
+                        configurations.push_back(configuration);
+                    }
+                }
+            }
+        }
+    }
+    return configurations;
+}
+
+// Run one seeded simulation on a reused manager
+RunResult runSimulation(TrafficManager& manager, ArrivalGenerator& generator,
+                        const Configuration& configuration, uint32_t seed, const BatchOptions& options) {
+    manager.setSignalController(configuration.controller);
+    manager.setSignalTiming(configuration.timing);
+    manager.reset();
+    manager.setSeed(seed);
+    generator.reset();
+
+    std::vector<std::string> arrivals;
+    for (uint32_t time = 0; time < options.durationMs; time += options.stepMs) {
+        arrivals.clear();
+        generator.update(options.stepMs, manager.getRandomEngine(), arrivals);
+        for (const auto& line : arrivals) {
+            manager.injectVehicle(line);
+        }
+
+        manager.update(options.stepMs);
+    }
+
+    RunResult result;
+    result.vehiclesExited = manager.getVehiclesExited();
+    result.priorityModeTime = manager.getPriorityModeTime();
+    for (size_t i = 0; i < manager.getLanes().size(); i++) {
+        result.laneWaitTimes.push_back(manager.getLaneWaitTimes(i));
+    }
+    return result;
+}
+
+bool writeResults(const BatchOptions& options, const std::vector<Configuration>& configurations,
+                  const std::vector<RunResult>& results, const std::vector<std::string>& laneNames) {
+    std::ofstream csv(options.outputPath);
+    if (!csv.is_open()) {
+        std::cerr << "Could not open " << options.outputPath << std::endl;
+        return false;
+    }
+
+    // Vehicles only spawn in lanes 2 and 3
+    std::vector<size_t> reportedLanes;
+    for (size_t i = 0; i < laneNames.size(); i++) {
+        if (laneNames[i].back() != '1') {
+            reportedLanes.push_back(i);
+        }
+    }
+
+    csv << "controller,priority_high,priority_low,min_green_ms,all_red_ms,runs,throughput_per_hour,priority_time_pct";
+    for (size_t laneIndex : reportedLanes) {
+        const std::string& name = laneNames[laneIndex];
+        csv << "," << name << "_wait_mean_s," << name << "_wait_p95_s";
+    }
+    csv << "\n";
+
+    const double hours = options.durationMs / 3600000.0;
+    csv << std::fixed << std::setprecision(3);
+
+    for (size_t config = 0; config < configurations.size(); config++) {
+        const SignalTiming& timing = configurations[config].timing;
+
+        std::vector<double> throughput;
+        std::vector<double> priorityShare;
+        std::vector<std::vector<uint32_t>> waits(laneNames.size());
+
+        for (int run = 0; run < options.runs; run++) {
+            const RunResult& result = results[config * options.runs + run];
+            throughput.push_back(result.vehiclesExited / hours);
+            priorityShare.push_back(100.0 * result.priorityModeTime / options.durationMs);
+            for (size_t lane = 0; lane < result.laneWaitTimes.size() && lane < waits.size(); lane++) {
+                waits[lane].insert(waits[lane].end(), result.laneWaitTimes[lane].begin(), result.laneWaitTimes[lane].end());
+            }
+        }
+
+        csv << signalControllerName(configurations[config].controller) << ","
+            << timing.priorityThresholdHigh << "," << timing.priorityThresholdLow << ","
+            << timing.minGreen << "," << timing.allRed << "," << options.runs << ","
+            << Statistics::mean(throughput) << "," << Statistics::mean(priorityShare);
+        for (size_t laneIndex : reportedLanes) {
+            // Leave the cells empty for lanes where no vehicle crossed the stop line
+            if (waits[laneIndex].empty()) {
+                csv << ",,";
+                continue;
+            }
+            csv << "," << Statistics::mean(waits[laneIndex]) / 1000.0
+                << "," << Statistics::percentile(waits[laneIndex], 95.0) / 1000.0;
+        }
+        csv << "\n";
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BatchOptions options;
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+
+        // Thousands of runs would otherwise spend most of their time logging
+        DebugLogger::setEnabled(false);
+
+        const std::vector<Configuration> configurations = buildConfigurations(options);
+        const size_t jobCount = configurations.size() * options.runs;
+
+        int threadCount = options.threads > 0 ? options.threads :
+                          static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        threadCount = static_cast<int>(std::min<size_t>(threadCount, jobCount));
+
+        std::cout << "Running " << configurations.size() << " configuration(s) x " << options.runs
+                  << " runs of " << options.durationMs / 1000.0 << " s on " << threadCount
+                  << " thread(s)" << std::endl;
+
+        std::vector<RunResult> results(jobCount);
+        std::vector<std::string> laneNames;
+        std::mutex layoutMutex;
+        std::atomic<size_t> nextJob(0);
+        std::atomic<size_t> finishedJobs(0);
+        std::atomic<bool> failed(false);
+
+        auto start = std::chrono::steady_clock::now();
+
+        // Each worker keeps one manager and generator and reuses them for all its runs
+        auto worker = [&]() {
+            TrafficManager manager;
+            manager.setFileInputEnabled(false);
+            manager.setMovementModel(options.model);
+            if (!manager.initialize()) {
+                failed = true;
+                return;
+            }
+            manager.start();
+
+            ArrivalGenerator generator(options.arrivalIntervalMs, options.initialPriorityVehicles);
+
+            for (size_t job = nextJob++; job < jobCount && !failed; job = nextJob++) {
+                size_t config = job / options.runs;
+                uint32_t seed = options.baseSeed + static_cast<uint32_t>(job % options.runs);
+
+                results[job] = runSimulation(manager, generator, configurations[config], seed, options);
+
+                size_t done = ++finishedJobs;
+                if (done % std::max<size_t>(1, jobCount / 10) == 0) {
+                    std::cout << "  " << done << "/" << jobCount << " runs finished" << std::endl;
+                }
+            }
+
+            // Lane names and order are the same for every manager
+            std::lock_guard<std::mutex> lock(layoutMutex);
+            if (laneNames.empty()) {
+                for (auto* lane : manager.getLanes()) {
+                    laneNames.push_back(lane->getName());
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < threadCount; i++) {
+            workers.emplace_back(worker);
+        }
+        for (auto& thread : workers) {
+            thread.join();
+        }
+
+        if (failed) {
+            std::cerr << "Failed to initialize a simulation" << std::endl;
+            return 1;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double simulated = jobCount * (options.durationMs / 1000.0);
+        std::cout << "Finished in " << seconds << " s (" << simulated / std::max(seconds, 1e-9)
+                  << "x real time)" << std::endl;
+
+        if (!writeResults(options, configurations, results, laneNames)) {
+            return 1;
+        }
+
+        std::cout << "Results written to " << options.outputPath << std::endl;
+        return 0;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -96,7 +96,8 @@ void write_vehicle(const std::string& id, char lane, int laneNumber, Direction d
     std::ofstream file(filepath, std::ios::app);
 
     if (file.is_open()) {
-        // Format: vehicleId_L{laneNumber}:lane
+        // Format: vehicleId_L{laneNumber}_DIRECTION:lane@epoch_ms (generation time,
+        // so the simulator can measure its ingest lag)
         file << id << "_L" << laneNumber;
 
         // Add direction info based on lane and specific rules
@@ -112,7 +113,9 @@ void write_vehicle(const std::string& id, char lane, int laneNumber, Direction d
             }
         }
 
-        file << ":" << lane << std::endl;
+        const long long generatedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        file << ":" << lane << "@" << generatedMs << std::endl;
         file.close();
 
         // Format log message with colors based on lane type
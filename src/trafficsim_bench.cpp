@@ -0,0 +1,564 @@
+// FILE: src/trafficsim_bench.cpp
+// Microbenchmarks of the simulator's hot building blocks: the lane queues,
+// lane file parsing, vehicle movement, logging and the signal controllers.
+// Every benchmark runs at each requested size and the results are written as
+// JSON, so two runs (before/after a change, two machines) can be diffed.
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <algorithm>
+#include <thread>
+
+#include "managers/TrafficManager.h"
+#include "managers/FileHandler.h"
+#include "core/Vehicle.h"
+#include "core/TrafficLight.h"
+#include "core/SignalController.h"
+#include "utils/Queue.h"
+#include "utils/PriorityQueue.h"
+#include "utils/DebugLogger.h"
+#include "utils/Statistics.h"
+
+struct BenchOptions {
+    std::string filter;                 // Run only benchmarks whose "name/size" contains this
+    std::string outputPath;             // JSON results file (stdout when empty)
+    std::vector<size_t> sizes = {16, 256, 4096};
+    double minTimeMs = 100.0;           // Minimum duration of one repetition
+    int repetitions = 5;
+    bool list = false;
+};
+
+// One benchmark instance, set up for a size. run(n) performs n iterations of
+// `items` operations each; setup and teardown live outside run().
+struct BenchBody {
+    std::function<void(uint64_t)> run;
+    uint64_t items = 1;
+};
+
+struct Benchmark {
+    std::string name;
+    const char* unit;                   // What the size means
+    std::function<BenchBody(size_t)> make;
+};
+
+struct BenchResult {
+    std::string name;
+    size_t size = 0;
+    uint64_t items = 0;
+    uint64_t iterations = 0;            // Per repetition
+    std::vector<double> nsPerItem;      // One per repetition
+};
+
+namespace {
+    // Results are folded into this so the compiler cannot drop the work
+    volatile uint64_t sink = 0;
+
+    using BenchClock = std::chrono::steady_clock;
+
+    double elapsedNs(BenchClock::time_point start) {
+        return std::chrono::duration<double, std::nano>(BenchClock::now() - start).count();
+    }
+
+    // Swallows the console copy of every DebugLogger message
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    // Lane file lines as the generator writes them, over every road and lane
+    std::string vehicleLine(size_t index) {
+        static const char roads[] = {'A', 'B', 'C', 'D'};
+        static const char* const suffixes[] = {"_L2", "_L2_LEFT", "_L2_STRAIGHT", "_L3_LEFT", "_L2_E"};
+        std::ostringstream line;
+        line << "V" << index << suffixes[index % 5] << ":" << roads[(index / 5) % 4]
+             << "@" << (1760000000000LL + static_cast<int64_t>(index));
+        return line.str();
+    }
+
+    // Vehicles spread over the controlled and free lanes of every road
+    std::vector<Vehicle*> makeVehicles(size_t count) {
+        static const char roads[] = {'A', 'B', 'C', 'D'};
+        std::vector<Vehicle*> vehicles;
+        vehicles.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            Vehicle* vehicle = new Vehicle("V" + std::to_string(i), roads[i % 4], (i / 4) % 2 == 0 ? 2 : 3);
+            if (vehicle->getLaneNumber() == 3) {
+                vehicle->setDestination(Destination::LEFT);
+            }
+            vehicle->initializeWaypoints();
+            vehicles.push_back(vehicle);
+        }
+        return vehicles;
+    }
+
+    void deleteVehicles(std::vector<Vehicle*>& vehicles) {
+        for (Vehicle* vehicle : vehicles) {
+            delete vehicle;
+        }
+        vehicles.clear();
+    }
+
+    // Owns the vehicles a queue benchmark stores pointers to
+    struct VehicleSet {
+        std::vector<Vehicle*> vehicles;
+        explicit VehicleSet(size_t count) : vehicles(makeVehicles(count)) {}
+        ~VehicleSet() { deleteVehicles(vehicles); }
+    };
+
+    BenchBody queueFillDrain(size_t size) {
+        auto set = std::make_shared<VehicleSet>(size);
+        auto queue = std::make_shared<Queue<Vehicle*>>();
+        BenchBody body;
+        body.items = size;
+        body.run = [set, queue](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                for (Vehicle* vehicle : set->vehicles) {
+                    queue->enqueue(vehicle);
+                }
+                while (!queue->isEmpty()) {
+                    sink = sink + reinterpret_cast<uintptr_t>(queue->dequeue());
+                }
+            }
+        };
+        return body;
+    }
+
+    BenchBody priorityQueueFillDrain(size_t size) {
+        auto set = std::make_shared<VehicleSet>(size);
+        auto queue = std::make_shared<PriorityQueue<Vehicle*>>();
+        BenchBody body;
+        body.items = size;
+        body.run = [set, queue](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                for (size_t i = 0; i < set->vehicles.size(); i++) {
+                    queue->enqueue(set->vehicles[i], static_cast<int>(i % 7));
+                }
+                while (!queue->isEmpty()) {
+                    sink = sink + reinterpret_cast<uintptr_t>(queue->dequeue());
+                }
+            }
+        };
+        return body;
+    }
+
+    BenchBody priorityQueueUpdate(size_t size) {
+        auto set = std::make_shared<VehicleSet>(size);
+        auto queue = std::make_shared<PriorityQueue<Vehicle*>>();
+        for (size_t i = 0; i < size; i++) {
+            queue->enqueue(set->vehicles[i], static_cast<int>(i % 7));
+        }
+        BenchBody body;
+        body.items = 1;
+        body.run = [set, queue](uint64_t iterations) {
+            const auto same = [](Vehicle* const& a, Vehicle* const& b) { return a == b; };
+            const size_t count = set->vehicles.size();
+            for (uint64_t n = 0; n < iterations; n++) {
+                // Walk the queue with a stride so the target is not always at the front
+                Vehicle* target = set->vehicles[(n * 7919) % count];
+                sink = sink + queue->updatePriority(target, static_cast<int>(n % 11), same);
+            }
+        };
+        return body;
+    }
+
+    BenchBody parseVehicleLine(size_t size) {
+        auto lines = std::make_shared<std::vector<std::string>>();
+        for (size_t i = 0; i < size; i++) {
+            lines->push_back(vehicleLine(i));
+        }
+        auto handler = std::make_shared<FileHandler>();
+        BenchBody body;
+        body.items = size;
+        body.run = [lines, handler](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                for (const std::string& line : *lines) {
+                    Vehicle* vehicle = handler->parseVehicleLine(line);
+                    sink = sink + static_cast<uint64_t>(vehicle != nullptr);
+                    delete vehicle;
+                }
+            }
+        };
+        return body;
+    }
+
+    BenchBody vehicleInitializeWaypoints(size_t size) {
+        auto set = std::make_shared<VehicleSet>(size);
+        BenchBody body;
+        body.items = size;
+        body.run = [set](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                for (Vehicle* vehicle : set->vehicles) {
+                    vehicle->initializeWaypoints();
+                    sink = sink + vehicle->getWaypoints().size();
+                }
+            }
+        };
+        return body;
+    }
+
+    BenchBody vehicleUpdate(size_t size) {
+        auto set = std::make_shared<VehicleSet>(size);
+        BenchBody body;
+        body.items = size;
+        body.run = [set](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                for (Vehicle*& vehicle : set->vehicles) {
+                    vehicle->update(16, true, 0.0f);
+                    if (vehicle->hasExited()) {
+                        // Start over from the spawn point (rare: a path takes thousands of steps)
+                        Vehicle* fresh = new Vehicle(vehicle->getId(), vehicle->getLane(), vehicle->getLaneNumber());
+                        fresh->setDestination(vehicle->getDestination());
+                        fresh->initializeWaypoints();
+                        delete vehicle;
+                        vehicle = fresh;
+                    }
+                }
+                sink = sink + static_cast<uint64_t>(set->vehicles.front()->getPathDistance());
+            }
+        };
+        return body;
+    }
+
+    // Logging on: the message goes to the recent-log ring, the log file and
+    // the console (discarded here). The size is the message length.
+    BenchBody debugLoggerLog(size_t size) {
+        struct LoggerState {
+            std::string path;
+            NullBuffer null;
+            std::streambuf* console;
+
+            LoggerState() : path("trafficsim_bench.log") {
+                DebugLogger::initialize(path);
+                DebugLogger::setEnabled(true);
+                console = std::cout.rdbuf(&null);
+            }
+
+            ~LoggerState() {
+                std::cout.rdbuf(console);
+                DebugLogger::setEnabled(false);
+                DebugLogger::shutdown();
+                DebugLogger::clearLogs();
+                std::remove(path.c_str());
+            }
+        };
+
+        auto state = std::make_shared<LoggerState>();
+        auto message = std::make_shared<std::string>(size, 'x');
+        BenchBody body;
+        body.items = 1;
+        body.run = [state, message](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                DebugLogger::log(*message, DebugLogger::LogLevel::INFO);
+            }
+        };
+        return body;
+    }
+
+    // Logging off, as in the headless tools: the cost every log call site still pays
+    BenchBody debugLoggerLogDisabled(size_t size) {
+        auto message = std::make_shared<std::string>(size, 'x');
+        BenchBody body;
+        body.items = 1;
+        body.run = [message](uint64_t iterations) {
+            for (uint64_t n = 0; n < iterations; n++) {
+                DebugLogger::log(*message, DebugLogger::LogLevel::INFO);
+            }
+        };
+        return body;
+    }
+
+    // One controller decision over lanes holding `size` injected vehicles.
+    // injectVehicle queues every vehicle (lanes have no capacity limit), so
+    // the load grows with the size; the check below keeps it that way.
+    BenchBody trafficLightUpdate(SignalControllerType controller, size_t size) {
+        auto manager = std::make_shared<TrafficManager>();
+        manager->setFileInputEnabled(false);
+        manager->setSignalController(controller);
+        if (!manager->initialize()) {
+            throw std::runtime_error("Traffic manager initialization failed");
+        }
+        manager->start();
+        for (size_t i = 0; i < size; i++) {
+            manager->injectVehicle(vehicleLine(i));
+        }
+        manager->update(16);
+
+        size_t queued = 0;
+        for (const Lane* lane : manager->getLanes()) {
+            queued += static_cast<size_t>(lane->getVehicleCount());
+        }
+        if (queued != size) {
+            throw std::runtime_error("Lanes hold " + std::to_string(queued) + " of " + std::to_string(size) +
+                                     " injected vehicles");
+        }
+
+        auto clock = std::make_shared<uint32_t>(manager->getSimulationTime());
+        BenchBody body;
+        body.items = 1;
+        body.run = [manager, clock](uint64_t iterations) {
+            TrafficLight* light = manager->getTrafficLight();
+            const std::vector<Lane*>& lanes = manager->getLanes();
+            for (uint64_t n = 0; n < iterations; n++) {
+                *clock += 16;
+                light->update(lanes, manager->getCounters(), manager->getRates(), *clock);
+            }
+            sink = sink + static_cast<uint64_t>(light->getCurrentState());
+        };
+        return body;
+    }
+
+    std::vector<Benchmark> allBenchmarks() {
+        std::vector<Benchmark> benchmarks = {
+            {"queue_fill_drain", "vehicles", queueFillDrain},
+            {"priority_queue_fill_drain", "vehicles", priorityQueueFillDrain},
+            {"priority_queue_update", "vehicles", priorityQueueUpdate},
+            {"parse_vehicle_line", "lines", parseVehicleLine},
+            {"vehicle_initialize_waypoints", "vehicles", vehicleInitializeWaypoints},
+            {"vehicle_update", "vehicles", vehicleUpdate},
+            {"debug_logger_log", "message bytes", debugLoggerLog},
+            {"debug_logger_log_disabled", "message bytes", debugLoggerLogDisabled},
+        };
+
+        // Every controller; qlearning without a loaded table decides like fixed time
+        for (int type = static_cast<int>(SignalControllerType::FIXED_TIME);
+             type <= static_cast<int>(SignalControllerType::QLEARNING); type++) {
+            const SignalControllerType controller = static_cast<SignalControllerType>(type);
+            benchmarks.push_back({std::string("traffic_light_update/") + signalControllerName(controller), "vehicles",
+                                  [controller](size_t size) { return trafficLightUpdate(controller, size); }});
+        }
+        return benchmarks;
+    }
+
+    // Iterations that make one repetition last at least minTimeMs; the
+    // calibration runs double as the warm-up
+    uint64_t calibrate(const BenchBody& body, double minTimeMs) {
+        const double targetNs = minTimeMs * 1e6;
+        uint64_t iterations = 1;
+        while (true) {
+            const BenchClock::time_point start = BenchClock::now();
+            body.run(iterations);
+            const double ns = elapsedNs(start);
+            if (ns >= targetNs) {
+                return iterations;
+            }
+            const double scale = ns > 0.0 ? std::min(100.0, targetNs * 1.2 / ns) : 100.0;
+            iterations = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * scale));
+        }
+    }
+
+    std::string jsonEscape(const std::string& text) {
+        std::string escaped;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += ' ';
+            } else {
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    std::string compilerName() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    std::string isoTimestamp() {
+        const std::time_t now = std::time(nullptr);
+        char text[32];
+        std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+        return text;
+    }
+}
+
+void printUsage() {
+    std::cout <<
+        "Usage: trafficsim_bench [options]\n"
+        "  --filter TEXT      run only benchmarks whose name/size contains TEXT\n"
+        "  --sizes LIST       comma-separated sizes (default 16,256,4096)\n"
+        "  --min-time MS      minimum duration of one repetition (default 100)\n"
+        "  --repetitions N    timed repetitions per benchmark (default 5)\n"
+        "  --out FILE         write the JSON results to FILE instead of stdout\n"
+        "  --list             list the benchmarks and exit\n";
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+        if (arg == "--list") {
+            options.list = true;
+            continue;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+
+        if (arg == "--filter") options.filter = value;
+        else if (arg == "--out") options.outputPath = value;
+        else if (arg == "--min-time") options.minTimeMs = std::stod(value);
+        else if (arg == "--repetitions") options.repetitions = std::stoi(value);
+        else if (arg == "--sizes") {
+            options.sizes.clear();
+            std::stringstream ss(value);
+            std::string item;
+            while (std::getline(ss, item, ',')) {
+                options.sizes.push_back(static_cast<size_t>(std::stoul(item)));
+            }
+        }
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            printUsage();
+            return false;
+        }
+    }
+
+    if (options.sizes.empty() || options.repetitions < 1 || options.minTimeMs <= 0.0 ||
+        std::find(options.sizes.begin(), options.sizes.end(), 0u) != options.sizes.end()) {
+        std::cerr << "Invalid options" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+BenchResult runBenchmark(const Benchmark& benchmark, size_t size, const BenchOptions& options) {
+    BenchResult result;
+    result.name = benchmark.name;
+    result.size = size;
+
+    const BenchBody body = benchmark.make(size);
+    result.items = body.items;
+    result.iterations = calibrate(body, options.minTimeMs);
+
+    for (int rep = 0; rep < options.repetitions; rep++) {
+        const BenchClock::time_point start = BenchClock::now();
+        body.run(result.iterations);
+        const double ns = elapsedNs(start);
+        result.nsPerItem.push_back(ns / static_cast<double>(result.iterations * result.items));
+    }
+    return result;
+}
+
+std::string formatJson(const std::vector<BenchResult>& results, const BenchOptions& options) {
+    std::ostringstream out;
+    out << std::setprecision(6);
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << isoTimestamp() << "\",\n";
+    out << "    \"compiler\": \"" << jsonEscape(compilerName()) << "\",\n";
+#ifdef NDEBUG
+    out << "    \"build\": \"release\",\n";
+#else
+    out << "    \"build\": \"debug\",\n";
+#endif
+#ifdef ENABLE_PROFILER
+    out << "    \"profiler\": true,\n";
+#else
+    out << "    \"profiler\": false,\n";
+#endif
+    out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "    \"min_time_ms\": " << options.minTimeMs << ",\n";
+    out << "    \"repetitions\": " << options.repetitions << "\n";
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        std::vector<double> samples = result.nsPerItem;
+        const double median = Statistics::percentile(samples, 50.0);
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"name\": \"" << jsonEscape(result.name) << "\", \"size\": " << result.size
+            << ", \"items_per_iteration\": " << result.items
+            << ", \"iterations\": " << result.iterations
+            << ", \"ns_per_item\": {\"min\": " << *std::min_element(samples.begin(), samples.end())
+            << ", \"median\": " << median
+            << ", \"mean\": " << Statistics::mean(samples)
+            << ", \"max\": " << *std::max_element(samples.begin(), samples.end())
+            << "}, \"items_per_second\": " << (median > 0.0 ? 1e9 / median : 0.0) << "}";
+    }
+    out << "\n  ]\n}\n";
+    return out.str();
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    try {
+        if (!parseOptions(argc, argv, options)) {
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Invalid option value: " << e.what() << std::endl;
+        return 1;
+    }
+
+    DebugLogger::setEnabled(false);
+
+    const std::vector<Benchmark> benchmarks = allBenchmarks();
+    if (options.list) {
+        for (const Benchmark& benchmark : benchmarks) {
+            std::cout << std::left << std::setw(36) << benchmark.name << " size = " << benchmark.unit << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<BenchResult> results;
+    try {
+        for (const Benchmark& benchmark : benchmarks) {
+            for (size_t size : options.sizes) {
+                const std::string label = benchmark.name + "/" + std::to_string(size);
+                if (!options.filter.empty() && label.find(options.filter) == std::string::npos) {
+                    continue;
+                }
+
+                results.push_back(runBenchmark(benchmark, size, options));
+                std::vector<double> samples = results.back().nsPerItem;
+                std::cerr << std::left << std::setw(40) << label << std::right << std::fixed << std::setprecision(1)
+                          << std::setw(12) << Statistics::percentile(samples, 50.0) << " ns/item" << std::endl;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        return 1;
+    }
+
+    const std::string json = formatJson(results, options);
+    if (options.outputPath.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream file(options.outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Could not write " << options.outputPath << std::endl;
+            return 1;
+        }
+        file << json;
+        std::cerr << "Results written to " << options.outputPath << std::endl;
+    }
+
+    return 0;
+}
@@ -1,4 +1,5 @@
 #include "utils/DebugLogger.h"
+#include "utils/Profiler.h"
 #include <iostream>
 #include <fstream>
 #include <chrono>
@@ -8,12 +9,13 @@
 
 // Static class members initialization
 std::string DebugLogger::logFilePath = "traffic_simulator.log";
-std::vector<std::string> DebugLogger::recentLogs;
-std::mutex DebugLogger::logMutex;
+DebugLogger::LogRing DebugLogger::recentLogs;
+InstrumentedMutex DebugLogger::logMutex("debug_logger");
 bool DebugLogger::initialized = false;
+std::atomic<bool> DebugLogger::enabled(true);
 
 void DebugLogger::initialize(const std::string& path) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::lock_guard<InstrumentedMutex> lock(logMutex);
     logFilePath = path;
 
     // Create/clear the log file
@@ -27,6 +29,11 @@ void DebugLogger::initialize(const std::string& path) {
 }
 
 void DebugLogger::log(const std::string& message, LogLevel level) {
+    if (!enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    PROFILE_ZONE(LOGGING);
+
     if (!initialized) {
         initialize(); // Initialize with default path if not done already
     }
@@ -45,9 +52,11 @@ void DebugLogger::log(const std::string& message, LogLevel level) {
 
     // Store in recent logs (limited to last 100)
     {
-        std::lock_guard<std::mutex> lock(logMutex);
+        std::lock_guard<InstrumentedMutex> lock(logMutex);
         recentLogs.push_back(formattedMessage);
+        MemoryAccounting::allocated(MemoryTag::LOG_BUFFER, MemoryAccounting::stringHeapBytes(recentLogs.back()));
         if (recentLogs.size() > 100) {
+            MemoryAccounting::released(MemoryTag::LOG_BUFFER, MemoryAccounting::stringHeapBytes(recentLogs.front()));
             recentLogs.erase(recentLogs.begin());
         }
     }
@@ -60,14 +69,14 @@ void DebugLogger::log(const std::string& message, LogLevel level) {
 }
 
 std::vector<std::string> DebugLogger::getRecentLogs(int count) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::lock_guard<InstrumentedMutex> lock(logMutex);
 
     if (count <= 0 || recentLogs.empty()) {
         return {};
     }
 
     if (count >= static_cast<int>(recentLogs.size())) {
-        return recentLogs;
+        return std::vector<std::string>(recentLogs.begin(), recentLogs.end());
     }
 
     // Return last 'count' logs
@@ -78,7 +87,10 @@ std::vector<std::string> DebugLogger::getRecentLogs(int count) {
 }
 
 void DebugLogger::clearLogs() {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::lock_guard<InstrumentedMutex> lock(logMutex);
+    for (const auto& message : recentLogs) {
+        MemoryAccounting::released(MemoryTag::LOG_BUFFER, MemoryAccounting::stringHeapBytes(message));
+    }
     recentLogs.clear();
 
     // Clear the log file
@@ -90,7 +102,7 @@ void DebugLogger::clearLogs() {
 }
 
 void DebugLogger::shutdown() {
-    std::lock_guard<std::mutex> lock(logMutex);
+    std::lock_guard<InstrumentedMutex> lock(logMutex);
 
     if (!initialized) {
         return;
@@ -100,6 +112,14 @@ void DebugLogger::shutdown() {
     initialized = false;
 }
 
+void DebugLogger::setEnabled(bool on) {
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+bool DebugLogger::isEnabled() {
+    return enabled.load(std::memory_order_relaxed);
+}
+
 std::string DebugLogger::getTimestamp() {
     auto now = std::chrono::system_clock::now();
     auto time = std::chrono::system_clock::to_time_t(now);
@@ -0,0 +1,67 @@
+// FILE: src/utils/InstrumentedMutex.cpp
+#include "utils/InstrumentedMutex.h"
+#include "utils/Profiler.h"
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    struct alignas(64) LockSlot {
+        const char* name = nullptr;
+        LockStats::Counters counters;
+    };
+
+    // Constant-initialized, so locks constructed during static initialization
+    // (DebugLogger's) can register
+    LockSlot slots[LockStats::MAX_LOCKS];
+    std::atomic<int> slotCount{0};
+    std::mutex registryMutex;
+}
+
+LockStats::Counters* LockStats::counters(const char* name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    const int count = slotCount.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        if (std::strcmp(slots[i].name, name) == 0) {
+            return &slots[i].counters;
+        }
+    }
+
+    if (count == MAX_LOCKS) {
+        return &slots[MAX_LOCKS - 1].counters;
+    }
+    slots[count].name = count == MAX_LOCKS - 1 ? "other" : name;
+    slotCount.store(count + 1, std::memory_order_release);
+    return &slots[count].counters;
+}
+
+std::vector<LockStats::LockInfo> LockStats::getAll() {
+    const double msPerTick = Profiler::nanosecondsPerTick() / 1e6;
+    const int count = slotCount.load(std::memory_order_acquire);
+
+    std::vector<LockInfo> locks(count);
+    for (int i = 0; i < count; i++) {
+        const Counters& c = slots[i].counters;
+        locks[i].name = slots[i].name;
+        locks[i].acquisitions = c.acquisitions.load(std::memory_order_relaxed);
+        locks[i].contended = c.contended.load(std::memory_order_relaxed);
+        locks[i].waitMs = c.waitTicks.load(std::memory_order_relaxed) * msPerTick;
+    }
+    return locks;
+}
+
+std::string LockStats::getReport() {
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(2);
+    for (const auto& info : getAll()) {
+        const double contendedPercent = info.acquisitions > 0 ? 100.0 * info.contended / info.acquisitions : 0.0;
+        const double avgWaitUs = info.contended > 0 ? info.waitMs * 1000.0 / info.contended : 0.0;
+        report << std::left << std::setw(15) << info.name << std::right
+               << " acquired " << std::setw(10) << info.acquisitions
+               << "  contended " << std::setw(8) << info.contended
+               << " (" << std::setw(5) << contendedPercent << "%)"
+               << "  wait " << std::setw(9) << info.waitMs << " ms"
+               << " (avg " << avgWaitUs << " us)\n";
+    }
+    return report.str();
+}
@@ -0,0 +1,81 @@
+// FILE: src/utils/MemoryAccounting.cpp
+#include "utils/MemoryAccounting.h"
+#include <atomic>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+    struct alignas(64) TagCounters {
+        std::atomic<uint64_t> liveBytes{0};
+        std::atomic<uint64_t> peakBytes{0};
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> allocatedBytes{0};
+    };
+
+    // Constant-initialized, so allocations made during static initialization are counted too
+    TagCounters counters[MemoryAccounting::TAG_COUNT];
+}
+
+const char* MemoryAccounting::tagName(MemoryTag tag) {
+    switch (tag) {
+        case MemoryTag::VEHICLES:    return "vehicles";
+        case MemoryTag::WAYPOINTS:   return "waypoints";
+        case MemoryTag::VEHICLE_IDS: return "vehicle_ids";
+        case MemoryTag::LOG_BUFFER:  return "log_buffer";
+        case MemoryTag::QUEUES:      return "queues";
+        default:                     return "?";
+    }
+}
+
+void MemoryAccounting::allocated(MemoryTag tag, size_t bytes) {
+    if (bytes == 0) {
+        return;
+    }
+    TagCounters& c = counters[static_cast<int>(tag)];
+    const uint64_t live = c.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    c.allocations.fetch_add(1, std::memory_order_relaxed);
+    c.allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+    uint64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void MemoryAccounting::released(MemoryTag tag, size_t bytes) {
+    counters[static_cast<int>(tag)].liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryAccounting::TagStats MemoryAccounting::getStats(MemoryTag tag) {
+    const TagCounters& c = counters[static_cast<int>(tag)];
+    TagStats stats;
+    stats.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+    stats.peakBytes = c.peakBytes.load(std::memory_order_relaxed);
+    stats.allocations = c.allocations.load(std::memory_order_relaxed);
+    stats.allocatedBytes = c.allocatedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+std::string MemoryAccounting::formatBytes(uint64_t bytes) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    if (bytes >= 1024 * 1024) {
+        out << bytes / (1024.0 * 1024.0) << " MB";
+    } else if (bytes >= 1024) {
+        out << bytes / 1024.0 << " KB";
+    } else {
+        out << bytes << " B";
+    }
+    return out.str();
+}
+
+std::string MemoryAccounting::getReport() {
+    std::ostringstream report;
+    for (int i = 0; i < TAG_COUNT; i++) {
+        const MemoryTag tag = static_cast<MemoryTag>(i);
+        const TagStats stats = getStats(tag);
+        report << std::left << std::setw(12) << tagName(tag) << std::right
+               << " live " << std::setw(9) << formatBytes(stats.liveBytes)
+               << "  peak " << std::setw(9) << formatBytes(stats.peakBytes) << "\n";
+    }
+    return report.str();
+}
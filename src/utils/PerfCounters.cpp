@@ -0,0 +1,238 @@
+// FILE: src/utils/PerfCounters.cpp
+#include "utils/PerfCounters.h"
+#include "utils/Profiler.h"
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static_assert(Profiler::STAGE_COUNT <= PerfCounters::MAX_STAGES, "PerfCounters::MAX_STAGES is too small");
+
+std::atomic<bool> PerfCounters::enabled(false);
+
+namespace {
+    struct alignas(64) StageCounters {
+        std::atomic<uint64_t> samples{0};
+        std::atomic<uint64_t> values[PerfCounters::EVENT_COUNT];
+    };
+
+    // Zero-initialized with the rest of static storage
+    StageCounters stageCounters[PerfCounters::MAX_STAGES];
+
+#ifdef __linux__
+    const uint64_t EVENT_CONFIGS[PerfCounters::EVENT_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    int openEvent(uint64_t config, int groupFd) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.exclude_kernel = 1;    // User space only: allowed at perf_event_paranoid 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        // Calling thread, any CPU; counting starts right away
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+    }
+
+    // The counter group of one thread, opened on its first use and closed
+    // when the thread exits. All four events are scheduled together, so the
+    // ratios between them come from the same instructions.
+    struct ThreadGroup {
+        int fds[PerfCounters::EVENT_COUNT] = {-1, -1, -1, -1};
+        bool attempted = false;
+        int error = 0;      // errno of the failed open
+
+        ~ThreadGroup() {
+            close();
+        }
+
+        bool open() {
+            if (attempted) {
+                return fds[0] >= 0;
+            }
+            attempted = true;
+
+            for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+                fds[i] = openEvent(EVENT_CONFIGS[i], i == 0 ? -1 : fds[0]);
+                if (fds[i] < 0) {
+                    error = errno;
+                    close();
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void close() {
+            for (int& fd : fds) {
+                if (fd >= 0) {
+                    ::close(fd);
+                    fd = -1;
+                }
+            }
+        }
+    };
+
+    ThreadGroup& threadGroup() {
+        thread_local ThreadGroup group;
+        return group;
+    }
+
+    std::string describeError(int error) {
+        if (error == EACCES || error == EPERM) {
+            std::string level = "?";
+            std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+            file >> level;
+            return "perf events not permitted (kernel.perf_event_paranoid is " + level +
+                   "; user-space counting needs 2 or lower, or CAP_PERFMON)";
+        }
+        if (error == ENOENT || error == EOPNOTSUPP || error == ENODEV) {
+            return "no hardware counters available (virtual machine or unsupported CPU)";
+        }
+        return std::string("perf_event_open failed: ") + std::strerror(error);
+    }
+#endif
+}
+
+bool PerfCounters::enable(std::string& error) {
+#ifdef __linux__
+    ThreadGroup& group = threadGroup();
+    if (!group.open()) {
+        error = describeError(group.error);
+        return false;
+    }
+    enabled.store(true, std::memory_order_relaxed);
+    return true;
+#else
+    error = "hardware counters need Linux perf events";
+    return false;
+#endif
+}
+
+void PerfCounters::disable() {
+    enabled.store(false, std::memory_order_relaxed);
+}
+
+const char* PerfCounters::eventName(Event event) {
+    switch (event) {
+        case Event::CYCLES:        return "cycles";
+        case Event::INSTRUCTIONS:  return "instructions";
+        case Event::CACHE_MISSES:  return "cache-misses";
+        case Event::BRANCH_MISSES: return "branch-misses";
+        default:                   return "?";
+    }
+}
+
+bool PerfCounters::read(Sample& sample) {
+#ifdef __linux__
+    ThreadGroup& group = threadGroup();
+    if (!group.open()) {
+        return false;
+    }
+
+    // PERF_FORMAT_GROUP layout: event count, the two times, then the values
+    struct {
+        uint64_t count;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+        uint64_t values[EVENT_COUNT];
+    } data;
+    if (::read(group.fds[0], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data.count != EVENT_COUNT) {
+        return false;
+    }
+
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        sample.values[i] = data.values[i];
+    }
+    sample.timeEnabled = data.timeEnabled;
+    sample.timeRunning = data.timeRunning;
+    return true;
+#else
+    (void)sample;
+    return false;
+#endif
+}
+
+void PerfCounters::record(int stage, const Sample& start, const Sample& end) {
+    const uint64_t running = end.timeRunning - start.timeRunning;
+    if (stage < 0 || stage >= MAX_STAGES || running == 0) {
+        return;     // The group was not on the PMU in between
+    }
+
+    // Scale up the counts of a group that was multiplexed part of the time
+    const double scale = static_cast<double>(end.timeEnabled - start.timeEnabled) / running;
+    StageCounters& counters = stageCounters[stage];
+    counters.samples.fetch_add(1, std::memory_order_relaxed);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        const uint64_t delta = static_cast<uint64_t>((end.values[i] - start.values[i]) * scale + 0.5);
+        counters.values[i].fetch_add(delta, std::memory_order_relaxed);
+    }
+}
+
+PerfCounters::StageTotals PerfCounters::getTotals(int stage) {
+    StageTotals totals;
+    if (stage < 0 || stage >= MAX_STAGES) {
+        return totals;
+    }
+    const StageCounters& counters = stageCounters[stage];
+    totals.samples = counters.samples.load(std::memory_order_relaxed);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        totals.values[i] = counters.values[i].load(std::memory_order_relaxed);
+    }
+    return totals;
+}
+
+std::string PerfCounters::getReport() {
+    const int cycles = static_cast<int>(Event::CYCLES);
+    const int instructions = static_cast<int>(Event::INSTRUCTIONS);
+    const int cacheMisses = static_cast<int>(Event::CACHE_MISSES);
+    const int branchMisses = static_cast<int>(Event::BRANCH_MISSES);
+
+    std::ostringstream report;
+    report << std::left << std::setw(14) << "stage" << std::right
+           << std::setw(10) << "calls" << std::setw(12) << "cyc/call" << std::setw(12) << "instr/call"
+           << std::setw(7) << "IPC" << std::setw(12) << "cache MPKI" << std::setw(13) << "branch MPKI" << "\n";
+
+    report << std::fixed;
+    for (int i = 0; i < Profiler::STAGE_COUNT; i++) {
+        const StageTotals totals = getTotals(i);
+        if (totals.samples == 0) {
+            continue;
+        }
+        const double calls = static_cast<double>(totals.samples);
+        const double instr = static_cast<double>(totals.values[instructions]);
+        const double kiloInstr = instr / 1000.0;
+        report << std::left << std::setw(14) << Profiler::stageName(static_cast<Profiler::Stage>(i)) << std::right
+               << std::setw(10) << totals.samples
+               << std::setprecision(0)
+               << std::setw(12) << totals.values[cycles] / calls
+               << std::setw(12) << instr / calls
+               << std::setprecision(2)
+               << std::setw(7) << (totals.values[cycles] > 0 ? instr / totals.values[cycles] : 0.0)
+               << std::setw(12) << (kiloInstr > 0 ? totals.values[cacheMisses] / kiloInstr : 0.0)
+               << std::setw(13) << (kiloInstr > 0 ? totals.values[branchMisses] / kiloInstr : 0.0) << "\n";
+    }
+    return report.str();
+}
+
+void PerfCounters::clear() {
+    for (auto& counters : stageCounters) {
+        counters.samples.store(0, std::memory_order_relaxed);
+        for (auto& value : counters.values) {
+            value.store(0, std::memory_order_relaxed);
+        }
+    }
+}
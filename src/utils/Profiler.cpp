@@ -0,0 +1,125 @@
+// FILE: src/utils/Profiler.cpp
+#include "utils/Profiler.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+namespace {
+    // Both clocks at start-up; the tick rate is measured from here
+    struct ClockOrigin {
+        uint64_t ticks = Profiler::ticks();
+        std::chrono::steady_clock::time_point time = std::chrono::steady_clock::now();
+    };
+    const ClockOrigin origin;
+}
+
+double Profiler::nanosecondsPerTick() {
+#ifdef PROFILER_HAS_TSC
+    // Assumes an invariant TSC (every x86 CPU of the last decade); give the
+    // measurement at least 10 ms so the clock reads themselves don't matter
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    while (now - origin.time < std::chrono::milliseconds(10)) {
+        now = std::chrono::steady_clock::now();
+    }
+    const uint64_t elapsedTicks = ticks() - origin.ticks;
+    const double elapsedNs = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - origin.time).count());
+    return elapsedTicks > 0 ? elapsedNs / static_cast<double>(elapsedTicks) : 1.0;
+#else
+    return 1.0;
+#endif
+}
+
+uint64_t Profiler::originTicks() {
+    return origin.ticks;
+}
+
+Profiler& Profiler::local() {
+    thread_local Profiler profiler;
+    return profiler;
+}
+
+const char* Profiler::stageName(Stage stage) {
+    switch (stage) {
+        case Stage::SIM_UPDATE:        return "update";
+        case Stage::READ_VEHICLES:     return "readVehicles";
+        case Stage::UPDATE_PRIORITIES: return "priorities";
+        case Stage::PROCESS_VEHICLES:  return "processVeh";
+        case Stage::TRAFFIC_LIGHT:     return "light";
+        case Stage::LOGGING:           return "logging";
+        case Stage::DRAW_ROADS:        return "drawRoads";
+        case Stage::DRAW_VEHICLES:     return "drawVeh";
+        case Stage::DRAW_OVERLAY:      return "drawOverlay";
+        case Stage::PRESENT:           return "present";
+        case Stage::FRAME:             return "frame";
+        default:                       return "?";
+    }
+}
+
+const char* Profiler::stageCategory(Stage stage) {
+    switch (stage) {
+        case Stage::LOGGING:
+            return "logging";
+        case Stage::DRAW_ROADS:
+        case Stage::DRAW_VEHICLES:
+        case Stage::DRAW_OVERLAY:
+        case Stage::PRESENT:
+        case Stage::FRAME:
+            return "render";
+        default:
+            return "simulation";
+    }
+}
+
+Profiler::StageStats Profiler::getStats(Stage stage) const {
+    StageStats stats;
+    const Ring& ring = rings[static_cast<int>(stage)];
+    if (ring.count == 0) {
+        return stats;
+    }
+
+    std::vector<uint32_t> samples(ring.samples, ring.samples + ring.count);
+    uint64_t total = 0;
+    for (uint32_t sample : samples) {
+        total += sample;
+    }
+
+    // Nearest-rank p99 of the ring
+    const size_t rank = std::min(samples.size() - 1, (samples.size() * 99 + 99) / 100 - 1);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+
+    const double usPerTick = nanosecondsPerTick() / 1000.0;
+    stats.samples = static_cast<uint32_t>(ring.count);
+    stats.minUs = *std::min_element(samples.begin(), samples.end()) * usPerTick;
+    stats.maxUs = *std::max_element(samples.begin(), samples.end()) * usPerTick;
+    stats.avgUs = static_cast<double>(total) / ring.count * usPerTick;
+    stats.p99Us = samples[rank] * usPerTick;
+    return stats;
+}
+
+std::string Profiler::getReport() const {
+    std::ostringstream report;
+    report << std::left << std::setw(12) << "stage (us)" << std::right
+           << std::setw(7) << "min" << std::setw(7) << "avg" << std::setw(7) << "max" << std::setw(7) << "p99" << "\n";
+    report << std::fixed << std::setprecision(1);
+
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const Stage stage = static_cast<Stage>(i);
+        const StageStats stats = getStats(stage);
+        if (stats.samples == 0) {
+            continue;
+        }
+        report << std::left << std::setw(12) << stageName(stage) << std::right
+               << std::setw(7) << stats.minUs << std::setw(7) << stats.avgUs
+               << std::setw(7) << stats.maxUs << std::setw(7) << stats.p99Us << "\n";
+    }
+    return report.str();
+}
+
+void Profiler::clear() {
+    for (auto& ring : rings) {
+        ring.next = 0;
+        ring.count = 0;
+    }
+}
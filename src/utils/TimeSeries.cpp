@@ -0,0 +1,236 @@
+// FILE: src/utils/TimeSeries.cpp
+#include "utils/TimeSeries.h"
+#include "utils/BinaryIO.h"
+#include <cstring>
+
+namespace {
+    const char MAGIC[8] = {'T', 'S', 'E', 'R', 'I', 'E', 'S', '1'};
+
+    // Limits that tell damaged data from a real file
+    const uint32_t MAX_COLUMNS = 4096;
+    const uint32_t MAX_COLUMN_BYTES = static_cast<uint32_t>(TimeSeriesRecorder::BLOCK_ROWS) * 10;
+
+    // Zigzag maps small negative deltas to small unsigned values
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    // LEB128: seven bits per byte, high bit set while more follow
+    void putVarint(std::string& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    bool getVarint(const std::string& in, size_t& pos, uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+            const uint8_t byte = static_cast<uint8_t>(in[pos++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+TimeSeriesRecorder::~TimeSeriesRecorder() {
+    close();
+}
+
+bool TimeSeriesRecorder::open(const std::string& seriesPath, const std::vector<std::string>& columns) {
+    if (isOpen()) {
+        close();
+    }
+    if (columns.empty() || columns.size() > MAX_COLUMNS) {
+        return false;
+    }
+
+    file.open(seriesPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    path = seriesPath;
+    columnNames = columns;
+    current = emptyBlock();
+    rowsWritten.store(0, std::memory_order_relaxed);
+
+    file.write(MAGIC, sizeof(MAGIC));
+    BinaryIO::write(file, static_cast<uint32_t>(columnNames.size()));
+    for (const auto& name : columnNames) {
+        BinaryIO::writeString(file, name);
+    }
+    bytesWritten.store(static_cast<uint64_t>(file.tellp()), std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = false;
+    }
+    writer = std::thread(&TimeSeriesRecorder::writeLoop, this);
+    return true;
+}
+
+void TimeSeriesRecorder::close() {
+    if (!isOpen()) {
+        return;
+    }
+
+    if (current.rows > 0) {
+        submit();
+    }
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    file.close();
+}
+
+TimeSeriesRecorder::Block TimeSeriesRecorder::emptyBlock() const {
+    Block block;
+    block.columns.resize(columnNames.size());
+    for (auto& column : block.columns) {
+        column.reserve(BLOCK_ROWS);
+    }
+    return block;
+}
+
+void TimeSeriesRecorder::append(const int64_t* row) {
+    if (!isOpen()) {
+        return;
+    }
+
+    for (size_t i = 0; i < current.columns.size(); i++) {
+        current.columns[i].push_back(row[i]);
+    }
+    current.rows++;
+    if (current.rows >= BLOCK_ROWS) {
+        submit();
+    }
+}
+
+void TimeSeriesRecorder::submit() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        pending.push_back(std::move(current));
+    }
+    queueReady.notify_one();
+    current = emptyBlock();
+}
+
+void TimeSeriesRecorder::writeLoop() {
+    std::vector<Block> blocks;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty() && stopping) {
+                return;
+            }
+            blocks.swap(pending);
+        }
+
+        for (const auto& block : blocks) {
+            writeBlock(block);
+        }
+        blocks.clear();
+    }
+}
+
+void TimeSeriesRecorder::writeBlock(const Block& block) {
+    uint64_t bytes = sizeof(uint32_t);
+    BinaryIO::write(file, static_cast<uint32_t>(block.rows));
+
+    std::string encoded;
+    for (const auto& column : block.columns) {
+        encoded.clear();
+        int64_t previous = 0;
+        for (int64_t value : column) {
+            putVarint(encoded, zigzag(value - previous));
+            previous = value;
+        }
+        BinaryIO::write(file, static_cast<uint32_t>(encoded.size()));
+        file.write(encoded.data(), static_cast<std::streamsize>(encoded.size()));
+        bytes += sizeof(uint32_t) + encoded.size();
+    }
+    file.flush();
+
+    bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    rowsWritten.fetch_add(block.rows, std::memory_order_relaxed);
+}
+
+bool TimeSeriesReader::open(const std::string& path) {
+    file.open(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[sizeof(MAGIC)];
+    uint32_t count = 0;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !BinaryIO::read(file, count) || count == 0 || count > MAX_COLUMNS) {
+        error = true;
+        return false;
+    }
+
+    columns.resize(count);
+    for (auto& name : columns) {
+        if (!BinaryIO::readString(file, name, 256)) {
+            error = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TimeSeriesReader::readBlock(std::vector<std::vector<int64_t>>& values) {
+    uint32_t rows = 0;
+    if (!BinaryIO::read(file, rows)) {
+        return false;   // End of file
+    }
+    if (rows == 0 || rows > TimeSeriesRecorder::BLOCK_ROWS) {
+        error = true;
+        return false;
+    }
+
+    values.resize(columns.size());
+    std::string encoded;
+    for (auto& column : values) {
+        uint32_t size = 0;
+        if (!BinaryIO::read(file, size) || size > MAX_COLUMN_BYTES) {
+            error = true;
+            return false;
+        }
+        encoded.resize(size);
+        if (size > 0 && !file.read(&encoded[0], size)) {
+            error = true;
+            return false;
+        }
+
+        column.clear();
+        column.reserve(rows);
+        size_t pos = 0;
+        int64_t previous = 0;
+        for (uint32_t row = 0; row < rows; row++) {
+            uint64_t delta = 0;
+            if (!getVarint(encoded, pos, delta)) {
+                error = true;
+                return false;
+            }
+            previous += unzigzag(delta);
+            column.push_back(previous);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,231 @@
+// FILE: src/utils/TraceRecorder.cpp
+#include "utils/TraceRecorder.h"
+#include "utils/Profiler.h"
+#include <cinttypes>
+#include <cstdio>
+
+std::atomic<bool> TraceRecorder::recording(false);
+
+namespace {
+    std::atomic<uint32_t> nextThreadId(1);
+
+    // The calling thread's events; whatever is left goes to the writer when the thread ends
+    struct ThreadBuffer {
+        std::vector<TraceRecorder::Event> events;
+        uint32_t id;
+
+        ThreadBuffer() : id(nextThreadId.fetch_add(1, std::memory_order_relaxed)) {
+            events.reserve(TraceRecorder::BUFFER_EVENTS);
+        }
+
+        ~ThreadBuffer() {
+            TraceRecorder::flushThread();
+        }
+    };
+
+    ThreadBuffer& threadBuffer() {
+        thread_local ThreadBuffer buffer;
+        return buffer;
+    }
+
+    // Room kept for the closing "]}" so a full file is still valid JSON
+    const uint64_t CLOSING_BYTES = 8;
+}
+
+TraceRecorder& TraceRecorder::instance() {
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::~TraceRecorder() {
+    // Thread buffers may already be gone at exit (thread_local objects are
+    // destroyed before function-local statics), so only what was handed over
+    // is written
+    if (isOpen()) {
+        recording.store(false, std::memory_order_relaxed);
+        finish();
+    }
+}
+
+bool TraceRecorder::open(const std::string& tracePath, uint64_t byteLimit) {
+    if (isOpen()) {
+        close();
+    }
+
+    file.open(tracePath, std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    path = tracePath;
+    maxBytes = byteLimit;
+    full.store(false, std::memory_order_relaxed);
+    eventsWritten.store(0, std::memory_order_relaxed);
+
+    const std::string header =
+        "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Traffic Junction Simulator\"}}";
+    file << header;
+    bytesWritten.store(header.size(), std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = false;
+    }
+    writer = std::thread(&TraceRecorder::writeLoop, this);
+    return true;
+}
+
+void TraceRecorder::close() {
+    if (!isOpen()) {
+        return;
+    }
+
+    recording.store(false, std::memory_order_relaxed);
+    flushThread();
+    finish();
+}
+
+void TraceRecorder::finish() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueReady.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+
+    file << "\n]}\n";
+    file.close();
+}
+
+bool TraceRecorder::setRecording(bool on) {
+    if (on && (!isOpen() || isFull())) {
+        return false;
+    }
+
+    recording.store(on, std::memory_order_relaxed);
+    if (!on) {
+        flushThread();
+    }
+    return on;
+}
+
+void TraceRecorder::append(const Event& event) {
+    ThreadBuffer& buffer = threadBuffer();
+    buffer.events.push_back(event);
+    buffer.events.back().thread = buffer.id;
+    if (buffer.events.size() >= BUFFER_EVENTS) {
+        instance().submit(buffer.events);
+    }
+}
+
+void TraceRecorder::complete(const char* name, const char* category, uint64_t startTicks, uint64_t endTicks) {
+    if (!isRecording()) {
+        return;
+    }
+    append({name, category, 'X', 0, startTicks, endTicks - startTicks, 0});
+}
+
+void TraceRecorder::instant(const char* name, const char* category) {
+    if (!isRecording()) {
+        return;
+    }
+    append({name, category, 'i', 0, Profiler::ticks(), 0, 0});
+}
+
+void TraceRecorder::counter(const char* name, int64_t value) {
+    if (!isRecording()) {
+        return;
+    }
+    append({name, "counter", 'C', 0, Profiler::ticks(), 0, value});
+}
+
+void TraceRecorder::flushThread() {
+    ThreadBuffer& buffer = threadBuffer();
+    if (!buffer.events.empty()) {
+        instance().submit(buffer.events);
+    }
+}
+
+void TraceRecorder::submit(std::vector<Event>& events) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (!stopping) {
+            pending.push_back(std::move(events));
+        }
+    }
+    queueReady.notify_one();
+
+    events.clear();
+    events.reserve(BUFFER_EVENTS);
+}
+
+void TraceRecorder::writeLoop() {
+    std::vector<std::vector<Event>> batches;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueReady.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty() && stopping) {
+                return;
+            }
+            batches.swap(pending);
+        }
+
+        for (const auto& events : batches) {
+            writeEvents(events);
+        }
+        batches.clear();
+    }
+}
+
+void TraceRecorder::writeEvents(const std::vector<Event>& events) {
+    if (isFull()) {
+        return;
+    }
+
+    // Trace timestamps are microseconds since start-up
+    const double usPerTick = Profiler::nanosecondsPerTick() / 1000.0;
+    const uint64_t origin = Profiler::originTicks();
+
+    char line[320];
+    for (const Event& event : events) {
+        const double ts = static_cast<double>(event.start - origin) * usPerTick;
+        int length = 0;
+        switch (event.phase) {
+            case 'X':
+                length = std::snprintf(line, sizeof(line),
+                    ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%" PRIu32 "}",
+                    event.name, event.category, ts, event.duration * usPerTick, event.thread);
+                break;
+            case 'C':
+                length = std::snprintf(line, sizeof(line),
+                    ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%" PRIu32 ",\"args\":{\"%s\":%" PRId64 "}}",
+                    event.name, event.category, ts, event.thread, event.name, event.value);
+                break;
+            default:
+                length = std::snprintf(line, sizeof(line),
+                    ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%" PRIu32 "}",
+                    event.name, event.category, ts, event.thread);
+                break;
+        }
+        if (length <= 0 || length >= static_cast<int>(sizeof(line))) {
+            continue;
+        }
+
+        // Stop for good at the size limit
+        const uint64_t written = bytesWritten.load(std::memory_order_relaxed);
+        if (written + static_cast<uint64_t>(length) + CLOSING_BYTES > maxBytes) {
+            full.store(true, std::memory_order_relaxed);
+            recording.store(false, std::memory_order_relaxed);
+            return;
+        }
+
+        file.write(line, length);
+        bytesWritten.store(written + static_cast<uint64_t>(length), std::memory_order_relaxed);
+        eventsWritten.fetch_add(1, std::memory_order_relaxed);
+    }
+    file.flush();
+}
@@ -5,9 +5,13 @@
 #include "core/TrafficLight.h"
 #include "managers/TrafficManager.h"
 #include "utils/DebugLogger.h"
+#include "utils/InstrumentedMutex.h"
+#include "utils/Profiler.h"
+#include "utils/TraceRecorder.h"
 #include "core/Constants.h"
 
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
 #include <cmath>
 
@@ -20,9 +24,16 @@ Renderer::Renderer()
       showDebugOverlay(true),
       frameRateLimit(60),
       lastFrameTime(0),
+      timeWarp(1.0f),
+      pendingSimTime(0.0),
+      achievedWarp(0.0f),
+      warpSampleWallStart(0),
+      warpSampleSimStart(0),
       windowWidth(800),
       windowHeight(800),
-      trafficManager(nullptr) {}
+      trafficManager(nullptr),
+      allocationRate(),
+      memorySampleTime(0) {}
 
 Renderer::~Renderer() {
     cleanup();
@@ -33,7 +44,7 @@ bool Renderer::initialize(int width, int height, const std::string& title) {
     windowHeight = height;
 
     // Initialize SDL
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
         DebugLogger::log("Failed to initialize SDL: " + std::string(SDL_GetError()), DebugLogger::LogLevel::ERROR);
         return false;
     }
@@ -98,37 +109,81 @@ void Renderer::startRenderLoop() {
 
     DebugLogger::log("Starting render loop");
 
-    uint32_t lastUpdate = SDL_GetTicks();
-    const int updateInterval = 16; // ~60 FPS
+    uint64_t lastUpdate = SDL_GetTicks();
+    warpSampleWallStart = lastUpdate;
+    warpSampleSimStart = trafficManager->getSimulationTime();
 
     while (active) {
-        uint32_t currentTime = SDL_GetTicks();
-        uint32_t deltaTime = currentTime - lastUpdate;
+        uint64_t frameStart = SDL_GetTicksNS();
+        uint64_t currentTime = SDL_GetTicks();
+        uint32_t deltaTime = static_cast<uint32_t>(std::min<uint64_t>(currentTime - lastUpdate, Constants::MAX_FRAME_DELTA_MS));
+        lastUpdate = currentTime;
+        uint32_t targetFrameTime = frameRateLimit > 0 ? 1000 / frameRateLimit : Constants::SIM_STEP_MS;
+
+        {
+            PROFILE_ZONE(FRAME);
 
-        if (deltaTime >= updateInterval) {
             // Process events
             active = processEvents();
+            if (!active) {
+                break;
+            }
 
-            // Update traffic manager
-            trafficManager->update(deltaTime);
+            // Advance the model; leave a quarter of the frame for drawing
+            advanceSimulation(deltaTime, currentTime + targetFrameTime * 3 / 4);
+            measureTimeWarp(SDL_GetTicks());
 
-            // Render frame
+            // Render only the latest state, however many steps ran
             renderFrame();
-
-            lastUpdate = currentTime;
         }
+        trafficManager->recordFrameTime(static_cast<uint32_t>((SDL_GetTicksNS() - frameStart) / 1000));
 
         // Delay to maintain frame rate
-        uint32_t frameDuration = SDL_GetTicks() - currentTime;
-        if (frameRateLimit > 0) {
-            uint32_t targetFrameTime = 1000 / frameRateLimit;
-            if (frameDuration < targetFrameTime) {
-                SDL_Delay(targetFrameTime - frameDuration);
-            }
+        uint64_t frameDuration = SDL_GetTicks() - currentTime;
+        if (frameRateLimit > 0 && frameDuration < targetFrameTime) {
+            SDL_Delay(static_cast<uint32_t>(targetFrameTime - frameDuration));
         }
     }
 }
 
+void Renderer::advanceSimulation(uint32_t wallDelta, uint64_t deadline) {
+    const uint32_t step = Constants::SIM_STEP_MS;
+    const bool unlimited = timeWarp == Constants::TIME_WARP_UNLIMITED;
+
+    if (unlimited) {
+        pendingSimTime = 0.0;
+    } else {
+        pendingSimTime += wallDelta * static_cast<double>(timeWarp);
+    }
+
+    // Fixed steps keep the model identical at every warp factor
+    int steps = 0;
+    while (unlimited || pendingSimTime >= step) {
+        trafficManager->update(step);
+        pendingSimTime = std::max(0.0, pendingSimTime - step);
+        steps++;
+
+        // Checking the clock every step would cost more than a step at high warp
+        if ((steps & 7) == 0 && SDL_GetTicks() >= deadline) {
+            // Out of time: drop the backlog instead of falling further behind
+            pendingSimTime = 0.0;
+            break;
+        }
+    }
+}
+
+void Renderer::measureTimeWarp(uint64_t now) {
+    uint64_t wallElapsed = now - warpSampleWallStart;
+    if (wallElapsed < 500) {
+        return;
+    }
+
+    uint32_t simNow = trafficManager->getSimulationTime();
+    achievedWarp = static_cast<float>(simNow - warpSampleSimStart) / wallElapsed;
+    warpSampleWallStart = now;
+    warpSampleSimStart = simNow;
+}
+
 bool Renderer::processEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
@@ -144,10 +199,34 @@ bool Renderer::processEvents() {
                 if (scancode == SDL_SCANCODE_D) {
                     toggleDebugOverlay();
                 }
+                // T starts and stops trace recording
+                else if (scancode == SDL_SCANCODE_T) {
+                    toggleTraceRecording();
+                }
                 // Escape key scancode is usually 41 (for SDL_SCANCODE_ESCAPE)
                 else if (scancode == SDL_SCANCODE_ESCAPE) {
                     return false;
                 }
+                // Time warp presets: 1x, 10x, 100x, max
+                else if (scancode == SDL_SCANCODE_1) {
+                    setTimeWarp(1.0f);
+                } else if (scancode == SDL_SCANCODE_2) {
+                    setTimeWarp(10.0f);
+                } else if (scancode == SDL_SCANCODE_3) {
+                    setTimeWarp(100.0f);
+                } else if (scancode == SDL_SCANCODE_4) {
+                    setTimeWarp(Constants::TIME_WARP_UNLIMITED);
+                }
+                // +/- step the warp factor by 10x
+                else if (scancode == SDL_SCANCODE_EQUALS || scancode == SDL_SCANCODE_KP_PLUS) {
+                    if (timeWarp != Constants::TIME_WARP_UNLIMITED) {
+                        float faster = timeWarp * 10.0f;
+                        setTimeWarp(faster > Constants::TIME_WARP_MAX_FACTOR ? Constants::TIME_WARP_UNLIMITED : faster);
+                    }
+                } else if (scancode == SDL_SCANCODE_MINUS || scancode == SDL_SCANCODE_KP_MINUS) {
+                    setTimeWarp(timeWarp == Constants::TIME_WARP_UNLIMITED ?
+                                Constants::TIME_WARP_MAX_FACTOR : std::max(1.0f, timeWarp / 10.0f));
+                }
                 break;
             }
         }
@@ -166,24 +245,34 @@ void Renderer::renderFrame() {
     SDL_RenderClear(renderer);
 
     // Draw roads and lanes
-    drawRoadsAndLanes();
+    {
+        PROFILE_ZONE(DRAW_ROADS);
+        drawRoadsAndLanes();
+    }
 
     // Draw traffic lights
     drawTrafficLights();
 
     // Draw vehicles
-    drawVehicles();
+    {
+        PROFILE_ZONE(DRAW_VEHICLES);
+        drawVehicles();
+    }
 
     // Draw lane labels and direction indicators
     drawLaneLabels();
 
     // Draw debug overlay if enabled
     if (showDebugOverlay) {
+        PROFILE_ZONE(DRAW_OVERLAY);
         drawDebugOverlay();
     }
 
     // Present render
-    SDL_RenderPresent(renderer);
+    {
+        PROFILE_ZONE(PRESENT);
+        SDL_RenderPresent(renderer);
+    }
 
     // Update frame time
     lastFrameTime = SDL_GetTicks();
@@ -1173,7 +1262,7 @@ void Renderer::drawVehicles() {
             continue;
         }
 
-        const std::vector<Vehicle*>& vehicles = lane->getVehicles();
+        const Lane::VehicleList& vehicles = lane->getVehicles();
         int queuePos = 0;
 
         for (Vehicle* vehicle : vehicles) {
@@ -1189,7 +1278,7 @@ void Renderer::drawDebugOverlay() {
     // Draw semi-transparent background
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200); // More opaque background
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-    SDL_FRect overlayRect = {10, 10, 280, 180}; // Larger overlay
+    SDL_FRect overlayRect = {10, 10, 420, 570}; // Fits the statistics and recent logs
     SDL_RenderFillRect(renderer, &overlayRect);
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
@@ -1202,17 +1291,146 @@ void Renderer::drawDebugOverlay() {
 
     // Draw title
     drawText("Traffic Junction Simulator", 20, 20, {255, 255, 255, 255});
-    drawText("Press D to toggle debug overlay", 20, 40, {200, 200, 200, 255});
+    drawText("D: overlay  T: trace  1-4 / +/-: time warp", 20, 40, {200, 200, 200, 255});
+
+    // Time warp: requested factor and what the model actually achieves
+    std::ostringstream warp;
+    warp.setf(std::ios::fixed);
+    warp.precision(1);
+    warp << "Warp: ";
+    if (timeWarp == Constants::TIME_WARP_UNLIMITED) {
+        warp << "max";
+    } else {
+        warp << timeWarp << "x";
+    }
+    warp << " (achieved " << achievedWarp << "x)  t=" << trafficManager->getSimulationTime() / 1000 << "s";
+    drawText(warp.str(), 20, 60, {120, 200, 255, 255});
 
-    // Draw recent logs
+    // Draw recent logs below the statistics
     std::vector<std::string> logs = DebugLogger::getRecentLogs(5);
-    int y = 170;
+    int y = 460;
 
     for (const auto& log : logs) {
         std::string truncatedLog = log.length() > 50 ? log.substr(0, 47) + "..." : log;
         drawText(truncatedLog, 10, y, {200, 200, 200, 255});
         y += 20;
     }
+
+#ifdef ENABLE_PROFILER
+    drawProfiler();
+#endif
+#ifdef ENABLE_LOCK_STATS
+    drawLockStats(drawMemory() - 10);
+#else
+    drawMemory();
+#endif
+}
+
+void Renderer::drawProfiler() {
+    // Stage timings of this thread (the render loop also runs the model)
+    std::istringstream stream(Profiler::local().getReport());
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(stream, line)) {
+        lines.push_back(line);
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_FRect panelRect = {440, 10, 340, 20.0f + 20.0f * lines.size()};
+    SDL_RenderFillRect(renderer, &panelRect);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderRect(renderer, &panelRect);
+
+    int y = 20;
+    for (const auto& text : lines) {
+        drawText(text, 450, y, {180, 255, 180, 255});
+        y += 20;
+    }
+}
+
+float Renderer::drawMemory() {
+    const uint64_t now = SDL_GetTicks();
+    if (memorySampleTime == 0 || now - memorySampleTime >= 1000) {
+        for (int i = 0; i < MemoryAccounting::TAG_COUNT; i++) {
+            const MemoryAccounting::TagStats stats = MemoryAccounting::getStats(static_cast<MemoryTag>(i));
+            if (memorySampleTime > 0) {
+                allocationRate[i] = (stats.allocations - memorySample[i].allocations) * 1000.0 / (now - memorySampleTime);
+            }
+            memorySample[i] = stats;
+        }
+        memorySampleTime = now;
+    }
+
+    std::vector<std::string> lines;
+    std::ostringstream header;
+    header << std::left << std::setw(12) << "memory" << std::right << std::setw(10) << "live"
+           << std::setw(10) << "peak" << std::setw(9) << "alloc/s";
+    lines.push_back(header.str());
+
+    uint64_t totalLive = 0;
+    for (int i = 0; i < MemoryAccounting::TAG_COUNT; i++) {
+        const MemoryAccounting::TagStats& stats = memorySample[i];
+        totalLive += stats.liveBytes;
+        std::ostringstream line;
+        line << std::left << std::setw(12) << MemoryAccounting::tagName(static_cast<MemoryTag>(i)) << std::right
+             << std::setw(10) << MemoryAccounting::formatBytes(stats.liveBytes)
+             << std::setw(10) << MemoryAccounting::formatBytes(stats.peakBytes)
+             << std::setw(9) << static_cast<int64_t>(allocationRate[i] + 0.5);
+        lines.push_back(line.str());
+    }
+    lines.push_back("total live " + MemoryAccounting::formatBytes(totalLive));
+
+    const float height = 20.0f + 20.0f * lines.size();
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_FRect panelRect = {440, windowHeight - 10 - height, 340, height};
+    SDL_RenderFillRect(renderer, &panelRect);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderRect(renderer, &panelRect);
+
+    int y = static_cast<int>(panelRect.y) + 10;
+    for (const auto& text : lines) {
+        drawText(text, 450, y, {255, 220, 150, 255});
+        y += 20;
+    }
+    return panelRect.y;
+}
+
+void Renderer::drawLockStats(float bottom) {
+    std::vector<std::string> lines;
+    std::ostringstream header;
+    header << std::left << std::setw(15) << "lock" << std::right << std::setw(10) << "acquired"
+           << std::setw(7) << "cont%" << std::setw(9) << "wait ms";
+    lines.push_back(header.str());
+
+    for (const auto& info : LockStats::getAll()) {
+        const double contendedPercent = info.acquisitions > 0 ? 100.0 * info.contended / info.acquisitions : 0.0;
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(1)
+             << std::left << std::setw(15) << info.name << std::right
+             << std::setw(10) << info.acquisitions
+             << std::setw(7) << contendedPercent
+             << std::setw(9) << info.waitMs;
+        lines.push_back(line.str());
+    }
+
+    const float height = 20.0f + 20.0f * lines.size();
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_FRect panelRect = {440, bottom - height, 340, height};
+    SDL_RenderFillRect(renderer, &panelRect);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+    SDL_RenderRect(renderer, &panelRect);
+
+    int y = static_cast<int>(panelRect.y) + 10;
+    for (const auto& text : lines) {
+        drawText(text, 450, y, {200, 180, 255, 255});
+        y += 20;
+    }
 }
 
 void Renderer::drawStatistics() {
@@ -1226,7 +1444,7 @@ void Renderer::drawStatistics() {
     // Split into lines
     std::istringstream stream(stats);
     std::string line;
-    int y = 60;
+    int y = 80;
 
     while (std::getline(stream, line)) {
         // Check if line contains priority info
@@ -1268,6 +1486,10 @@ void Renderer::drawStatistics() {
                 stateText += "D Green (West)";
                 stateColor = {100, 255, 100, 255};
                 break;
+            case TrafficLight::State::PHASE:
+                stateText += ConflictMatrix::describe(trafficLight->getGreenMovements());
+                stateColor = {100, 255, 100, 255};
+                break;
         }
     }
 
@@ -1275,17 +1497,9 @@ void Renderer::drawStatistics() {
 }
 
 void Renderer::drawText(const std::string& text, int x, int y, SDL_Color color) {
-    // Since we don't have SDL_ttf configured, draw a colored rectangle
+    // SDL_ttf is not configured; SDL's built-in 8x8 debug font is enough for the overlay
     SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_FRect textRect = {static_cast<float>(x), static_cast<float>(y),
-                         static_cast<float>(8 * text.length()), 15};
-
-    // Draw colored rectangle representing text
-    SDL_RenderFillRect(renderer, &textRect);
-
-    // Draw text outline
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderRect(renderer, &textRect);
+    SDL_RenderDebugText(renderer, static_cast<float>(x), static_cast<float>(y), text.c_str());
 }
 
 void Renderer::drawArrow(int x1, int y1, int x2, int y2, int x3, int y3, SDL_Color color) {
@@ -1349,6 +1563,23 @@ bool Renderer::isActive() const {
     return active;
 }
 
+void Renderer::toggleTraceRecording() {
+    TraceRecorder& trace = TraceRecorder::instance();
+    if (!trace.isOpen() &&
+        !trace.open(Constants::TRACE_DEFAULT_PATH, Constants::TRACE_DEFAULT_LIMIT_MB * 1024ull * 1024ull)) {
+        DebugLogger::log("Could not open " + Constants::TRACE_DEFAULT_PATH, DebugLogger::LogLevel::ERROR);
+        return;
+    }
+
+    if (trace.toggleRecording()) {
+        DebugLogger::log("Trace recording to " + trace.getPath());
+    } else if (trace.isFull()) {
+        DebugLogger::log("Trace " + trace.getPath() + " reached its size limit", DebugLogger::LogLevel::WARNING);
+    } else {
+        DebugLogger::log("Trace recording paused");
+    }
+}
+
 void Renderer::toggleDebugOverlay() {
     showDebugOverlay = !showDebugOverlay;
     DebugLogger::log("Debug overlay " + std::string(showDebugOverlay ? "enabled" : "disabled"));
@@ -1358,6 +1589,24 @@ void Renderer::setFrameRateLimit(int fps) {
     frameRateLimit = fps;
 }
 
+void Renderer::setTimeWarp(float factor) {
+    timeWarp = std::max(0.0f, factor);
+    pendingSimTime = 0.0;
+
+    std::ostringstream oss;
+    oss << "Time warp set to ";
+    if (timeWarp == Constants::TIME_WARP_UNLIMITED) {
+        oss << "max";
+    } else {
+        oss << timeWarp << "x";
+    }
+    DebugLogger::log(oss.str());
+}
+
+float Renderer::getTimeWarp() const {
+    return timeWarp;
+}
+
 void Renderer::setTrafficManager(TrafficManager* manager) {
     trafficManager = manager;
 }